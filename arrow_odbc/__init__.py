@@ -1,5 +1,42 @@
+from .cache import clear_result_cache, set_result_cache_size
+from .connect import enable_odbc_connection_pooling
 from .error import Error
-from .reader import BatchReader, read_arrow_batches_from_odbc
-from .writer import insert_into_table
+from .incremental import read_arrow_batches_incremental
+from .prepared import PreparedQuery, prepare
+from .reader import (
+    BatchReader,
+    read_arrow_batches_from_odbc,
+    read_arrow_batches_from_odbc_partitioned,
+    range_partitions,
+)
+from .sink import odbc_to_arrow_ipc, odbc_to_parquet
+from .transfer import copy_table
+from .writer import (
+    insert_into_table,
+    insert_into_table_async,
+    execute_with_arrow_parameters,
+    parquet_to_odbc,
+    arrow_ipc_to_odbc,
+)
 
-__all__ = ["BatchReader", "read_arrow_batches_from_odbc", "Error", "insert_into_table"]
+__all__ = [
+    "BatchReader",
+    "read_arrow_batches_from_odbc",
+    "read_arrow_batches_from_odbc_partitioned",
+    "range_partitions",
+    "read_arrow_batches_incremental",
+    "PreparedQuery",
+    "prepare",
+    "Error",
+    "enable_odbc_connection_pooling",
+    "set_result_cache_size",
+    "clear_result_cache",
+    "insert_into_table",
+    "insert_into_table_async",
+    "execute_with_arrow_parameters",
+    "copy_table",
+    "odbc_to_parquet",
+    "odbc_to_arrow_ipc",
+    "parquet_to_odbc",
+    "arrow_ipc_to_odbc",
+]
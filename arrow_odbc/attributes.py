@@ -0,0 +1,49 @@
+from typing import Any, Dict, Mapping, Optional, Tuple, Union
+
+from ._native import ffi  # type: ignore
+
+# Integer valued statement attributes, which are commonly tuned for reading. Values are the ODBC
+# constants of the attributes, e.g. ``SQL_ATTR_MAX_LENGTH``.
+STATEMENT_ATTRIBUTES: Dict[str, int] = {
+    "query_timeout": 0,
+    "max_rows": 1,
+    "noscan": 2,
+    "max_length": 3,
+    "cursor_type": 6,
+    "concurrency": 7,
+    "keyset_size": 8,
+    "retrieve_data": 11,
+    "cursor_scrollable": -1,
+    "cursor_sensitivity": -2,
+}
+
+# Integer valued connection attributes, which can be set on an open connection.
+CONNECTION_ATTRIBUTES: Dict[str, int] = {
+    "access_mode": 101,
+    "autocommit": 102,
+    "txn_isolation": 108,
+    "connection_timeout": 113,
+}
+
+Attributes = Mapping[Union[str, int], int]
+
+
+def to_attribute_array(attributes: Optional[Attributes], names: Dict[str, int]) -> Tuple[Any, int]:
+    """
+    Converts attributes into an array of native attributes. Keys are either one of ``names``, or
+    the integer constant of the attribute, e.g. for attributes specific to a driver.
+
+    :return: Tuple of attribute array and its length.
+    """
+    if not attributes:
+        return (ffi.NULL, 0)
+
+    attribute_array = ffi.new("ArrowOdbcAttribute[]", len(attributes))
+    for index, (key, value) in enumerate(attributes.items()):
+        if isinstance(key, str):
+            if key not in names:
+                raise ValueError(f"Unknown attribute: {key}")
+            key = names[key]
+        attribute_array[index].attribute = key
+        attribute_array[index].value = value
+    return (attribute_array, len(attributes))
@@ -0,0 +1,35 @@
+from hashlib import sha256
+from typing import Any
+
+from ._native import lib  # type: ignore
+
+
+def set_result_cache_size(max_bytes: int):
+    """
+    Sets the upper bound for the memory held by result sets cached with the ``cache_ttl`` option
+    of ``read_arrow_batches_from_odbc``. The least recently used result sets are evicted to meet
+    it. Result sets larger than the bound are not cached at all. ``0`` disables caching. Default is
+    256 MiB.
+
+    :param max_bytes: Upper bound in bytes, for the memory held by all cached Arrow batches.
+    """
+    if max_bytes < 0:
+        raise ValueError("max_bytes must not be negative.")
+    lib.arrow_odbc_cache_set_max_bytes(max_bytes)
+
+
+def clear_result_cache():
+    """
+    Removes all result sets from the cache, e.g. after the underlying tables have changed.
+    """
+    lib.arrow_odbc_cache_clear()
+
+
+def cache_key(*components: Any) -> bytes:
+    """
+    Key of a result set in the cache. ``components`` are everything the batches depend on, e.g.
+    connection string, query and parameters. They are hashed, so credentials are not held in
+    memory as plain text. ``repr`` tells apart parameters of different types, like ``1`` and
+    ``"1"``.
+    """
+    return sha256(repr(components).encode("utf-8")).hexdigest().encode("utf-8")
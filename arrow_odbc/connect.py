@@ -13,11 +13,28 @@ def to_bytes_and_len(value: Optional[str]) -> Tuple[bytes, int]:
         value_len = 0
     else:
         value_bytes = value.encode("utf-8")
-        value_len = len(value)
+        # Length in bytes, not characters. These differ for non ASCII text.
+        value_len = len(value_bytes)
 
     return (value_bytes, value_len)
 
 
+def enable_odbc_connection_pooling():
+    """
+    Activates connection pooling by the ODBC driver manager for the entire process. Connections
+    are then returned to a pool, once the reader or writer using them is freed, rather than being
+    closed. Subsequent calls to e.g. ``read_arrow_batches_from_odbc`` or ``insert_into_table`` with
+    an identical connection string (and user, password) take a connection from the pool, instead of
+    performing a full login.
+
+    This must be called before any connection to a data source is opened, otherwise an ``Error`` is
+    raised. On non windows platforms unixODBC may additionally require ``Pooling = Yes`` in the
+    ``[ODBC]`` section of ``odbcinst.ini`` and a ``CPTimeout`` for the driver.
+    """
+    error = lib.arrow_odbc_enable_connection_pooling()
+    raise_on_error(error)
+
+
 def connect_to_database(connection_string, user, password) -> Any:
 
     connection_string_bytes = connection_string.encode("utf-8")
@@ -40,4 +57,4 @@ def connect_to_database(connection_string, user, password) -> Any:
     # See if we connected successfully and return an error if not
     raise_on_error(error)
     # Dereference output pointer. This gives us an `OdbcConnection *`
-    return connection_out[0]
\ No newline at end of file
+    return connection_out[0]
\ No newline at end of file
@@ -0,0 +1,131 @@
+from datetime import date, datetime, time
+from typing import List, Optional, Tuple
+
+from arrow_odbc.parameter import Parameter
+from arrow_odbc.reader import (
+    BatchReader,
+    range_partitions,
+    read_arrow_batches_from_odbc,
+    read_arrow_batches_from_odbc_partitioned,
+)
+
+
+def read_arrow_batches_incremental(
+    table: str,
+    watermark_column: str,
+    last_watermark: Optional[Parameter],
+    batch_size: int,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    columns: Optional[List[str]] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+    partition_column: Optional[str] = None,
+    partition_range: Optional[Tuple[int, int]] = None,
+    num_partitions: Optional[int] = None,
+    parallelism: Optional[int] = None,
+) -> Optional[BatchReader]:
+    """
+    Read the rows of a table which have been added or changed since the last extract, according to
+    a monotonically increasing watermark column, e.g. an ``updated_at`` timestamp or a row
+    version. While the batches are converted, the native library keeps track of the largest value
+    of the watermark column. Once all batches have been consumed, ``BatchReader.watermark`` holds
+    the ``last_watermark`` to pass to the next extract, without scanning the batches in Python.
+
+    The watermark is bound as a typed parameter, so integers, floating points and timestamps are
+    compared as such by the data source, rather than as text. Timestamps keep their nanoseconds.
+
+    ``table``, ``watermark_column``, ``columns`` and ``partition_column`` are inserted into the
+    query verbatim, since quoting identifiers differs between data sources. They must therefore be
+    trusted identifiers, never input of users. Quote ``table`` as required by the data source, e.g.
+    ``"[Order Details]"`` for Microsoft SQL Server.
+
+    :param table: Name of the table to read from.
+    :param watermark_column: Name of the column rows are compared by. Only rows with a value larger
+        than ``last_watermark`` are read. The values must be integers, floating points, dates,
+        timestamps or text. Also the name of the column in the schema of the result set, so it must
+        not be quoted.
+    :param last_watermark: Watermark of the previous extract. ``None`` reads the entire table.
+    :param batch_size: The maxmium number of rows within each batch.
+    :param connection_string: ODBC Connection string used to connect to the data source. See
+        ``read_arrow_batches_from_odbc``.
+    :param user: Allows for specifying the user seperatly from the connection string if it is not
+        already part of it.
+    :param password: Allows for specifying the password seperatly from the connection string if it
+        is not already part of it.
+    :param columns: Names of the columns to read. Must include ``watermark_column``. ``None`` reads
+        all columns.
+    :param max_text_size: See ``read_arrow_batches_from_odbc``.
+    :param max_binary_size: See ``read_arrow_batches_from_odbc``.
+    :param falliable_allocations: See ``read_arrow_batches_from_odbc``.
+    :param partition_column: Integer column to split the delta into partitions by, which are read
+        concurrently over multiple connections, see ``read_arrow_batches_from_odbc_partitioned``.
+        ``None`` reads the delta over a single connection.
+    :param partition_range: Half open range ``[start, end)`` of ``partition_column`` split into
+        ``num_partitions`` partitions, see ``range_partitions``. Required with
+        ``partition_column``.
+    :param num_partitions: Number of partitions. Required with ``partition_column``.
+    :param parallelism: Number of connections the partitions are read with. ``None`` opens one
+        connection for each partition.
+    :return: A ``BatchReader`` iterating over the batches of the delta. ``None`` if the statement
+        does not produce a result set.
+    """
+    if columns is not None and watermark_column not in columns:
+        raise ValueError("columns must include the watermark_column.")
+
+    if partition_column is not None and (partition_range is None or num_partitions is None):
+        raise ValueError("partition_column requires partition_range and num_partitions.")
+
+    # Dates are bound as timestamps at midnight.
+    if isinstance(last_watermark, date) and not isinstance(last_watermark, datetime):
+        last_watermark = datetime.combine(last_watermark, time())
+
+    select = ", ".join(columns) if columns is not None else "*"
+    query = f"SELECT {select} FROM {table}"
+    predicates = []
+    parameters: List[Parameter] = []
+    if last_watermark is not None:
+        predicates.append(f"{watermark_column} > ?")
+        parameters.append(last_watermark)
+
+    if partition_column is not None:
+        predicates.append(f"{partition_column} >= ? AND {partition_column} < ?")
+        query = " WHERE ".join([query, " AND ".join(predicates)])
+        (start, end) = partition_range  # type: ignore
+        reader = read_arrow_batches_from_odbc_partitioned(
+            query=query,
+            batch_size=batch_size,
+            connection_string=connection_string,
+            partitions=[
+                parameters + partition
+                for partition in range_partitions(start, end, num_partitions)  # type: ignore
+            ],
+            parallelism=parallelism,
+            ordered=False,
+            user=user,
+            password=password,
+            max_text_size=max_text_size,
+            max_binary_size=max_binary_size,
+            falliable_allocations=falliable_allocations,
+        )
+    else:
+        if predicates:
+            query = " WHERE ".join([query, " AND ".join(predicates)])
+        reader = read_arrow_batches_from_odbc(
+            query=query,
+            batch_size=batch_size,
+            connection_string=connection_string,
+            user=user,
+            password=password,
+            parameters=parameters,
+            max_text_size=max_text_size,
+            max_binary_size=max_binary_size,
+            falliable_allocations=falliable_allocations,
+        )
+    if reader is None:
+        return None
+
+    reader.track_watermark(watermark_column, last_watermark)
+    return reader
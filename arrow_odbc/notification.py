@@ -0,0 +1,29 @@
+import asyncio
+import socket
+
+
+class Notification:
+    """
+    Socket pair the native library writes to, each time a reader or writer working on a system
+    thread may be able to make progress. Waiting for it allows the event loop to run other tasks in
+    the meantime.
+    """
+
+    def __init__(self):
+        self._receiver, self._sender = socket.socketpair()
+        self._receiver.setblocking(False)
+        self._sender.setblocking(False)
+
+    def native_socket(self) -> int:
+        """
+        Socket passed to the native library. It is closed once this instance is deleted, so it must
+        outlive the native reader or writer.
+        """
+        return self._sender.fileno()
+
+    async def wait(self):
+        """
+        Returns once at least one notification has been written since the last call.
+        """
+        loop = asyncio.get_running_loop()
+        await loop.sock_recv(self._receiver, 4096)
@@ -0,0 +1,121 @@
+from datetime import datetime, timedelta
+from typing import Any, List, Optional, Tuple, Union
+from cffi.api import FFI  # type: ignore
+from pyarrow import TimestampScalar
+
+from arrow_odbc.connect import to_bytes_and_len  # type: ignore
+
+from ._native import ffi, lib  # type: ignore
+
+Parameter = Union[None, str, int, float, datetime, bytes, TimestampScalar]
+
+_SUPPORTED_TYPES = (str, int, float, datetime, bytes, TimestampScalar)
+
+# Ticks of each Arrow time unit per second.
+_TICKS_PER_SECOND = {"s": 1, "ms": 1_000, "us": 1_000_000, "ns": 1_000_000_000}
+
+_EPOCH = datetime(1970, 1, 1)
+
+# Range of BIGINT, which integers are bound as.
+_MIN_INT64 = -(2**63)
+_MAX_INT64 = 2**63 - 1
+
+
+def to_parameter_array(parameters: Optional[List[Parameter]]) -> Tuple[Any, int, List[Any]]:
+    """
+    Converts Python values into an array of native parameters. The type of the parameter is
+    chosen based on the type of the value: ``str`` is bound as VARCHAR, ``int`` as BIGINT,
+    ``float`` as DOUBLE, ``datetime`` and ``pyarrow.TimestampScalar`` as TIMESTAMP and ``bytes`` as
+    VARBINARY. ``None`` is bound as ``NULL``. Arrow timestamps keep their nanoseconds, and so do
+    ``pandas.Timestamp`` values.
+
+    The native code takes ownership of the parameters, yet text and binary values are only
+    referenced. So the returned list of buffers must be kept alive, until the native call the
+    parameters are passed to is finished.
+
+    :return: Tuple of parameter array, its length and the buffers to keep alive.
+    """
+    if parameters is None:
+        return (FFI.NULL, 0, [])
+
+    # Check values up front, so we do not leak the parameters created before an invalid one.
+    check_parameter_types(parameters)
+
+    parameters_array = ffi.new("ArrowOdbcParameter *[]", len(parameters))
+    keep_alive: List[Any] = []
+    try:
+        for p_index, value in enumerate(parameters):
+            parameters_array[p_index] = _make_parameter(value, keep_alive)
+    except BaseException:
+        # Ownership has not been passed to native code yet, so we must free them ourselves.
+        for parameter in parameters_array:
+            if parameter != ffi.NULL:
+                lib.arrow_odbc_parameter_free(parameter)
+        raise
+    return (parameters_array, len(parameters), keep_alive)
+
+
+def check_parameter_types(parameters: Optional[List[Parameter]]):
+    """
+    Raises a ``TypeError`` if any of the values can not be bound as parameter, or a ``ValueError``
+    if an integer exceeds the range of BIGINT or a ``datetime`` is timezone aware. TIMESTAMP
+    parameters carry no offset, so rather than silently dropping it, aware values must be converted
+    to naive ones by the caller, e.g. in UTC. Allows for failing early, e.g. before opening a
+    connection.
+    """
+    for value in parameters or []:
+        if not isinstance(value, _SUPPORTED_TYPES) and value is not None:
+            raise TypeError(f"Unsupported parameter type: {type(value).__name__}")
+        if isinstance(value, int) and not _MIN_INT64 <= value <= _MAX_INT64:
+            raise ValueError(f"Integer parameter exceeds the range of BIGINT: {value}")
+        if isinstance(value, TimestampScalar) and value.type.tz is not None:
+            raise ValueError(
+                f"Timezone aware timestamp parameters are not supported: {value}. Cast it to a "
+                "timestamp without timezone first."
+            )
+        if isinstance(value, datetime) and value.utcoffset() is not None:
+            raise ValueError(
+                f"Timezone aware datetime parameters are not supported: {value}. Convert it to a "
+                "naive datetime first, e.g. in UTC."
+            )
+
+
+def _make_parameter(value: Parameter, keep_alive: List[Any]) -> Any:
+    # bool is a subclass of int, so it is bound as integer, too.
+    if isinstance(value, int):
+        return lib.arrow_odbc_parameter_int64_make(value)
+    if isinstance(value, float):
+        return lib.arrow_odbc_parameter_float64_make(value)
+    if isinstance(value, TimestampScalar):
+        if not value.is_valid:
+            return _make_parameter(None, keep_alive)
+        # Split the ticks ourselves, rather than using `as_py`, which truncates nanoseconds and
+        # raises for them without pandas.
+        ticks_per_second = _TICKS_PER_SECOND[value.type.unit]
+        (seconds, ticks) = divmod(value.value, ticks_per_second)
+        timestamp = _EPOCH + timedelta(seconds=seconds)
+        return _make_timestamp(timestamp, ticks * (1_000_000_000 // ticks_per_second))
+    if isinstance(value, datetime):
+        # `pandas.Timestamp` is a subclass of datetime with an additional nanosecond field.
+        nanoseconds = value.microsecond * 1000 + getattr(value, "nanosecond", 0)
+        return _make_timestamp(value, nanoseconds)
+    if isinstance(value, bytes):
+        keep_alive.append(value)
+        return lib.arrow_odbc_parameter_binary_make(value, len(value))
+    # str or None
+    (p_bytes, p_len) = to_bytes_and_len(value)
+    keep_alive.append(p_bytes)
+    return lib.arrow_odbc_parameter_string_make(p_bytes, p_len)
+
+
+def _make_timestamp(value: datetime, nanoseconds: int) -> Any:
+    # Microseconds of `value` are replaced by `nanoseconds`.
+    return lib.arrow_odbc_parameter_timestamp_make(
+        value.year,
+        value.month,
+        value.day,
+        value.hour,
+        value.minute,
+        value.second,
+        nanoseconds,
+    )
@@ -0,0 +1,122 @@
+from typing import List, Optional
+
+from arrow_odbc.connect import connect_to_database  # type: ignore
+from arrow_odbc.parameter import Parameter, to_parameter_array
+from arrow_odbc.reader import BatchReader
+
+from ._native import ffi, lib  # type: ignore
+from .error import raise_on_error
+
+
+class PreparedQuery:
+    """
+    A query prepared once and executed many times, with different parameters. The data source
+    parses and plans the query only once. Column buffers are not reused, each execution allocates
+    them anew for its result set.
+    """
+
+    def __init__(self, handle):
+        """
+        Low level constructor, users should rather invoke ``prepare`` in order to create instances
+        of ``PreparedQuery``.
+        """
+        # We take ownership of the prepared query written in Rust and keep it alive until `self` is
+        # deleted.
+        self.handle = handle
+
+    def __del__(self):
+        # Free the resources associated with this handle. The connection is closed once the
+        # readers created by this query are freed as well.
+        lib.arrow_odbc_prepared_query_free(self.handle)
+
+    def execute(self, parameters: Optional[List[Parameter]] = None) -> Optional[BatchReader]:
+        """
+        Execute the prepared query and read the result as an iterator over Arrow batches.
+
+        Executing the query again invalidates the reader returned by the previous execution, since
+        both share the same statement. Iterating an invalidated reader raises an error.
+
+        :param parameters: One parameter for every placeholder (``?``) in the prepared query.
+            See ``read_arrow_batches_from_odbc`` for how the types of the values are mapped. You
+            can use `None` to pass `NULL`.
+        :return: In case the query does not produce a result set (e.g. in case of an INSERT
+            statement), ``None`` is returned. Otherwise a ``BatchReader`` is returned.
+        """
+        # Must be kept alive, until the parameters are bound.
+        (parameters_array, parameters_len, keep_alive) = to_parameter_array(parameters)
+
+        reader_out = ffi.new("ArrowOdbcReader **")
+
+        error = lib.arrow_odbc_prepared_query_execute(
+            self.handle, parameters_array, parameters_len, reader_out
+        )
+        raise_on_error(error)
+
+        reader = reader_out[0]
+        if reader == ffi.NULL:
+            # The query ran successfully but did not produce a result set
+            return None
+        else:
+            return BatchReader(reader)
+
+
+def prepare(
+    query: str,
+    batch_size: int,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+) -> PreparedQuery:
+    """
+    Prepare a query for repeated execution. Executing the same query many times with different
+    parameters (e.g. one lookup per key) spends a lot of time parsing and planning the identical
+    statement over and over again. Preparing the query avoids this.
+
+    :param query: The SQL statement to prepare. Use question marks (``?``) as placeholders for the
+        parameters passed to ``PreparedQuery.execute``.
+    :param batch_size: The maxmium number rows within each batch.
+    :param connection_string: ODBC Connection string used to connect to the data source. To find a
+        connection string for your data source try https://www.connectionstrings.com/.
+    :param user: Allows for specifying the user seperatly from the connection string if it is not
+        already part of it. The value will eventually be escaped and attached to the connection
+        string as `UID`.
+    :param password: Allows for specifying the password seperatly from the connection string if it
+        is not already part of it. The value will eventually be escaped and attached to the
+        connection string as `PWD`.
+    :param max_text_size: An upper limit for the size of buffers bound to variadic text columns of
+        the data source. See ``read_arrow_batches_from_odbc``.
+    :param max_binary_size: An upper limit for the size of buffers bound to variadic binary columns
+        of the data source. See ``read_arrow_batches_from_odbc``.
+    :param falliable_allocations: If ``True`` an recoverable error is raised in case there is not
+        enough memory to allocate the buffers. See ``read_arrow_batches_from_odbc``.
+    :return: A ``PreparedQuery``. It owns the connection to the data source.
+    """
+    query_bytes = query.encode("utf-8")
+
+    connection = connect_to_database(connection_string, user, password)
+
+    if max_text_size is None:
+        max_text_size = 0
+
+    if max_binary_size is None:
+        max_binary_size = 0
+
+    prepared_out = ffi.new("ArrowOdbcPreparedQuery **")
+
+    # Takes ownership of the connection, even in case of an error.
+    error = lib.arrow_odbc_prepared_query_make(
+        connection,
+        query_bytes,
+        len(query_bytes),
+        batch_size,
+        max_text_size,
+        max_binary_size,
+        falliable_allocations,
+        prepared_out,
+    )
+    raise_on_error(error)
+
+    return PreparedQuery(prepared_out[0])
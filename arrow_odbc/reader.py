@@ -1,21 +1,42 @@
-from typing import List, Optional, Tuple
-from cffi.api import FFI  # type: ignore
+from threading import Lock
+from typing import Any, Callable, Dict, List, Optional, Tuple
 
 from pyarrow.cffi import ffi as arrow_ffi  # type: ignore
-from pyarrow import RecordBatch, Schema, Array
+from pyarrow import RecordBatch, Schema, Array, TimestampScalar
 
-from arrow_odbc.connect import to_bytes_and_len, connect_to_database  # type: ignore
+from arrow_odbc.attributes import (
+    CONNECTION_ATTRIBUTES,
+    STATEMENT_ATTRIBUTES,
+    Attributes,
+    to_attribute_array,
+)
+from arrow_odbc.cache import cache_key
+from arrow_odbc.connect import connect_to_database  # type: ignore
+from arrow_odbc.parameter import Parameter, check_parameter_types, to_parameter_array
 
 from ._native import ffi, lib  # type: ignore
 from .error import raise_on_error
+from .notification import Notification
+from .stats import stats_to_dict
 
 
 class BatchReader:
     """
     Iterates over Arrow batches from an ODBC data source
+
+    The GIL is released while batches are fetched, so readers in different threads stream
+    concurrently. A single reader may be shared between threads, yet its batches are fetched one
+    at a time.
+
+    The ``stats`` attribute holds cumulative counters of the reader. If ``stats_callback`` is set,
+    it is called with them after each batch.
+
+    Readers created with ``fetch_concurrently=True`` also support ``async for``. Waiting for the
+    next batch then does not block the event loop, so one event loop can drive many extracts
+    without a thread pool. Executing the query and creating the reader is still blocking.
     """
 
-    def __init__(self, handle):
+    def __init__(self, handle, stats_callback: Optional[Callable[[Dict[str, int]], None]] = None):
         """
         Low level constructor, users should rather invoke
         `read_arrow_batches_from_odbc` in order to create instances of
@@ -32,6 +53,24 @@ class BatchReader:
         raise_on_error(error)
         ptr_schema = int(ffi.cast("uintptr_t", schema_out))
         self.schema = Schema._import_from_c(ptr_schema)
+        # Expose the maximum number of rows per batch. It may be smaller than requested, if the
+        # batch size has been limited by memory.
+        self.batch_size = lib.arrow_odbc_reader_batch_size(self.handle)
+        # Structures the next batch is exported into. Allocated once and reused for every batch,
+        # since importing a batch moves its content out of them.
+        self._array = arrow_ffi.new("struct ArrowArray *")
+        self._schema = arrow_ffi.new("struct ArrowSchema *")
+        self._has_next_out = ffi.new("int*")
+        self._pending_out = ffi.new("bool *")
+        self._stats = ffi.new("ArrowOdbcReaderStats *")
+        self.stats_callback = stats_callback
+        # Created by the first call to `__anext__`.
+        self._notification: Optional[Notification] = None
+        # The GIL is released during native calls, so we must prevent several threads from using
+        # the same reader at once.
+        self._lock = Lock()
+        # Reported as watermark, until the reader has seen a larger one.
+        self._last_watermark: Any = None
 
     def __del__(self):
         # Free the resources associated with this handle.
@@ -43,23 +82,149 @@ class BatchReader:
 
     def __next__(self) -> RecordBatch:
         # Implment iterator protocol
+        with self._lock:
+            # In case of an error this is going to be a non null handle to the error. The GIL is
+            # released, while the batch is fetched.
+            error = lib.arrow_odbc_reader_next(
+                self.handle, self._array, self._schema, self._has_next_out
+            )
+            raise_on_error(error)
 
-        # In case of an error this is going to be a non null handle to the error
-        array = arrow_ffi.new("struct ArrowArray *")
-        schema = arrow_ffi.new("struct ArrowSchema *")
+            if self._has_next_out[0] == 0:
+                raise StopIteration()
+            struct_array, stats = self._import_batch()
 
-        has_next_out = ffi.new("int*")
+        return self._finish_batch(struct_array, stats)
 
-        error = lib.arrow_odbc_reader_next(self.handle, array, schema, has_next_out)
-        raise_on_error(error)
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self) -> RecordBatch:
+        if self._notification is None:
+            notification = Notification()
+            error = lib.arrow_odbc_reader_notify(self.handle, notification.native_socket())
+            raise_on_error(error)
+            self._notification = notification
+
+        while True:
+            with self._lock:
+                # Returns immediately, if the fetch thread is still busy with the next batch.
+                error = lib.arrow_odbc_reader_try_next(
+                    self.handle, self._array, self._schema, self._has_next_out, self._pending_out
+                )
+                raise_on_error(error)
+
+                if not self._pending_out[0]:
+                    if self._has_next_out[0] == 0:
+                        raise StopAsyncIteration()
+                    struct_array, stats = self._import_batch()
+                    break
+            await self._notification.wait()
+
+        return self._finish_batch(struct_array, stats)
+
+    def next_result_set(self) -> bool:
+        """
+        Advance to the next result set of a reader created with ``more_results=True``. Batches of
+        the current result set, which have not been fetched yet, are discarded. ``schema`` is
+        updated to the one of the next result set.
+
+        :return: ``False`` if all result sets have been consumed.
+        """
+        with self._lock:
+            has_more_out = ffi.new("bool *")
+            error = lib.arrow_odbc_reader_next_result_set(self.handle, has_more_out)
+            raise_on_error(error)
+            if not has_more_out[0]:
+                return False
+            schema_out = arrow_ffi.new("struct ArrowSchema *")
+            error = lib.arrow_odbc_reader_schema(self.handle, schema_out)
+            raise_on_error(error)
+            self.schema = Schema._import_from_c(int(ffi.cast("uintptr_t", schema_out)))
+        return True
+
+    def _import_batch(self):
+        # Must be called while holding the lock.
+        array_ptr = int(ffi.cast("uintptr_t", self._array))
+        schema_ptr = int(ffi.cast("uintptr_t", self._schema))
+        struct_array = Array._import_from_c(array_ptr, schema_ptr)
+        stats = self._read_stats() if self.stats_callback is not None else None
+        return struct_array, stats
+
+    def _finish_batch(self, struct_array, stats) -> RecordBatch:
+        # Called without holding the lock, so the callback may use the reader.
+        if stats is not None:
+            self.stats_callback(stats)
+        return RecordBatch.from_struct_array(struct_array)
 
-        if has_next_out[0] == 0:
-            raise StopIteration()
-        else:
+    @property
+    def stats(self) -> Dict[str, int]:
+        """
+        Cumulative counters of the reader, to tell where the time of an extract is spent:
+
+        * ``batches``, ``rows``: Number of batches and rows returned so far.
+        * ``bytes``: Memory occupied by the arrays of these batches.
+        * ``buffer_bytes``: Estimated size of the buffers bound to the cursor. ``0`` if unknown, or
+          if large columns are fetched one row at a time.
+        * ``fetch_ns``: Time spent fetching batches from the data source, including converting the
+          values into Arrow arrays. With ``fetch_concurrently`` this is the time spent waiting for
+          the fetch thread.
+        * ``conversion_ns``: Time spent converting batches after fetching, i.e. dictionary
+          encoding.
+        * ``export_ns``: Time spent handing batches over from the native library.
+        * ``pool_bytes``, ``pool_reuses``: Memory held by the buffer pool and number of buffers
+          reusing memory released by earlier batches. See ``buffer_pool_size``.
+
+        Durations are in nanoseconds. Time spent in Python between batches is not accounted for, so
+        compare the sum of the durations with the wall clock time to learn about it.
+        """
+        with self._lock:
+            return self._read_stats()
+
+    def track_watermark(self, column: str, last_watermark: Parameter):
+        """
+        Keeps track of the largest value of ``column`` in the batches read from now on, reported
+        as ``watermark``. Called by ``read_arrow_batches_incremental``.
+
+        :param column: Name of the column in the schema of the reader.
+        :param last_watermark: Reported as ``watermark``, until the reader has seen a value.
+        """
+        column_bytes = column.encode("utf-8")
+        with self._lock:
+            error = lib.arrow_odbc_reader_track_watermark(
+                self.handle, column_bytes, len(column_bytes)
+            )
+            raise_on_error(error)
+            self._last_watermark = last_watermark
+
+    @property
+    def watermark(self) -> Any:
+        """
+        Largest value of the watermark column in the batches read so far, for readers created by
+        ``read_arrow_batches_incremental``. As long as there have not been any new rows, this is
+        the ``last_watermark`` passed to it. Pass it as ``last_watermark`` to the next incremental
+        read, once all batches have been consumed. Timestamps are returned as
+        ``pyarrow.TimestampScalar``, so none of their nanoseconds are lost, e.g. of ``DATETIME2(7)``
+        columns. Other values are converted into their Python equivalent.
+        """
+        with self._lock:
+            array = arrow_ffi.new("struct ArrowArray *")
+            schema = arrow_ffi.new("struct ArrowSchema *")
+            has_value_out = ffi.new("bool *")
+            error = lib.arrow_odbc_reader_watermark(self.handle, array, schema, has_value_out)
+            raise_on_error(error)
+            if not has_value_out[0]:
+                return self._last_watermark
             array_ptr = int(ffi.cast("uintptr_t", array))
             schema_ptr = int(ffi.cast("uintptr_t", schema))
-            struct_array = Array._import_from_c(array_ptr, schema_ptr)
-            return RecordBatch.from_struct_array(struct_array)
+            watermark = Array._import_from_c(array_ptr, schema_ptr)[0]
+        if isinstance(watermark, TimestampScalar):
+            return watermark
+        return watermark.as_py()
+
+    def _read_stats(self) -> Dict[str, int]:
+        lib.arrow_odbc_reader_stats(self.handle, self._stats)
+        return stats_to_dict(self._stats)
 
 
 def read_arrow_batches_from_odbc(
@@ -68,17 +233,34 @@ def read_arrow_batches_from_odbc(
     connection_string: str,
     user: Optional[str] = None,
     password: Optional[str] = None,
-    parameters: Optional[List[Optional[str]]] = None,
+    parameters: Optional[List[Parameter]] = None,
     max_text_size: Optional[int] = None,
     max_binary_size: Optional[int] = None,
     falliable_allocations: bool = True,
+    max_bytes_per_batch: Optional[int] = None,
+    fetch_concurrently: bool = False,
+    prefetch_depth: int = 1,
+    zero_copy: bool = False,
+    initial_text_size: Optional[int] = None,
+    lob_threshold: Optional[int] = None,
+    dictionary_columns: Optional[List[str]] = None,
+    schema: Optional[Schema] = None,
+    stats_callback: Optional[Callable[[Dict[str, int]], None]] = None,
+    buffer_pool_size: Optional[int] = None,
+    more_results: bool = False,
+    statement_attributes: Optional[Attributes] = None,
+    connection_attributes: Optional[Attributes] = None,
+    initial_batch_size: Optional[int] = None,
+    cache_ttl: Optional[float] = None,
 ) -> Optional[BatchReader]:
     """
     Execute the query and read the result as an iterator over Arrow batches.
 
     :param query: The SQL statement yielding the result set which is converted into arrow record
         batches.
-    :param batch_size: The maxmium number rows within each batch.
+    :param batch_size: The maxmium number rows within each batch. The actual maximum may be
+        smaller, if limited by ``max_bytes_per_batch``. It is available as ``batch_size`` attribute
+        of the returned reader.
     :param connection_string: ODBC Connection string used to connect to the data source. To find a
         connection string for your data source try https://www.connectionstrings.com/.
     :param user: Allows for specifying the user seperatly from the connection string if it is not
@@ -90,8 +272,10 @@ def read_arrow_batches_from_odbc(
     :param parameters: ODBC allows you to use a question mark as placeholder marker (``?``) for
         positional parameters. This argument takes a list of parameters those number must match the
         number of placholders in the SQL statement. Using this instead of literals helps you avoid
-        SQL injections or may otherwise simplify your code. Currently all parameters are passed as
-        VARCHAR strings. You can use `None` to pass `NULL`.
+        SQL injections or may otherwise simplify your code. ``str`` values are passed as VARCHAR,
+        ``int`` as BIGINT, ``float`` as DOUBLE, ``datetime`` as TIMESTAMP and ``bytes`` as
+        VARBINARY. Passing typed values spares the data source from parsing them from text. You can
+        use `None` to pass `NULL`.
     :param max_text_size: An upper limit for the size of buffers bound to variadic text columns of
         the data source. This limit does not (directly) apply to the size of the created arrow
         buffers, but rather applies to the buffers used for the data in transit. Use this option if
@@ -118,12 +302,228 @@ def read_arrow_batches_from_odbc(
         In case you can test your query against the schema you can safely set this to ``False``. The
         required memory will not depend on the amount of data in the data source. Default is
         ``True`` though, safety first.
+    :param max_bytes_per_batch: An upper limit for the total size of the buffers bound to the
+        cursor, in bytes. The size of a row in these buffers is derived from the column types of
+        the result set (and ``max_text_size``, ``max_binary_size``). If ``batch_size`` rows would
+        not fit, the number of rows in each batch is reduced accordingly. This allows you to use
+        the same setting for narrow and wide result sets alike. An error is raised if not even a
+        single row would fit. ``None`` means no upper limit applies and ``batch_size`` rows are
+        fetched in each batch.
+    :param fetch_concurrently: If ``True`` a dedicated system thread is used to fetch the next
+        batch from the data source, while your code is still processing the current one. This way
+        the time spend waiting for the database overlaps with the time spend in Python. The price
+        is the memory for one additional batch, since the buffers the next batch is fetched into
+        can not be the ones, holding the batch you are working with. Required to iterate the
+        reader with ``async for``. Default is ``False``.
+    :param prefetch_depth: Only relevant if ``fetch_concurrently`` is ``True``. Maximum number of
+        batches fetched ahead of your code. Once this many batches are waiting to be consumed,
+        fetching pauses until you catch up. A larger depth allows for fetching to continue during
+        short stalls of the consumer (e.g. an upload or a garbage collection), at the cost of
+        memory. Roughly ``prefetch_depth + 1`` batches are held in memory at any time. Must be at
+        least ``1``. Default is ``1``.
+    :param zero_copy: If ``True`` and the result set consists exclusively of non nullable integer
+        and floating point columns, the buffers the driver fetches the values into become the
+        buffers of the Arrow arrays, instead of being copied into them. A fresh set of buffers is
+        bound to the cursor before each fetch. Non nullable date and timestamp columns are
+        supported too. Their values are converted from the structs ODBC uses with vectorized
+        kernels (using AVX2, if the CPU supports it). For other result sets this option has no
+        effect.
+        Default is ``False``.
+    :param initial_text_size: If set, buffers for text columns are sized from the values actually
+        fetched, rather than from the column size declared by the data source. The first batch is
+        fetched with buffers of this size. As long as it holds values which may not have fitted,
+        the query is executed again with buffers twice the size, up to ``max_text_size`` (if
+        set), or up to the size the data source declares for the columns which did not fit. So
+        the query may run several times, before the first batch is returned. It must be fine to
+        execute it more than once. The remaining batches are fetched with the buffers the first
+        batch fitted in. A batch can not be fetched a second time, so should a value of a later
+        batch not fit, iterating the reader raises an error in the middle of the result set, after
+        the batches before it have been returned. Values are never silently truncated, unless
+        ``max_text_size`` is reached. This helps with e.g. VARCHAR(MAX) columns, which mostly hold
+        short values, and allows for much larger batches with the same memory. ``None`` sizes the
+        buffers based on the column sizes reported by the driver. Default is ``None``.
+    :param lob_threshold: Text and binary columns whose size reported by the data source exceeds
+        this threshold (or is unknown, like for VARCHAR(MAX) or BLOBs) are retrieved in chunks,
+        until each value is complete. They are neither truncated by ``max_text_size`` and
+        ``max_binary_size``, nor do they require buffers which fit their largest possible value for
+        every row of the batch. Such columns are returned as ``large_string`` or ``large_binary``.
+        If the driver supports it (``SQL_GD_BLOCK``), the other columns are still fetched for a
+        block of rows at once and only the large columns are retrieved row by row. Otherwise
+        result sets containing a large column are fetched one row at a time, which is much slower.
+        Columns of other types than integers, floating points, booleans, dates, timestamps, text
+        and binary (e.g. decimals) raise an error in this case. Pass a ``schema`` to fetch them as
+        one of these types, e.g. as ``pa.string()``. Result sets without large columns are fetched
+        as usual. Can not be combined with ``initial_text_size``. ``None`` binds all columns to
+        buffers. Default is ``None``.
+    :param dictionary_columns: Names of text columns which are returned dictionary encoded, i.e.
+        as ``pa.dictionary(pa.int32(), pa.string())``. Meant for columns with few distinct values,
+        like countries or currencies. Each distinct value is held in memory only once, and every
+        row refers to it by a 32 bit key. The dictionary persists across batches, so a value keeps
+        its key for the entire result set and the dictionary of each batch holds all values seen
+        so far. Fetching a column with more than 65536 distinct values raises an error.
+        ``None`` returns all text columns as plain strings. Default is ``None``.
+    :param schema: Arrow schema of the returned batches, overriding the one inferred from the
+        column types reported by the data source. It must have one field for each column of the
+        result set. The driver converts the values directly into the buffers for the requested
+        types. E.g. IDs declared as ``DECIMAL(38,0)`` can be fetched as ``pa.int64()``, or
+        timestamps as ``pa.timestamp("ms")``. Narrower types mean smaller buffers and spare you
+        casts afterwards. ``None`` infers the schema. Default is ``None``.
+    :param stats_callback: Called with the ``stats`` of the reader after each batch, e.g. to
+        forward them to your metrics system. Default is ``None``.
+    :param buffer_pool_size: Only relevant if the result set is fetched with ``zero_copy``. Number
+        of bytes of released Arrow buffers the reader retains, so the buffers of later batches
+        reuse their memory rather than being allocated anew. Buffers return to the pool as soon as
+        pyarrow releases the last array referencing them, so a pool large enough for one or two
+        batches suffices, if you drop each batch before fetching the next one. This avoids
+        allocator churn and a resident set size growing from fragmentation over long extracts. The
+        ``stats`` of the reader report the memory held by the pool as ``pool_bytes`` and the number
+        of reused buffers as ``pool_reuses``. ``None`` allocates the buffers of each batch anew.
+        Default is ``None``.
+    :param more_results: If ``True`` all result sets produced by the query are fetched, e.g. the
+        ones of a stored procedure or of a batch of several ``SELECT`` statements. The reader
+        iterates over the batches of the first result set. Call ``BatchReader.next_result_set`` to
+        advance to the next one, which updates ``BatchReader.schema``. Results without columns,
+        like the row counts of inserts, are skipped. Columns of other types than integers, floating
+        points, booleans, dates, timestamps, text and binary (e.g. decimals) are returned as text.
+        Values are fetched one row at a time, without binding any buffers. So this can not be combined with ``max_text_size``,
+        ``max_binary_size``, ``max_bytes_per_batch``, ``fetch_concurrently``, ``zero_copy``,
+        ``initial_text_size``, ``lob_threshold``, ``dictionary_columns``, ``schema`` or
+        ``initial_batch_size``. Default is ``False``.
+    :param statement_attributes: Integer valued ODBC statement attributes, set before the query is
+        executed. Keys are either names, i.e. ``"query_timeout"``, ``"max_rows"``, ``"noscan"``,
+        ``"max_length"``, ``"cursor_type"``, ``"concurrency"``, ``"keyset_size"``,
+        ``"retrieve_data"``, ``"cursor_scrollable"`` and ``"cursor_sensitivity"``, or the integer
+        constants of the attributes, e.g. for attributes specific to a driver. E.g. ``{"max_length":
+        1024}`` lets the driver truncate long values on the server side. The query is prepared
+        before executing it, so attributes apply to it. Together with ``initial_text_size`` or
+        ``more_results`` they apply to every execution. This can not be combined with
+        ``zero_copy``, ``lob_threshold`` or ``initial_batch_size``. ``None`` leaves the defaults of
+        the driver. Default is ``None``.
+    :param connection_attributes: Integer valued ODBC connection attributes, set on the connection
+        before the query is executed. Keys are either names, i.e. ``"access_mode"``,
+        ``"autocommit"``, ``"txn_isolation"`` and ``"connection_timeout"``, or the integer constants
+        of the attributes. Settings which must be applied before connecting, like the packet size
+        or the fetch settings of many drivers (e.g. ``UseDeclareFetch=1;Fetch=10000`` for the
+        PostgreSQL driver, or ``PFC=`` for the Oracle driver), belong into the connection string
+        instead. Default is ``None``.
+    :param initial_batch_size: Number of rows of the first batch. Each following batch has twice
+        as many rows, until ``batch_size`` is reached. Useful for previews and interactive
+        consumers, which see the first rows as soon as they are fetched, rather than once a full
+        batch is filled. Small result sets also never allocate buffers for a full batch. Unless
+        the values are fetched with ``zero_copy`` or ``lob_threshold``, the smaller batches are
+        retrieved row by row, before buffers for ``batch_size`` rows are bound. Row by row
+        retrieval is slow, so in this case the first batch has at most 1024 rows and buffers for
+        ``batch_size`` rows are bound, once the next batch would exceed 1024 rows. This can not be
+        combined with ``more_results``, ``initial_text_size`` or ``statement_attributes``. ``None``
+        starts with ``batch_size`` rows. Default is ``None``.
+    :param cache_ttl: If set, the converted batches are cached in memory for this many seconds,
+        once the reader has been consumed entirely. Executing the same query with the same
+        parameters over the same connection string (and with the same options shaping the batches)
+        within this time returns a reader over the cached batches, without connecting to the data
+        source at all. Useful for dashboards and notebooks, which issue the same query over and
+        over. The cached batches share their memory with the ones returned, so caching does not
+        copy any values. Readers which are dropped before they are consumed, or fail, are not
+        cached. The cache knows nothing about changes to the data source, so only use this if
+        results as old as ``cache_ttl`` are acceptable. See ``set_result_cache_size`` and
+        ``clear_result_cache``. Can not be combined with ``more_results``. ``None`` always queries
+        the data source. Default is ``None``.
     :return: In case the query does not produce a result set (e.g. in case of an INSERT statement),
         ``None`` is returned. Should the statement return a result set a ``BatchReader`` is
         returned, which implements the iterator protocol and iterates over individual arrow batches.
     """
     query_bytes = query.encode("utf-8")
 
+    if prefetch_depth < 1:
+        raise ValueError("prefetch_depth must be at least 1.")
+
+    if initial_text_size is not None and initial_text_size < 1:
+        raise ValueError("initial_text_size must be at least 1.")
+
+    if initial_batch_size is not None:
+        if initial_batch_size < 1:
+            raise ValueError("initial_batch_size must be at least 1.")
+        if initial_text_size is not None:
+            raise ValueError("initial_batch_size can not be combined with initial_text_size.")
+
+    if buffer_pool_size is not None and buffer_pool_size < 0:
+        raise ValueError("buffer_pool_size must not be negative.")
+
+    if lob_threshold is not None:
+        if lob_threshold < 1:
+            raise ValueError("lob_threshold must be at least 1.")
+        if initial_text_size is not None:
+            raise ValueError("lob_threshold can not be combined with initial_text_size.")
+
+    if statement_attributes:
+        incompatible = {
+            "zero_copy": zero_copy,
+            "lob_threshold": lob_threshold is not None,
+            "initial_batch_size": initial_batch_size is not None,
+        }
+        for name, is_set in incompatible.items():
+            if is_set:
+                raise ValueError(f"statement_attributes can not be combined with {name}.")
+
+    if more_results:
+        incompatible = {
+            "max_text_size": max_text_size is not None,
+            "max_binary_size": max_binary_size is not None,
+            "max_bytes_per_batch": max_bytes_per_batch is not None,
+            "fetch_concurrently": fetch_concurrently,
+            "zero_copy": zero_copy,
+            "initial_text_size": initial_text_size is not None,
+            "lob_threshold": lob_threshold is not None,
+            "dictionary_columns": bool(dictionary_columns),
+            "schema": schema is not None,
+            "initial_batch_size": initial_batch_size is not None,
+        }
+        for name, is_set in incompatible.items():
+            if is_set:
+                raise ValueError(f"more_results can not be combined with {name}.")
+
+    if cache_ttl is not None:
+        if cache_ttl <= 0:
+            raise ValueError("cache_ttl must be positive.")
+        if more_results:
+            raise ValueError("cache_ttl can not be combined with more_results.")
+
+    check_parameter_types(parameters)
+
+    if cache_ttl is not None:
+        # Options which do not affect the values or the shape of the batches, like
+        # ``fetch_concurrently``, are not part of the key. Dictionary encoding is applied after
+        # batches leave the cache.
+        key = cache_key(
+            connection_string,
+            user,
+            password,
+            None if connection_attributes is None else dict(connection_attributes),
+            query,
+            parameters,
+            batch_size,
+            max_text_size,
+            max_binary_size,
+            max_bytes_per_batch,
+            zero_copy,
+            initial_text_size,
+            lob_threshold,
+            None if schema is None else schema.to_string(),
+            None if statement_attributes is None else dict(statement_attributes),
+            initial_batch_size,
+        )
+        cached = lib.arrow_odbc_cache_lookup(key, len(key))
+        if cached != ffi.NULL:
+            _dictionary_encode(cached, dictionary_columns)
+            return BatchReader(cached, stats_callback)
+
+    # Converted before connecting, so an unknown attribute does not leak the connection.
+    (statement_attributes_array, statement_attributes_len) = to_attribute_array(
+        statement_attributes, STATEMENT_ATTRIBUTES
+    )
+    (connection_attributes_array, connection_attributes_len) = to_attribute_array(
+        connection_attributes, CONNECTION_ATTRIBUTES
+    )
+
     connection = connect_to_database(connection_string, user, password)
 
     # Connecting to the database has been successful. Note that connection does not truly take
@@ -133,26 +533,56 @@ def read_arrow_batches_from_odbc(
     # is infalliable. arrow_odbc_reader_make will truly take ownership of the connection. Even if it
     # should fail, it will be closed correctly.
 
-    if parameters is None:
-        parameters_array = FFI.NULL
-        parameters_len = 0
-        encoded_parameters = []
-    else:
-        parameters_array = ffi.new("ArrowOdbcParameter *[]", len(parameters))
-        parameters_len = len(parameters)
-        # Must be kept alive. Within Rust code we only allocate an additional
-        # indicator the string payload is just referenced.
-        encoded_parameters = [to_bytes_and_len(p) for p in parameters]
-
     if max_text_size is None:
         max_text_size = 0
 
     if max_binary_size is None:
         max_binary_size = 0
 
-    for p_index in range(0, parameters_len):
-        (p_bytes, p_len) = encoded_parameters[p_index]
-        parameters_array[p_index] = lib.arrow_odbc_parameter_string_make(p_bytes, p_len)
+    if max_bytes_per_batch is None:
+        max_bytes_per_batch = 0
+
+    if initial_text_size is None:
+        initial_text_size = 0
+
+    if lob_threshold is None:
+        lob_threshold = 0
+
+    if buffer_pool_size is None:
+        buffer_pool_size = 0
+
+    if initial_batch_size is None:
+        initial_batch_size = 0
+
+    # Must be kept alive. Within Rust code we only allocate an additional indicator, text and binary
+    # payloads are just referenced.
+    (parameters_array, parameters_len, keep_alive) = to_parameter_array(parameters)
+
+    if schema is None:
+        c_schema = ffi.NULL
+    else:
+        # Must be kept alive until arrow_odbc_reader_make returns, which copies the schema.
+        c_schema = arrow_ffi.new("struct ArrowSchema *")
+        schema._export_to_c(int(arrow_ffi.cast("uintptr_t", c_schema)))
+
+    options = ffi.new("ArrowOdbcReaderOptions *")
+    options.max_text_size = max_text_size
+    options.max_binary_size = max_binary_size
+    options.fallibale_allocations = falliable_allocations
+    options.max_bytes_per_batch = max_bytes_per_batch
+    options.fetch_concurrently = fetch_concurrently
+    options.prefetch_depth = prefetch_depth
+    options.zero_copy = zero_copy
+    options.initial_text_size = initial_text_size
+    options.lob_threshold = lob_threshold
+    options.schema = c_schema
+    options.buffer_pool_bytes = buffer_pool_size
+    options.more_results = more_results
+    options.statement_attributes = statement_attributes_array
+    options.statement_attributes_len = statement_attributes_len
+    options.connection_attributes = connection_attributes_array
+    options.connection_attributes_len = connection_attributes_len
+    options.initial_batch_size = initial_batch_size
 
     reader_out = ffi.new("ArrowOdbcReader **")
 
@@ -163,9 +593,7 @@ def read_arrow_batches_from_odbc(
         batch_size,
         parameters_array,
         parameters_len,
-        max_text_size,
-        max_binary_size,
-        falliable_allocations,
+        options,
         reader_out,
     )
 
@@ -177,5 +605,154 @@ def read_arrow_batches_from_odbc(
     if reader == ffi.NULL:
         # The query ran successfully but did not produce a result set
         return None
-    else:
-        return BatchReader(reader)
+
+    if cache_ttl is not None:
+        error = lib.arrow_odbc_reader_cache(reader, key, len(key), int(cache_ttl * 1000))
+        if error != ffi.NULL:
+            # Not yet owned by a BatchReader, so we must free it ourselves.
+            lib.arrow_odbc_reader_free(reader)
+            raise_on_error(error)
+
+    _dictionary_encode(reader, dictionary_columns)
+
+    return BatchReader(reader, stats_callback)
+
+
+def _dictionary_encode(reader, dictionary_columns: Optional[List[str]]):
+    """
+    Dictionary encode the columns in all batches of a reader, not yet owned by a ``BatchReader``.
+    The reader is freed, should a column not be a text column.
+    """
+    for column in dictionary_columns or []:
+        column_bytes = column.encode("utf-8")
+        error = lib.arrow_odbc_reader_dictionary_encode(reader, column_bytes, len(column_bytes))
+        if error != ffi.NULL:
+            # Not yet owned by a BatchReader, so we must free it ourselves.
+            lib.arrow_odbc_reader_free(reader)
+            raise_on_error(error)
+
+
+def read_arrow_batches_from_odbc_partitioned(
+    query: str,
+    batch_size: int,
+    connection_string: str,
+    partitions: List[List[Parameter]],
+    parallelism: Optional[int] = None,
+    ordered: bool = True,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+) -> BatchReader:
+    """
+    Execute the query once for each partition and read the results of all partitions as one
+    iterator over Arrow batches. Partitions are executed concurrently over multiple connections to
+    the data source, each of them driven by a dedicated system thread.
+
+    :param query: The SQL statement yielding the result set of a single partition, e.g.
+        ``SELECT * FROM MyTable WHERE id >= ? AND id < ?``. The statement is executed once for
+        each entry in ``partitions``, with the entry bound to its placeholders (``?``). All
+        partitions are expected to yield result sets with identical schema.
+    :param batch_size: The maxmium number rows within each batch.
+    :param connection_string: ODBC Connection string used to connect to the data source. To find a
+        connection string for your data source try https://www.connectionstrings.com/.
+    :param partitions: One list of positional parameters for each partition. Each list must hold
+        one parameter for every placeholder in ``query``. See ``range_partitions`` for building
+        partitions over a range of an integer key column.
+    :param parallelism: Number of connections opened to the data source, and therefore the maximum
+        number of partitions read concurrently. ``None`` opens one connection for every partition.
+    :param ordered: If ``True`` all batches of a partition are yielded before the ones of the next
+        partition, in the order of ``partitions``. If ``False`` batches are yielded as soon as they
+        are fetched, regardless of their partition. This keeps all connections busy, even if the
+        partitions are of very different sizes. Default is ``True``.
+    :param user: Allows for specifying the user seperatly from the connection string if it is not
+        already part of it. The value will eventually be escaped and attached to the connection
+        string as `UID`.
+    :param password: Allows for specifying the password seperatly from the connection string if it
+        is not already part of it. The value will eventually be escaped and attached to the
+        connection string as `PWD`.
+    :param max_text_size: An upper limit for the size of buffers bound to variadic text columns of
+        the data source. See ``read_arrow_batches_from_odbc``.
+    :param max_binary_size: An upper limit for the size of buffers bound to variadic binary columns
+        of the data source. See ``read_arrow_batches_from_odbc``.
+    :param falliable_allocations: If ``True`` an recoverable error is raised in case there is not
+        enough memory to allocate the buffers. See ``read_arrow_batches_from_odbc``.
+    :return: A ``BatchReader`` iterating over the batches of all partitions. Its schema is the one
+        of the first partition executed.
+    """
+    if not partitions:
+        raise ValueError("At least one partition is required.")
+
+    parameters_per_partition = len(partitions[0])
+    if any(len(partition) != parameters_per_partition for partition in partitions):
+        raise ValueError("All partitions must have the same number of parameters.")
+
+    if parallelism is None:
+        parallelism = len(partitions)
+    if parallelism < 1:
+        raise ValueError("parallelism must be at least 1.")
+    num_connections = min(parallelism, len(partitions))
+
+    query_bytes = query.encode("utf-8")
+
+    if max_text_size is None:
+        max_text_size = 0
+
+    if max_binary_size is None:
+        max_binary_size = 0
+
+    flat_parameters = [p for partition in partitions for p in partition]
+    check_parameter_types(flat_parameters)
+
+    connections = []
+    try:
+        for _ in range(num_connections):
+            connections.append(connect_to_database(connection_string, user, password))
+    except:
+        # Connections not yet passed to arrow_odbc_reader_make_partitioned must be freed by us.
+        for connection in connections:
+            lib.arrow_odbc_connection_free(connection)
+        raise
+    connections_array = ffi.new("OdbcConnection *[]", connections)
+
+    # Parameters of all partitions in one flat array. The buffers must be kept alive until
+    # arrow_odbc_reader_make_partitioned returns.
+    (parameters_array, _, keep_alive) = to_parameter_array(flat_parameters)
+
+    reader_out = ffi.new("ArrowOdbcReader **")
+
+    error = lib.arrow_odbc_reader_make_partitioned(
+        connections_array,
+        num_connections,
+        query_bytes,
+        len(query_bytes),
+        batch_size,
+        parameters_array,
+        parameters_per_partition,
+        len(partitions),
+        max_text_size,
+        max_binary_size,
+        falliable_allocations,
+        ordered,
+        reader_out,
+    )
+    raise_on_error(error)
+
+    return BatchReader(reader_out[0])
+
+
+def range_partitions(start: int, end: int, num_partitions: int) -> List[List[Optional[str]]]:
+    """
+    Splits the half open range ``[start, end)`` into ``num_partitions`` consecutive ranges of
+    (almost) equal size. Intended to be used as ``partitions`` argument of
+    ``read_arrow_batches_from_odbc_partitioned``, together with a query like
+    ``SELECT * FROM MyTable WHERE id >= ? AND id < ?``.
+
+    :return: A list with one ``[lower, upper]`` pair for each partition.
+    """
+    if num_partitions < 1:
+        raise ValueError("num_partitions must be at least 1.")
+    length = end - start
+    bounds = [start + length * i // num_partitions for i in range(num_partitions + 1)]
+    return [[str(lower), str(upper)] for lower, upper in zip(bounds, bounds[1:])]
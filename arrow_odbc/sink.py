@@ -0,0 +1,161 @@
+import os
+from typing import List, Optional, Union
+
+from arrow_odbc.parameter import Parameter
+from arrow_odbc.reader import BatchReader, read_arrow_batches_from_odbc
+
+from ._native import ffi, lib  # type: ignore
+from .error import raise_on_error
+
+
+def odbc_to_parquet(
+    query: str,
+    path: Union[str, os.PathLike],
+    batch_size: int,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    parameters: Optional[List[Parameter]] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+    max_bytes_per_batch: Optional[int] = None,
+    row_group_size: Optional[int] = None,
+    compression: str = "snappy",
+) -> int:
+    """
+    Execute the query and write its result set into a Parquet file. This is equivalent to writing
+    each batch of ``read_arrow_batches_from_odbc`` with a ``pyarrow.parquet.ParquetWriter``, yet
+    the batches never reach Python. A dedicated system thread encodes the previous batch, while the
+    next one is fetched, and the GIL is released for the entire transfer.
+
+    :param query: The SQL statement yielding the result set which is written to the file.
+    :param path: Path of the file. An existing file is overwritten.
+    :param batch_size: The maxmium number of rows fetched within each batch.
+    :param connection_string: ODBC Connection string used to connect to the data source. See
+        ``read_arrow_batches_from_odbc``.
+    :param user: Allows for specifying the user seperatly from the connection string if it is not
+        already part of it.
+    :param password: Allows for specifying the password seperatly from the connection string if it
+        is not already part of it.
+    :param parameters: Positional parameters bound to the placeholders (``?``) of ``query``. See
+        ``read_arrow_batches_from_odbc``.
+    :param max_text_size: An upper limit for the size of buffers bound to variadic text columns.
+        See ``read_arrow_batches_from_odbc``.
+    :param max_binary_size: An upper limit for the size of buffers bound to variadic binary
+        columns. See ``read_arrow_batches_from_odbc``.
+    :param falliable_allocations: See ``read_arrow_batches_from_odbc``.
+    :param max_bytes_per_batch: See ``read_arrow_batches_from_odbc``.
+    :param row_group_size: Maximum number of rows in each row group of the file. Batches are
+        buffered until enough rows are collected, so this is independent of ``batch_size``.
+        ``None`` uses the default of the Rust ``parquet`` crate (1024 * 1024 rows).
+    :param compression: Codec used to compress column chunks. One of ``"uncompressed"``,
+        ``"snappy"``, ``"gzip"``, ``"brotli"``, ``"lz4"`` or ``"zstd"``.
+    :return: Number of rows written.
+    """
+    if row_group_size is None:
+        row_group_size = 0
+
+    reader = _execute(
+        query,
+        batch_size,
+        connection_string,
+        user,
+        password,
+        parameters,
+        max_text_size,
+        max_binary_size,
+        falliable_allocations,
+        max_bytes_per_batch,
+    )
+
+    path_bytes = os.fsencode(path)
+    compression_bytes = compression.encode("utf-8")
+    rows_out = ffi.new("uint64_t *")
+
+    error = lib.arrow_odbc_reader_write_parquet(
+        reader.handle,
+        path_bytes,
+        len(path_bytes),
+        row_group_size,
+        compression_bytes,
+        len(compression_bytes),
+        rows_out,
+    )
+    raise_on_error(error)
+
+    return rows_out[0]
+
+
+def odbc_to_arrow_ipc(
+    query: str,
+    path: Union[str, os.PathLike],
+    batch_size: int,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    parameters: Optional[List[Parameter]] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+    max_bytes_per_batch: Optional[int] = None,
+) -> int:
+    """
+    Execute the query and write its result set into an Arrow IPC file, also known as Feather V2.
+    The file can be read with ``pyarrow.ipc.open_file`` or ``pyarrow.feather.read_table``. Like
+    ``odbc_to_parquet`` the batches never reach Python and are encoded by a dedicated system thread,
+    while the next one is fetched.
+
+    See ``odbc_to_parquet`` for a description of the parameters.
+
+    :return: Number of rows written.
+    """
+    reader = _execute(
+        query,
+        batch_size,
+        connection_string,
+        user,
+        password,
+        parameters,
+        max_text_size,
+        max_binary_size,
+        falliable_allocations,
+        max_bytes_per_batch,
+    )
+
+    path_bytes = os.fsencode(path)
+    rows_out = ffi.new("uint64_t *")
+
+    error = lib.arrow_odbc_reader_write_ipc(reader.handle, path_bytes, len(path_bytes), rows_out)
+    raise_on_error(error)
+
+    return rows_out[0]
+
+
+def _execute(
+    query: str,
+    batch_size: int,
+    connection_string: str,
+    user: Optional[str],
+    password: Optional[str],
+    parameters: Optional[List[Parameter]],
+    max_text_size: Optional[int],
+    max_binary_size: Optional[int],
+    falliable_allocations: bool,
+    max_bytes_per_batch: Optional[int],
+) -> BatchReader:
+    reader = read_arrow_batches_from_odbc(
+        query=query,
+        batch_size=batch_size,
+        connection_string=connection_string,
+        user=user,
+        password=password,
+        parameters=parameters,
+        max_text_size=max_text_size,
+        max_binary_size=max_binary_size,
+        falliable_allocations=falliable_allocations,
+        max_bytes_per_batch=max_bytes_per_batch,
+    )
+    if reader is None:
+        raise ValueError("The query did not produce a result set.")
+    return reader
@@ -0,0 +1,11 @@
+from typing import Dict
+
+from ._native import ffi  # type: ignore
+
+
+def stats_to_dict(c_stats) -> Dict[str, int]:
+    """
+    Copies the counters of the native stats structure pointed to by ``c_stats`` into a dictionary.
+    Keys ending in ``_ns`` are durations in nanoseconds.
+    """
+    return {name: getattr(c_stats, name) for name, _field in ffi.typeof(c_stats).item.fields}
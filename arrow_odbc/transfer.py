@@ -0,0 +1,114 @@
+from typing import List, Optional
+
+from arrow_odbc.connect import connect_to_database  # type: ignore
+from arrow_odbc.parameter import Parameter, check_parameter_types, to_parameter_array
+
+from ._native import ffi, lib  # type: ignore
+from .error import raise_on_error
+
+
+def copy_table(
+    query: str,
+    source_connection_string: str,
+    table: str,
+    target_connection_string: str,
+    batch_size: int,
+    chunk_size: Optional[int] = None,
+    parameters: Optional[List[Parameter]] = None,
+    source_user: Optional[str] = None,
+    source_password: Optional[str] = None,
+    target_user: Optional[str] = None,
+    target_password: Optional[str] = None,
+    max_text_size: Optional[int] = None,
+    max_binary_size: Optional[int] = None,
+    falliable_allocations: bool = True,
+    prefetch_depth: int = 1,
+) -> int:
+    """
+    Execute the query on the source data source and insert its result set into a table of the
+    target data source. This is equivalent to passing the reader returned by
+    ``read_arrow_batches_from_odbc`` to ``insert_into_table``, yet the batches never reach Python.
+    They are neither exported to, nor imported from pyarrow and the GIL is released for the entire
+    transfer. A dedicated system thread fetches the next batch, while the previous one is inserted.
+
+    :param query: The SQL statement yielding the result set which is copied. The names of its
+        columns must match the column names of ``table``.
+    :param source_connection_string: ODBC Connection string used to connect to the data source the
+        query is executed on.
+    :param table: Name of a table on the target data source the rows are inserted into.
+    :param target_connection_string: ODBC Connection string used to connect to the data source
+        holding ``table``.
+    :param batch_size: The maxmium number of rows fetched within each batch.
+    :param chunk_size: Number of rows to insert in each roundtrip to the target. ``None`` uses
+        ``batch_size``.
+    :param parameters: Positional parameters bound to the placeholders (``?``) of ``query``. See
+        ``read_arrow_batches_from_odbc``.
+    :param source_user: Allows for specifying the user of the source seperatly from its connection
+        string.
+    :param source_password: Allows for specifying the password of the source seperatly from its
+        connection string.
+    :param target_user: Allows for specifying the user of the target seperatly from its connection
+        string.
+    :param target_password: Allows for specifying the password of the target seperatly from its
+        connection string.
+    :param max_text_size: An upper limit for the size of buffers bound to variadic text columns of
+        the source. See ``read_arrow_batches_from_odbc``.
+    :param max_binary_size: An upper limit for the size of buffers bound to variadic binary columns
+        of the source. See ``read_arrow_batches_from_odbc``.
+    :param falliable_allocations: If ``True`` an recoverable error is raised in case there is not
+        enough memory to allocate the buffers. See ``read_arrow_batches_from_odbc``.
+    :param prefetch_depth: Maximum number of batches fetched ahead of the insertion. Must be at
+        least ``1``. Default is ``1``.
+    :return: Number of rows copied.
+    """
+    if prefetch_depth < 1:
+        raise ValueError("prefetch_depth must be at least 1.")
+
+    if chunk_size is None:
+        chunk_size = batch_size
+
+    if max_text_size is None:
+        max_text_size = 0
+
+    if max_binary_size is None:
+        max_binary_size = 0
+
+    query_bytes = query.encode("utf-8")
+    table_bytes = table.encode("utf-8")
+
+    check_parameter_types(parameters)
+
+    source = connect_to_database(source_connection_string, source_user, source_password)
+    try:
+        target = connect_to_database(target_connection_string, target_user, target_password)
+    except:
+        # Not yet passed to arrow_odbc_copy_table, so we must free it ourselves.
+        lib.arrow_odbc_connection_free(source)
+        raise
+
+    # Must be kept alive until arrow_odbc_copy_table returns.
+    (parameters_array, parameters_len, keep_alive) = to_parameter_array(parameters)
+
+    rows_out = ffi.new("uintptr_t *")
+
+    # Takes ownership of both connections, even in case of an error.
+    error = lib.arrow_odbc_copy_table(
+        source,
+        query_bytes,
+        len(query_bytes),
+        parameters_array,
+        parameters_len,
+        batch_size,
+        max_text_size,
+        max_binary_size,
+        falliable_allocations,
+        prefetch_depth,
+        target,
+        table_bytes,
+        len(table_bytes),
+        chunk_size,
+        rows_out,
+    )
+    raise_on_error(error)
+
+    return rows_out[0]
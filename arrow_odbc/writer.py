@@ -1,13 +1,29 @@
-from typing import Optional, Any
+import asyncio
+import os
 
+from threading import Lock
+from typing import Callable, Dict, Optional, Any, Union
+
+from pyarrow import Schema, ipc
 from pyarrow.cffi import ffi as arrow_ffi
 from arrow_odbc.connect import connect_to_database
 
 from ._native import ffi, lib  # type: ignore
+from .error import raise_on_error
+from .notification import Notification
+from .stats import stats_to_dict
 
 class BatchWriter:
     """
     Writes arrow batches to a database table.
+
+    The GIL is released while rows are sent to the database, so writers in different threads
+    insert concurrently.
+
+    The ``stats`` attribute holds cumulative counters of the writer.
+
+    Pipelined writers also offer ``write_batch_async`` and ``flush_async``, which do not block the
+    event loop while the insert thread is busy.
     """
 
     def __init__(self, handle):
@@ -19,6 +35,17 @@ class BatchWriter:
         # We take ownership of the corresponding writer written in Rust and keep it alive until
         # `self` is deleted
         self.handle = handle
+        # Structures batches are exported into. Allocated once and reused for every batch, since
+        # the native writer moves their content out of them.
+        self._array = arrow_ffi.new("struct ArrowArray*")
+        self._schema = arrow_ffi.new("struct ArrowSchema*")
+        self._stats = ffi.new("ArrowOdbcWriterStats *")
+        self._ready_out = ffi.new("bool *")
+        # Created by the first asynchronous call.
+        self._notification: Optional[Notification] = None
+        # The GIL is released during native calls, so we must prevent several threads from using
+        # the same writer at once.
+        self._lock = Lock()
 
     def __del__(self):
         # Free the resources associated with this handle.
@@ -30,24 +57,126 @@ class BatchWriter:
         time they are full, the data is send to the database. To make sure all
         the data is is send ``flush`` must be called.
         """
-        with arrow_ffi.new("struct ArrowArray*") as c_array, \
-            arrow_ffi.new("struct ArrowSchema*") as c_schema:
-            
+        with self._lock:
             # Get the references to the C Data structures
-            c_array_ptr = int(arrow_ffi.cast("uintptr_t", c_array))
-            c_schema_ptr = int(arrow_ffi.cast("uintptr_t", c_schema))
+            c_array_ptr = int(arrow_ffi.cast("uintptr_t", self._array))
+            c_schema_ptr = int(arrow_ffi.cast("uintptr_t", self._schema))
 
             # Export the Array to the C Data structures.
             batch._export_to_c(c_array_ptr)
             batch.schema._export_to_c(c_schema_ptr)
 
-            lib.arrow_odbc_writer_write_batch(self.handle, c_array, c_schema)
+            # The GIL is released, while the rows are sent to the database.
+            error = lib.arrow_odbc_writer_write_batch(self.handle, self._array, self._schema)
+            raise_on_error(error)
 
     def flush(self):
         """
         Inserts the remaining rows of the last chunk to the database.
         """
-        lib.arrow_odbc_writer_flush(self.handle)
+        with self._lock:
+            error = lib.arrow_odbc_writer_flush(self.handle)
+            raise_on_error(error)
+
+    def write_parquet(
+        self, path: Union[str, os.PathLike], batch_size: int, decode_threads: int
+    ) -> int:
+        """
+        Inserts the rows of a Parquet file. Row groups are decoded by ``decode_threads`` native
+        system threads, so the batches never reach Python. Like ``write_batch`` it does not flush.
+        The writer must have been created with the schema ``parquet_to_odbc`` reads from the file.
+
+        :return: Number of rows passed to the writer.
+        """
+        path_bytes = os.fsencode(path)
+        rows_out = ffi.new("uint64_t *")
+        with self._lock:
+            error = lib.arrow_odbc_writer_write_parquet(
+                self.handle, path_bytes, len(path_bytes), batch_size, decode_threads, rows_out
+            )
+            raise_on_error(error)
+        return rows_out[0]
+
+    def write_ipc(self, path: Union[str, os.PathLike]) -> int:
+        """
+        Inserts the rows of an Arrow IPC file. The batches are decoded by a native system thread,
+        so they never reach Python. Like ``write_batch`` it does not flush.
+
+        :return: Number of rows passed to the writer.
+        """
+        path_bytes = os.fsencode(path)
+        rows_out = ffi.new("uint64_t *")
+        with self._lock:
+            error = lib.arrow_odbc_writer_write_ipc(
+                self.handle, path_bytes, len(path_bytes), rows_out
+            )
+            raise_on_error(error)
+        return rows_out[0]
+
+    async def write_batch_async(self, batch):
+        """
+        Like ``write_batch``, but waits for the insert thread to accept the batch without blocking
+        the event loop. Only one write or flush may be in progress at a time.
+        """
+        self._enable_notification()
+        with self._lock:
+            c_array_ptr = int(arrow_ffi.cast("uintptr_t", self._array))
+            c_schema_ptr = int(arrow_ffi.cast("uintptr_t", self._schema))
+            batch._export_to_c(c_array_ptr)
+            batch.schema._export_to_c(c_schema_ptr)
+
+            error = lib.arrow_odbc_writer_try_write_batch(
+                self.handle, self._array, self._schema, self._ready_out
+            )
+            raise_on_error(error)
+        await self._until_ready()
+
+    async def flush_async(self):
+        """
+        Like ``flush``, but waits for the remaining rows to be inserted without blocking the event
+        loop.
+        """
+        self._enable_notification()
+        with self._lock:
+            error = lib.arrow_odbc_writer_try_flush(self.handle, self._ready_out)
+            raise_on_error(error)
+        await self._until_ready()
+
+    def _enable_notification(self):
+        if self._notification is None:
+            notification = Notification()
+            error = lib.arrow_odbc_writer_notify(self.handle, notification.native_socket())
+            raise_on_error(error)
+            self._notification = notification
+
+    async def _until_ready(self):
+        # Errors of the insert thread are reported by the poll completing the operation.
+        while not self._ready_out[0]:
+            await self._notification.wait()
+            with self._lock:
+                error = lib.arrow_odbc_writer_poll(self.handle, self._ready_out)
+                raise_on_error(error)
+
+    @property
+    def stats(self) -> Dict[str, int]:
+        """
+        Cumulative counters of the writer, to tell where the time of a load is spent:
+
+        * ``batches``, ``rows``: Number of batches and rows written so far.
+        * ``bytes``: Memory occupied by the arrays of these batches.
+        * ``chunks``: Number of chunks sent to the database.
+        * ``import_ns``: Time spent handing batches over to the native library.
+        * ``write_ns``: Time the caller has been blocked writing batches and flushing. With
+          ``pipelined`` or ``parallelism`` only handing over batches blocks.
+        * ``execute_ns``: Time spent filling chunks and executing the insert statement, summed
+          over all connections. Divide by ``chunks`` to get the time per chunk.
+        * ``commit_ns``: Time spent committing, summed over all connections.
+
+        Durations are in nanoseconds.
+        """
+        with self._lock:
+            lib.arrow_odbc_writer_stats(self.handle, self._stats)
+            return stats_to_dict(self._stats)
 
 def insert_into_table(
     reader: Any,
@@ -56,6 +185,11 @@ def insert_into_table(
     connection_string: str,
     user: Optional[str] = None,
     password: Optional[str] = None,
+    pipelined: bool = False,
+    parallelism: int = 1,
+    commit_every: Optional[int] = None,
+    method: str = "insert",
+    stats_callback: Optional[Callable[[Dict[str, int]], None]] = None,
 ):
     """
     Consume the batches in the reader and insert them into a table on the database.
@@ -75,7 +209,92 @@ def insert_into_table(
     :param password: Allows for specifying the password seperatly from the connection string if it
         is not already part of it. The value will eventually be escaped and attached to the
         connection string as `PWD`.
+    :param pipelined: If ``True`` batches are converted and sent to the database by a dedicated
+        system thread, while your code is producing the next batch (e.g. reading it from a file or
+        another data source). The price is the memory for one additional batch in transit. Errors
+        are raised by the write following the failed one, or at the latest once all batches are
+        written. Default is ``False``.
+    :param parallelism: Number of connections opened to the database. Batches are distributed
+        round-robin over them, each connection inserting on its own system thread (so this implies
+        ``pipelined``). Many data warehouses scale ingest with the number of concurrent sessions.
+        Each connection commits the chunks it inserts independently of the other ones. Rows are
+        not inserted in the order of the batches. Default is ``1``.
+    :param commit_every: ``None`` leaves commits to the autocommit mode of the driver, which
+        usually means every chunk is committed once it is inserted. Committing causes the database
+        to flush its log, so inserting many small chunks may be dominated by commits. A positive
+        number turns autocommit off and commits once this many chunks have been inserted, no matter
+        how the batches are sized. ``0`` inserts all rows in a single transaction. In both cases the
+        remaining rows are committed once all batches are written, and the current transaction is
+        rolled back in case of an error. With ``parallelism`` each connection commits its own
+        transactions. Default is ``None``.
+    :param method: ``"insert"`` binds the columns as arrays of parameters to a plain ``INSERT``
+        statement. ``"bulk"`` asks the driver for the database management system and adds its hints
+        for large inserts to the statement. The rows are still sent as arrays of parameters, this
+        is not the bulk copy interface of the driver. On Microsoft SQL Server this takes a table
+        lock (``WITH (TABLOCK)``), on Oracle this performs a direct path insert
+        (``APPEND_VALUES``), which requires each chunk to be committed before the next one is
+        inserted. So ``"bulk"`` can neither be combined with ``commit_every``, nor with a
+        ``parallelism`` larger than ``1``. Any other database management system is inserted into
+        like with ``"insert"``. Default is ``"insert"``.
+    :param stats_callback: Called with the ``stats`` of the writer after each batch and once more
+        after all rows are inserted, e.g. to choose ``chunk_size`` from the time spent per chunk.
+        Default is ``None``.
+    """
+    writer = _make_table_writer(
+        reader.schema,
+        chunk_size,
+        table,
+        connection_string,
+        user,
+        password,
+        pipelined,
+        parallelism,
+        commit_every,
+        method,
+    )
+
+    # Write all batches in reader
+    for batch in reader:
+        writer.write_batch(batch)
+        if stats_callback is not None:
+            stats_callback(writer.stats)
+    writer.flush()
+    if stats_callback is not None:
+        stats_callback(writer.stats)
+
+
+def _make_table_writer(
+    schema,
+    chunk_size: int,
+    table: str,
+    connection_string: str,
+    user: Optional[str],
+    password: Optional[str],
+    pipelined: bool,
+    parallelism: int,
+    commit_every: Optional[int],
+    method: str,
+) -> BatchWriter:
     """
+    Connects to the database and creates the writer used by ``insert_into_table``.
+    """
+    if parallelism < 1:
+        raise ValueError("parallelism must be at least 1.")
+
+    if method not in ("insert", "bulk"):
+        raise ValueError(f'method must be "insert" or "bulk", not "{method}".')
+    bulk = method == "bulk"
+    if bulk and commit_every is not None:
+        raise ValueError('method="bulk" can not be combined with commit_every.')
+    if bulk and parallelism != 1:
+        raise ValueError('method="bulk" can not be combined with parallelism.')
+
+    if commit_every is not None and commit_every < 0:
+        raise ValueError("commit_every must not be negative.")
+    autocommit = commit_every is None
+    if commit_every is None:
+        commit_every = 0
+
     table_bytes = table.encode("utf-8")
 
     # Allocate structures where we will export the Array data and the Array schema. They will be
@@ -85,23 +304,282 @@ def insert_into_table(
         c_schema_ptr = int(arrow_ffi.cast("uintptr_t", c_schema))
 
         # Export the schema to the C Data structures.
+        schema._export_to_c(c_schema_ptr)
+
+        writer_out = ffi.new("ArrowOdbcWriter **")
+
+        if parallelism == 1:
+            connection = connect_to_database(connection_string, user, password)
+
+            # Connecting to the database has been successful. Note that connection does not truly
+            # take ownership of the connection. If it runs out of scope (e.g. due to a raised
+            # exception) the connection would not be closed and its associated resources would not
+            # be freed. However `arrow_odbc_writer_make` will take ownership of connection. Even if
+            # it should fail the connection will be closed.
+
+            error = lib.arrow_odbc_writer_make(
+                connection,
+                table_bytes,
+                len(table_bytes),
+                chunk_size,
+                c_schema,
+                pipelined,
+                autocommit,
+                commit_every,
+                bulk,
+                writer_out,
+            )
+        else:
+            connections = []
+            try:
+                for _ in range(parallelism):
+                    connections.append(connect_to_database(connection_string, user, password))
+            except:
+                # Connections not yet passed to arrow_odbc_writer_make_parallel must be freed by us.
+                for connection in connections:
+                    lib.arrow_odbc_connection_free(connection)
+                raise
+            connections_array = ffi.new("OdbcConnection *[]", connections)
+
+            error = lib.arrow_odbc_writer_make_parallel(
+                connections_array,
+                parallelism,
+                table_bytes,
+                len(table_bytes),
+                chunk_size,
+                c_schema,
+                autocommit,
+                commit_every,
+                bulk,
+                writer_out,
+            )
+        raise_on_error(error)
+        return BatchWriter(writer_out[0])
+
+
+async def insert_into_table_async(
+    reader: Any,
+    chunk_size: int,
+    table: str,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    commit_every: Optional[int] = None,
+    method: str = "insert",
+    stats_callback: Optional[Callable[[Dict[str, int]], None]] = None,
+):
+    """
+    Like ``insert_into_table``, but without blocking the event loop while rows are sent to the
+    database. Batches are inserted by a dedicated system thread, like with ``pipelined=True``.
+    Waiting for it to accept the next batch lets the event loop run other tasks, so one event loop
+    can drive many loads without a thread pool. Connecting to the database runs in the default
+    executor of the event loop.
+
+    :param reader: Must expose a ``schema`` attribute, referencing an Arrow schema. Batches are
+        consumed with ``async for`` if the reader supports it, e.g. a ``BatchReader`` fetching
+        concurrently, otherwise with a plain ``for`` loop.
+
+    All other parameters are the same as for ``insert_into_table``.
+    """
+    loop = asyncio.get_running_loop()
+    writer = await loop.run_in_executor(
+        None,
+        lambda: _make_table_writer(
+            reader.schema,
+            chunk_size,
+            table,
+            connection_string,
+            user,
+            password,
+            True,
+            1,
+            commit_every,
+            method,
+        ),
+    )
+
+    async def write(batch):
+        await writer.write_batch_async(batch)
+        if stats_callback is not None:
+            stats_callback(writer.stats)
+
+    if hasattr(reader, "__aiter__"):
+        async for batch in reader:
+            await write(batch)
+    else:
+        for batch in reader:
+            await write(batch)
+    await writer.flush_async()
+    if stats_callback is not None:
+        stats_callback(writer.stats)
+
+
+def parquet_to_odbc(
+    path: Union[str, os.PathLike],
+    chunk_size: int,
+    table: str,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    batch_size: Optional[int] = None,
+    decode_threads: Optional[int] = None,
+    pipelined: bool = False,
+    parallelism: int = 1,
+    commit_every: Optional[int] = None,
+    method: str = "insert",
+    stats_callback: Optional[Callable[[Dict[str, int]], None]] = None,
+) -> int:
+    """
+    Insert the rows of a Parquet file into a table on the database. This is equivalent to passing
+    the batches of a ``pyarrow.parquet.ParquetFile`` to ``insert_into_table``, yet they never reach
+    Python. The file is decoded by native system threads, each one decoding a share of the row
+    groups, and the GIL is released for the entire load. Rows are not inserted in the order of the
+    file.
+
+    :param path: Path of the Parquet file. The names of its columns must match the column names of
+        ``table``.
+    :param batch_size: Maximum number of rows in each decoded batch. ``None`` uses ``chunk_size``.
+    :param decode_threads: Number of system threads decoding row groups. Files with fewer row groups
+        use fewer threads. ``None`` uses the number of CPUs.
+    :param stats_callback: Called with the ``stats`` of the writer once all rows are inserted.
+    :return: Number of rows inserted.
+
+    All other parameters are the same as for ``insert_into_table``.
+    """
+    if batch_size is None:
+        batch_size = chunk_size
+
+    if decode_threads is None:
+        decode_threads = os.cpu_count() or 1
+    if decode_threads < 1:
+        raise ValueError("decode_threads must be at least 1.")
+
+    path_bytes = os.fsencode(path)
+
+    schema_out = arrow_ffi.new("struct ArrowSchema *")
+    error = lib.arrow_odbc_parquet_schema(path_bytes, len(path_bytes), schema_out)
+    raise_on_error(error)
+    schema = Schema._import_from_c(int(ffi.cast("uintptr_t", schema_out)))
+
+    writer = _make_table_writer(
+        schema,
+        chunk_size,
+        table,
+        connection_string,
+        user,
+        password,
+        pipelined,
+        parallelism,
+        commit_every,
+        method,
+    )
+
+    rows = writer.write_parquet(path, batch_size, decode_threads)
+    writer.flush()
+    if stats_callback is not None:
+        stats_callback(writer.stats)
+
+    return rows
+
+
+def arrow_ipc_to_odbc(
+    path: Union[str, os.PathLike],
+    chunk_size: int,
+    table: str,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+    pipelined: bool = False,
+    parallelism: int = 1,
+    commit_every: Optional[int] = None,
+    method: str = "insert",
+    stats_callback: Optional[Callable[[Dict[str, int]], None]] = None,
+) -> int:
+    """
+    Insert the rows of an Arrow IPC file, also known as Feather V2, into a table on the database.
+    Like ``parquet_to_odbc`` the batches never reach Python. The next batch is decoded by a native
+    system thread, while the previous one is inserted.
+
+    :param path: Path of the Arrow IPC file. The names of its columns must match the column names
+        of ``table``.
+    :param stats_callback: Called with the ``stats`` of the writer once all rows are inserted.
+    :return: Number of rows inserted.
+
+    All other parameters are the same as for ``insert_into_table``.
+    """
+    # Only reads the footer of the file.
+    with open(path, "rb") as file:
+        schema = ipc.open_file(file).schema
+
+    writer = _make_table_writer(
+        schema,
+        chunk_size,
+        table,
+        connection_string,
+        user,
+        password,
+        pipelined,
+        parallelism,
+        commit_every,
+        method,
+    )
+
+    rows = writer.write_ipc(path)
+    writer.flush()
+    if stats_callback is not None:
+        stats_callback(writer.stats)
+
+    return rows
+
+
+def execute_with_arrow_parameters(
+    statement: str,
+    reader: Any,
+    chunk_size: int,
+    connection_string: str,
+    user: Optional[str] = None,
+    password: Optional[str] = None,
+):
+    """
+    Execute the statement once for each row in the batches of the reader. The columns are bound as
+    arrays of parameters to the placeholders (``?``) of the statement, in order. Up to
+    ``chunk_size`` rows are sent to the data source in a single round trip. Use this to e.g. delete
+    or update many rows identified by an Arrow table, without a loop in Python executing the
+    statement for each of them.
+
+    :param statement: SQL statement with one placeholder for each column of the reader, e.g.
+        ``DELETE FROM MyTable WHERE id = ?``. Any result sets produced by the statement are
+        discarded.
+    :param reader: Reader is used to iterate over record batches. It must expose a `schema`
+        attribute, referencing an Arrow schema. The fields of the schema are bound to the
+        placeholders in order, their names are ignored.
+    :param chunk_size: Number of rows sent to the data source in each roundtrip. Independent of
+        batch size (i.e. number of rows in an individual record batch).
+    :param connection_string: ODBC Connection string used to connect to the data source. To find a
+        connection string for your data source try https://www.connectionstrings.com/.
+    :param user: Allows for specifying the user seperatly from the connection string if it is not
+        already part of it. The value will eventually be escaped and attached to the connection
+        string as `UID`.
+    :param password: Allows for specifying the password seperatly from the connection string if it
+        is not already part of it. The value will eventually be escaped and attached to the
+        connection string as `PWD`.
+    """
+    statement_bytes = statement.encode("utf-8")
+
+    with arrow_ffi.new("struct ArrowSchema*") as c_schema:
+        c_schema_ptr = int(arrow_ffi.cast("uintptr_t", c_schema))
         reader.schema._export_to_c(c_schema_ptr)
 
         connection = connect_to_database(connection_string, user, password)
 
-        # Connecting to the database has been successful. Note that connection does not truly take
-        # ownership of the connection. If it runs out of scope (e.g. due to a raised exception) the
-        # connection would not be closed and its associated resources would not be freed. However
-        # `arrow_odbc_writer_make` will take ownership of connection. Even if it should fail the
-        # connection will be closed.
-
+        # Takes ownership of the connection, even in case of an error.
         writer_out = ffi.new("ArrowOdbcWriter **")
-        lib.arrow_odbc_writer_make(
-            connection, table_bytes, len(table_bytes), chunk_size, c_schema, writer_out
+        error = lib.arrow_odbc_writer_make_with_statement(
+            connection, statement_bytes, len(statement_bytes), chunk_size, c_schema, writer_out
         )
+        raise_on_error(error)
         writer = BatchWriter(writer_out[0])
 
-    # Write all batches in reader
     for batch in reader:
         writer.write_batch(batch)
-    writer.flush()
\ No newline at end of file
+    writer.flush()
@@ -0,0 +1,94 @@
+"""
+Measures how reading scales with the number of threads. Each thread runs its own reader over its
+own connection, reading the same table. Since the GIL is released while fetching, the total
+throughput should scale (almost) linearly, until the database or the network is saturated.
+
+Usage: python benchmarks/threads.py [max_threads]
+
+The connection string is taken from the environment variable ``ARROW_ODBC_BENCHMARK_CONNECTION``
+and defaults to the database of the test suite.
+"""
+
+import os
+import sys
+
+from concurrent.futures import ThreadPoolExecutor
+from subprocess import run
+from time import perf_counter
+
+import pyarrow as pa
+
+from arrow_odbc import insert_into_table, read_arrow_batches_from_odbc
+
+CONNECTION_STRING = os.environ.get(
+    "ARROW_ODBC_BENCHMARK_CONNECTION",
+    "Driver={ODBC Driver 17 for SQL Server};Server=localhost;UID=SA;PWD=My@Test@Password1;",
+)
+TABLE = "BenchmarkThreads"
+NUM_ROWS = 1_000_000
+BATCH_SIZE = 50_000
+
+
+def setup_table():
+    run(
+        [
+            "odbcsv",
+            "fetch",
+            "-c",
+            CONNECTION_STRING,
+            "-q",
+            f"DROP TABLE IF EXISTS {TABLE}; "
+            f"CREATE TABLE {TABLE} (a BIGINT NOT NULL, b FLOAT NOT NULL, c VARCHAR(20));",
+        ],
+        check=True,
+    )
+    schema = pa.schema([("a", pa.int64()), ("b", pa.float64()), ("c", pa.string())])
+
+    def batches():
+        for start in range(0, NUM_ROWS, BATCH_SIZE):
+            a = pa.array(range(start, start + BATCH_SIZE), pa.int64())
+            b = pa.array([i * 0.5 for i in range(start, start + BATCH_SIZE)], pa.float64())
+            c = pa.array([f"row {i}" for i in range(start, start + BATCH_SIZE)], pa.string())
+            yield pa.RecordBatch.from_arrays([a, b, c], schema=schema)
+
+    reader = pa.RecordBatchReader.from_batches(schema, batches())
+    insert_into_table(
+        reader=reader, chunk_size=BATCH_SIZE, table=TABLE, connection_string=CONNECTION_STRING
+    )
+
+
+def read_table() -> int:
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a, b, c FROM {TABLE}",
+        batch_size=BATCH_SIZE,
+        connection_string=CONNECTION_STRING,
+    )
+    return sum(batch.num_rows for batch in reader)
+
+
+def measure(num_threads: int) -> float:
+    """
+    Rows per second read by all threads together.
+    """
+    with ThreadPoolExecutor(max_workers=num_threads) as executor:
+        start = perf_counter()
+        futures = [executor.submit(read_table) for _ in range(num_threads)]
+        total_rows = sum(future.result() for future in futures)
+        elapsed = perf_counter() - start
+    return total_rows / elapsed
+
+
+def main():
+    max_threads = int(sys.argv[1]) if len(sys.argv) > 1 else 8
+    setup_table()
+    baseline = measure(1)
+    print("threads  rows/s        speedup")
+    num_threads = 1
+    while num_threads <= max_threads:
+        throughput = baseline if num_threads == 1 else measure(num_threads)
+        print(f"{num_threads:7}  {throughput:12.0f}  {throughput / baseline:7.2f}")
+        num_threads *= 2
+
+
+if __name__ == "__main__":
+    main()
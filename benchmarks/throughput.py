@@ -0,0 +1,254 @@
+"""
+Measures read and insert throughput against the database of ``docker-compose.yml``, across batch
+sizes, column type mixes, ``max_text_size`` settings and null densities. Each measurement is
+written as one JSON object per line, so results of different releases can be compared.
+
+Usage:
+
+    python benchmarks/throughput.py run [--rows N] [--output results.jsonl]
+    python benchmarks/throughput.py compare baseline.jsonl candidate.jsonl
+
+The connection string is taken from the environment variable ``ARROW_ODBC_BENCHMARK_CONNECTION``
+and defaults to the database of the test suite.
+"""
+
+import argparse
+import json
+import os
+import platform
+import random
+import sys
+
+from datetime import datetime, timedelta, timezone
+from decimal import Decimal
+from importlib.metadata import PackageNotFoundError, version
+from itertools import product
+from subprocess import run
+from time import perf_counter
+
+import pyarrow as pa
+
+from arrow_odbc import insert_into_table, read_arrow_batches_from_odbc
+
+CONNECTION_STRING = os.environ.get(
+    "ARROW_ODBC_BENCHMARK_CONNECTION",
+    "Driver={ODBC Driver 17 for SQL Server};Server=localhost;UID=SA;PWD=My@Test@Password1;",
+)
+
+BATCH_SIZES = [1_000, 10_000, 100_000]
+NULL_DENSITIES = [0.0, 0.5]
+# Only applied to mixes with variadic text columns.
+MAX_TEXT_SIZES = [None, 128]
+# Number of columns of each mix
+NUM_COLUMNS = 4
+
+
+def _numeric(index: int, rng: random.Random):
+    return index
+
+
+def _text(index: int, rng: random.Random):
+    return f"value {index} " + "x" * rng.randrange(0, 60)
+
+
+def _timestamp(index: int, rng: random.Random):
+    return datetime(2020, 1, 1) + timedelta(seconds=index, microseconds=rng.randrange(1_000_000))
+
+
+def _decimal(index: int, rng: random.Random):
+    return Decimal(index) / 100
+
+
+# Column type mixes: SQL type of each column, its Arrow type and a generator for its values.
+MIXES = {
+    "narrow_numeric": ("BIGINT", pa.int64(), _numeric),
+    "wide_text": ("VARCHAR(4000)", pa.string(), _text),
+    "timestamps": ("DATETIME2(6)", pa.timestamp("us"), _timestamp),
+    "decimals": ("DECIMAL(18,2)", pa.decimal128(18, 2), _decimal),
+}
+
+
+def table_name(mix: str, null_density: float) -> str:
+    return f"BenchmarkThroughput_{mix}_{int(null_density * 100)}"
+
+
+def create_table(table: str, sql_type: str):
+    columns = ", ".join(f"c{i} {sql_type}" for i in range(NUM_COLUMNS))
+    run(
+        [
+            "odbcsv",
+            "fetch",
+            "-c",
+            CONNECTION_STRING,
+            "-q",
+            f"DROP TABLE IF EXISTS {table}; CREATE TABLE {table} ({columns});",
+        ],
+        check=True,
+    )
+
+
+def make_batches(mix: str, null_density: float, num_rows: int, batch_size: int):
+    _sql_type, arrow_type, generate = MIXES[mix]
+    schema = pa.schema([(f"c{i}", arrow_type) for i in range(NUM_COLUMNS)])
+    # Same data for every run, so results are comparable.
+    rng = random.Random(42)
+    batches = []
+    for start in range(0, num_rows, batch_size):
+        stop = min(start + batch_size, num_rows)
+        columns = [
+            pa.array(
+                [
+                    None if rng.random() < null_density else generate(index, rng)
+                    for index in range(start, stop)
+                ],
+                arrow_type,
+            )
+            for _ in range(NUM_COLUMNS)
+        ]
+        batches.append(pa.RecordBatch.from_arrays(columns, schema=schema))
+    return schema, batches
+
+
+def measure_insert(table: str, schema, batches, chunk_size: int) -> float:
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+    start = perf_counter()
+    insert_into_table(
+        reader=reader, chunk_size=chunk_size, table=table, connection_string=CONNECTION_STRING
+    )
+    return perf_counter() - start
+
+
+def measure_read(table: str, batch_size: int, max_text_size):
+    """
+    Elapsed time, number of rows and size in bytes of the batches read.
+    """
+    start = perf_counter()
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT * FROM {table}",
+        batch_size=batch_size,
+        connection_string=CONNECTION_STRING,
+        max_text_size=max_text_size,
+    )
+    num_rows = 0
+    num_bytes = 0
+    for batch in reader:
+        num_rows += batch.num_rows
+        num_bytes += batch.nbytes
+    return perf_counter() - start, num_rows, num_bytes
+
+
+def run_benchmarks(num_rows: int, output):
+    environment = {
+        "arrow_odbc": _package_version("arrow-odbc"),
+        "pyarrow": pa.__version__,
+        "python": platform.python_version(),
+        "machine": platform.machine(),
+        "started": datetime.now(timezone.utc).isoformat(),
+    }
+
+    def emit(record: dict):
+        output.write(json.dumps({**record, **environment}) + "\n")
+        output.flush()
+
+    for mix, null_density in product(MIXES, NULL_DENSITIES):
+        sql_type = MIXES[mix][0]
+        table = table_name(mix, null_density)
+        create_table(table, sql_type)
+        schema, batches = make_batches(mix, null_density, num_rows, max(BATCH_SIZES))
+        num_bytes = sum(batch.nbytes for batch in batches)
+        # The table is filled by the insert with the largest chunk size, the smaller ones insert
+        # into a fresh table each.
+        for chunk_size in sorted(BATCH_SIZES):
+            create_table(table, sql_type)
+            elapsed = measure_insert(table, schema, batches, chunk_size)
+            emit(
+                {
+                    "operation": "insert",
+                    "mix": mix,
+                    "null_density": null_density,
+                    "batch_size": chunk_size,
+                    "max_text_size": None,
+                    "rows": num_rows,
+                    "seconds": elapsed,
+                    "rows_per_second": num_rows / elapsed,
+                    "megabytes_per_second": num_bytes / elapsed / 1e6,
+                }
+            )
+
+        max_text_sizes = MAX_TEXT_SIZES if pa.types.is_string(MIXES[mix][1]) else [None]
+        for batch_size, max_text_size in product(BATCH_SIZES, max_text_sizes):
+            elapsed, rows_read, bytes_read = measure_read(table, batch_size, max_text_size)
+            emit(
+                {
+                    "operation": "read",
+                    "mix": mix,
+                    "null_density": null_density,
+                    "batch_size": batch_size,
+                    "max_text_size": max_text_size,
+                    "rows": rows_read,
+                    "seconds": elapsed,
+                    "rows_per_second": rows_read / elapsed,
+                    "megabytes_per_second": bytes_read / elapsed / 1e6,
+                }
+            )
+
+
+def _package_version(name: str):
+    try:
+        return version(name)
+    except PackageNotFoundError:
+        return None
+
+
+def _key(record: dict):
+    return tuple(
+        record[field]
+        for field in ("operation", "mix", "null_density", "batch_size", "max_text_size")
+    )
+
+
+def _load(path: str) -> dict:
+    with open(path) as file:
+        return {_key(record): record for record in map(json.loads, file)}
+
+
+def compare(baseline_path: str, candidate_path: str):
+    """
+    Prints the throughput of the candidate relative to the baseline for each measurement both of
+    them contain. Values below 1 indicate a regression.
+    """
+    baseline = _load(baseline_path)
+    candidate = _load(candidate_path)
+    print("operation  mix             nulls  batch_size  max_text  rows/s candidate  ratio")
+    for key in sorted(baseline.keys() & candidate.keys(), key=str):
+        operation, mix, null_density, batch_size, max_text_size = key
+        ratio = candidate[key]["rows_per_second"] / baseline[key]["rows_per_second"]
+        print(
+            f"{operation:9}  {mix:14}  {null_density:5.2f}  {batch_size:10}  "
+            f"{str(max_text_size):8}  {candidate[key]['rows_per_second']:16.0f}  {ratio:5.2f}"
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+    run_parser = commands.add_parser("run", help="Measure throughput")
+    run_parser.add_argument("--rows", type=int, default=200_000, help="Rows per table")
+    run_parser.add_argument("--output", help="File the results are appended to. Default: stdout")
+    compare_parser = commands.add_parser("compare", help="Compare two result files")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("candidate")
+    args = parser.parse_args()
+
+    if args.command == "run":
+        if args.output is None:
+            run_benchmarks(args.rows, sys.stdout)
+        else:
+            with open(args.output, "a") as output:
+                run_benchmarks(args.rows, output)
+    else:
+        compare(args.baseline, args.candidate)
+
+
+if __name__ == "__main__":
+    main()
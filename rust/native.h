@@ -13,6 +13,13 @@ typedef struct ArrowOdbcError ArrowOdbcError;
  */
 typedef struct ArrowOdbcParameter ArrowOdbcParameter;
 
+/**
+ * Opaque type holding a prepared query and the connection it has been prepared on. It can be
+ * executed many times with different parameters, without the data source parsing and planning
+ * it again.
+ */
+typedef struct ArrowOdbcPreparedQuery ArrowOdbcPreparedQuery;
+
 /**
  * Opaque type holding all the state associated with an ODBC reader implementation in Rust. This
  * type also has ownership of the ODBC Connection handle.
@@ -30,6 +37,238 @@ typedef struct ArrowOdbcWriter ArrowOdbcWriter;
  */
 typedef struct OdbcConnection OdbcConnection;
 
+/**
+ * An integer valued statement or connection attribute, e.g. `SQL_ATTR_MAX_LENGTH` or a driver
+ * specific one controlling how many rows are prefetched.
+ */
+typedef struct ArrowOdbcAttribute {
+  /**
+   * ODBC constant identifying the attribute, e.g. `3` for `SQL_ATTR_MAX_LENGTH`.
+   */
+  int32_t attribute;
+  intptr_t value;
+} ArrowOdbcAttribute;
+
+/**
+ * Options of [`arrow_odbc_reader_make`], besides the query and its parameters. Options which
+ * can not be combined are rejected by it with an error.
+ */
+typedef struct ArrowOdbcReaderOptions {
+  /**
+   * Optional upper bound for the size of text columns. Use `0` to indicate that no uppper bound
+   * applies.
+   */
+  uintptr_t max_text_size;
+  /**
+   * Optional upper bound for the size of binary columns. Use `0` to indicate that no uppper
+   * bound applies.
+   */
+  uintptr_t max_binary_size;
+  /**
+   * `TRUE` if allocations should return an error, `FALSE` if it is fine to abort the process.
+   * Enabling might have a performance overhead, so it might be desirable to disable it, if you
+   * know there is enough memory available.
+   */
+  bool fallibale_allocations;
+  /**
+   * Upper bound for the size of the buffers bound to the cursor. If the rows of `batch_size`
+   * would not fit, the number of rows per batch is reduced accordingly. Use `0` to indicate
+   * that no upper bound applies.
+   */
+  uintptr_t max_bytes_per_batch;
+  /**
+   * `TRUE` if batches should be fetched by a dedicated system thread, while the caller is still
+   * processing the previous one. `FALSE` to fetch a batch then it is requested by
+   * [`arrow_odbc_reader_next`].
+   */
+  bool fetch_concurrently;
+  /**
+   * Maximum number of batches fetched ahead of the caller, if fetching concurrently. The fetch
+   * thread blocks once this many batches are waiting to be consumed. Ignored if
+   * `fetch_concurrently` is `FALSE`. `0` is treated like `1`.
+   */
+  uintptr_t prefetch_depth;
+  /**
+   * `TRUE` to hand the buffers bound to the cursor over to the batch, rather than copying their
+   * values. Only has an effect, if all columns of the result set are non nullable integers,
+   * floating points, dates or timestamps, otherwise the values are copied as usual. Dates and
+   * timestamps are converted from the structs ODBC uses by vectorized kernels.
+   */
+  bool zero_copy;
+  /**
+   * Size of the buffers text columns are first fetched into. As long as the first batch holds
+   * values which may not fit, the query is executed again with buffers of twice the size, up to
+   * `max_text_size`, or up to the octet length declared for the columns which did not fit. The
+   * remaining batches are fetched with the buffers the first batch fits in. Should a value of a
+   * later batch not fit, fetching that batch fails. Use `0` to size the buffers from the column
+   * sizes reported by the driver instead. `zero_copy` is ignored otherwise.
+   */
+  uintptr_t initial_text_size;
+  /**
+   * Text and binary columns larger than this, or of unknown size, are retrieved in chunks with
+   * `SQLGetData`, rather than being bound to buffers holding their largest possible value for
+   * every row. If the driver reports `SQL_GD_BLOCK` for `SQL_GETDATA_EXTENSIONS`, the other
+   * columns are bound and fetched in blocks of rows. Otherwise result sets with such a column
+   * are fetched one row at a time. Columns of types which can not be retrieved with
+   * `SQLGetData`, e.g. decimals, cause an error, unless `schema` maps them to a supported type.
+   * Use `0` to bind all columns. Can not be combined with `initial_text_size`.
+   */
+  uintptr_t lob_threshold;
+  /**
+   * Optional pointer to an arrow schema, which is used for the batches instead of the one
+   * inferred from the column types reported by the driver. It must have one field for each
+   * column of the result set. The driver converts the values to the C types matching the
+   * fields, so e.g. IDs declared as `DECIMAL(38,0)` can be fetched as `Int64`. `NULL` to infer
+   * the schema.
+   */
+  const void *schema;
+  /**
+   * Memory of released Arrow buffers retained by the reader, so later batches can reuse it,
+   * rather than allocating new buffers. Only has an effect, if the values are fetched with
+   * `zero_copy`. Use `0` to allocate the buffers of each batch from the global allocator.
+   */
+  uintptr_t buffer_pool_bytes;
+  /**
+   * `TRUE` to fetch all result sets produced by the query, e.g. a stored procedure or a batch of
+   * several statements. Use [`arrow_odbc_reader_next_result_set`] to advance to the next one.
+   * Columns of types which can not be retrieved with `SQLGetData`, e.g. decimals, are returned
+   * as text. Values are retrieved with `SQLGetData` one row at a time, so this can not be
+   * combined with `max_text_size`, `max_binary_size`, `max_bytes_per_batch`,
+   * `fetch_concurrently`, `zero_copy`, `initial_text_size`, `lob_threshold`, `schema` or
+   * `initial_batch_size`.
+   */
+  bool more_results;
+  /**
+   * Optional pointer to an array of integer valued statement attributes, e.g.
+   * `SQL_ATTR_MAX_LENGTH` or driver specific ones. They are set in the order given, before the
+   * query is executed. If there are any, the query is prepared before executing it and the
+   * values are fetched into bound buffers. So they can not be combined with `zero_copy`,
+   * `lob_threshold` or `initial_batch_size`. `NULL` for no attributes.
+   */
+  const struct ArrowOdbcAttribute *statement_attributes;
+  /**
+   * Number of elements in `statement_attributes`.
+   */
+  uintptr_t statement_attributes_len;
+  /**
+   * Optional pointer to an array of integer valued connection attributes, e.g.
+   * `SQL_ATTR_CONNECTION_TIMEOUT`. They are set in the order given, before the query is
+   * executed. Attributes which must be set before connecting, like `SQL_ATTR_PACKET_SIZE`, are
+   * rejected by most drivers and belong into the connection string. `NULL` for no attributes.
+   */
+  const struct ArrowOdbcAttribute *connection_attributes;
+  /**
+   * Number of elements in `connection_attributes`.
+   */
+  uintptr_t connection_attributes_len;
+  /**
+   * Number of rows of the first batch. Each following batch has twice as many rows, until
+   * `batch_size` is reached. Consumers see the first rows sooner and small result sets do not
+   * allocate buffers for a full batch. With `zero_copy` or large columns the buffers of each
+   * batch are allocated for its size. Otherwise the smaller batches are retrieved row by row,
+   * before buffers for `batch_size` rows are bound, unless the result set has columns which can
+   * not be retrieved with `SQLGetData`. Batches retrieved row by row have at most 1024 rows,
+   * buffers are bound once the next batch would be larger. `0` to start with `batch_size` rows.
+   * Can not be combined with `initial_text_size`.
+   */
+  uintptr_t initial_batch_size;
+} ArrowOdbcReaderOptions;
+
+/**
+ * Cumulative counters of a reader, since it has been created. Durations are in nanoseconds.
+ */
+typedef struct ArrowOdbcReaderStats {
+  /**
+   * Number of batches handed out.
+   */
+  uint64_t batches;
+  /**
+   * Number of rows in the batches handed out.
+   */
+  uint64_t rows;
+  /**
+   * Memory occupied by the arrays of the batches handed out.
+   */
+  uint64_t bytes;
+  /**
+   * Estimated size of the buffers bound to the cursor. `0` if the reader does not bind buffers,
+   * or their size is not known.
+   */
+  uint64_t buffer_bytes;
+  /**
+   * Time spent fetching batches. Most strategies convert the values into Arrow arrays while
+   * fetching, so this includes the conversion done by `arrow-odbc`. With concurrent fetching
+   * this is the time spent waiting for the fetch thread.
+   */
+  uint64_t fetch_ns;
+  /**
+   * Time spent converting batches after they have been fetched, i.e. dictionary encoding.
+   */
+  uint64_t conversion_ns;
+  /**
+   * Time spent exporting batches over the C Data Interface.
+   */
+  uint64_t export_ns;
+  /**
+   * Memory held by the buffer pool of the reader, including buffers of batches not yet released
+   * by the consumer. `0` if the reader does not allocate from a pool.
+   */
+  uint64_t pool_bytes;
+  /**
+   * Number of Arrow buffers which reused the memory of buffers released by the consumer.
+   */
+  uint64_t pool_reuses;
+} ArrowOdbcReaderStats;
+
+/**
+ * Cumulative counters of a writer, since it has been created. Durations are in nanoseconds.
+ */
+typedef struct ArrowOdbcWriterStats {
+  /**
+   * Number of batches passed to the writer.
+   */
+  uint64_t batches;
+  /**
+   * Number of rows in the batches passed to the writer.
+   */
+  uint64_t rows;
+  /**
+   * Memory occupied by the arrays of the batches passed to the writer.
+   */
+  uint64_t bytes;
+  /**
+   * Number of chunks sent to the database.
+   */
+  uint64_t chunks;
+  /**
+   * Time spent importing batches over the C Data Interface.
+   */
+  uint64_t import_ns;
+  /**
+   * Time the caller has been blocked writing batches and flushing. Pipelined and parallel
+   * writers only block while handing over batches.
+   */
+  uint64_t write_ns;
+  /**
+   * Time spent filling the chunks and executing the insert statement, summed over all
+   * connections of the writer. Divide by `chunks` to get the time per chunk.
+   */
+  uint64_t execute_ns;
+  /**
+   * Time spent committing transactions, summed over all connections of the writer.
+   */
+  uint64_t commit_ns;
+} ArrowOdbcWriterStats;
+
+/**
+ * Enables connection pooling by the ODBC driver manager. Connections are no longer closed then
+ * they are freed, but returned to a pool. Later requests to connect with an identical connection
+ * string reuse a connection from the pool, rather than establishing a new one.
+ *
+ * Must be called before the first connection is opened, otherwise an error is returned.
+ */
+struct ArrowOdbcError *arrow_odbc_enable_connection_pooling(void);
+
 /**
  * Allocate and open an ODBC connection using the specified connection string. In case of an error
  * this function returns a NULL pointer.
@@ -48,6 +287,16 @@ struct ArrowOdbcError *arrow_odbc_connect_with_connection_string(const uint8_t *
                                                                  uintptr_t password_len,
                                                                  struct OdbcConnection **connection_out);
 
+/**
+ * Closes the connection and frees its associated resources. Only required for connections which
+ * have not been passed to a function taking ownership of them.
+ *
+ * # Safety
+ *
+ * `connection` must point to a valid OdbcConnection.
+ */
+void arrow_odbc_connection_free(struct OdbcConnection *connection);
+
 /**
  * Deallocates the resources associated with an error.
  *
@@ -76,6 +325,171 @@ const char *arrow_odbc_error_message(const struct ArrowOdbcError *error);
 struct ArrowOdbcParameter *arrow_odbc_parameter_string_make(const uint8_t *char_buf,
                                                             uintptr_t char_len);
 
+/**
+ * # Safety
+ *
+ * `binary_buf` must point to at least `binary_len` bytes. This function does not take ownership
+ * of the buffer. It must at least be valid until the call make reader is finished.
+ */
+struct ArrowOdbcParameter *arrow_odbc_parameter_binary_make(const uint8_t *binary_buf,
+                                                            uintptr_t binary_len);
+
+/**
+ * Creates a parameter bound as 64 bit integer.
+ */
+struct ArrowOdbcParameter *arrow_odbc_parameter_int64_make(int64_t value);
+
+/**
+ * Creates a parameter bound as 64 bit floating point.
+ */
+struct ArrowOdbcParameter *arrow_odbc_parameter_float64_make(double value);
+
+/**
+ * Creates a parameter bound as timestamp. `fraction` is the fractional part of the second in
+ * nanoseconds.
+ */
+struct ArrowOdbcParameter *arrow_odbc_parameter_timestamp_make(int16_t year,
+                                                               uint16_t month,
+                                                               uint16_t day,
+                                                               uint16_t hour,
+                                                               uint16_t minute,
+                                                               uint16_t second,
+                                                               uint32_t fraction);
+
+/**
+ * Frees a parameter, which has not been passed to a function taking ownership of it, e.g. because
+ * creating the parameters following it failed.
+ *
+ * # Safety
+ *
+ * `parameter` must point to a valid parameter, created by one of the
+ * `arrow_odbc_parameter_*_make` functions.
+ */
+void arrow_odbc_parameter_free(struct ArrowOdbcParameter *parameter);
+
+/**
+ * Arrow schema of the batches decoded from a Parquet file. Used to create a writer for
+ * [`arrow_odbc_writer_write_parquet`], as the schema inferred by other implementations may
+ * differ, e.g. for files written without an embedded Arrow schema.
+ *
+ * # Safety
+ *
+ * * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+ * * `path_len` describes the len of `path_buf` in bytes.
+ * * `schema_out` must point to a valid `FFI_ArrowSchema`, which is overwritten.
+ */
+struct ArrowOdbcError *arrow_odbc_parquet_schema(const uint8_t *path_buf,
+                                                 uintptr_t path_len,
+                                                 void *schema_out);
+
+/**
+ * Decodes a Parquet file and passes its batches to the writer. Row groups are decoded by
+ * `num_threads` system threads, while the calling thread hands the batches to the writer. The
+ * batches never leave Rust, so they do not need to be imported over the C Data Interface. The
+ * writer is not flushed.
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`crate::arrow_odbc_writer_make`] or
+ *   [`crate::arrow_odbc_writer_make_parallel`] with the schema reported by
+ *   [`arrow_odbc_parquet_schema`].
+ * * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+ * * `path_len` describes the len of `path_buf` in bytes.
+ * * `batch_size` maximum number of rows in each decoded batch.
+ * * `num_threads` number of threads decoding row groups. `0` is treated like `1`.
+ * * `rows_out` in case of success this will hold the number of rows passed to the writer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_write_parquet(struct ArrowOdbcWriter *writer,
+                                                       const uint8_t *path_buf,
+                                                       uintptr_t path_len,
+                                                       uintptr_t batch_size,
+                                                       uintptr_t num_threads,
+                                                       uint64_t *rows_out);
+
+/**
+ * Decodes an Arrow IPC file and passes its batches to the writer. The next batch is decoded by a
+ * dedicated system thread, while the calling thread hands the previous one to the writer. The
+ * writer is not flushed.
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`crate::arrow_odbc_writer_make`] or
+ *   [`crate::arrow_odbc_writer_make_parallel`] with the schema of the file.
+ * * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+ * * `path_len` describes the len of `path_buf` in bytes.
+ * * `rows_out` in case of success this will hold the number of rows passed to the writer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_write_ipc(struct ArrowOdbcWriter *writer,
+                                                   const uint8_t *path_buf,
+                                                   uintptr_t path_len,
+                                                   uint64_t *rows_out);
+
+/**
+ * Prepares a query for repeated execution.
+ *
+ * Takes ownership of connection even in case of an error.
+ *
+ * # Safety
+ *
+ * * `connection` must point to a valid OdbcConnection. This function takes ownership of the
+ *   connection, even in case of an error. So The connection must not be freed explicitly
+ *   afterwards.
+ * * `query_buf` must point to a valid utf-8 string
+ * * `query_len` describes the len of `query_buf` in bytes.
+ * * `batch_size` maximum number of rows in each batch.
+ * * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+ *   uppper bound applies.
+ * * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+ *   that no uppper bound applies.
+ * * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+ *   to abort the process.
+ * * `prepared_out` in case of success this will point to an instance of
+ *   `ArrowOdbcPreparedQuery`. Ownership is transferred to the caller.
+ */
+struct ArrowOdbcError *arrow_odbc_prepared_query_make(struct OdbcConnection *connection,
+                                                      const uint8_t *query_buf,
+                                                      uintptr_t query_len,
+                                                      uintptr_t batch_size,
+                                                      uintptr_t max_text_size,
+                                                      uintptr_t max_binary_size,
+                                                      bool fallibale_allocations,
+                                                      struct ArrowOdbcPreparedQuery **prepared_out);
+
+/**
+ * Executes a prepared query. The result set of a previous execution becomes unavailable. Readers
+ * created for it yield an error from then on. Only the statement is reused. Column buffers are
+ * allocated and bound anew for every result set, even if its schema matches the previous one.
+ * `arrow-odbc` does not hand out the buffers owned by its reader, so they can not be kept across
+ * executions.
+ *
+ * `reader_out` is assigned a NULL pointer in case the query does not return a result set.
+ *
+ * # Safety
+ *
+ * * `prepared` must be valid non-null prepared query, allocated by
+ *   [`arrow_odbc_prepared_query_make`].
+ * * `parameters` must contain only valid pointers. This function takes ownership of all of them
+ *   independent if the function succeeds or not. Yet it does not take ownership of the array
+ *   itself.
+ * * `parameters_len` number of elements in parameters.
+ * * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
+ *   Ownership is transferred to the caller.
+ */
+struct ArrowOdbcError *arrow_odbc_prepared_query_execute(struct ArrowOdbcPreparedQuery *prepared,
+                                                         struct ArrowOdbcParameter *const *parameters,
+                                                         uintptr_t parameters_len,
+                                                         struct ArrowOdbcReader **reader_out);
+
+/**
+ * Frees the resources associated with an ArrowOdbcPreparedQuery. The connection is closed once
+ * all readers created from it are freed, too.
+ *
+ * # Safety
+ *
+ * `prepared` must point to a valid ArrowOdbcPreparedQuery.
+ */
+void arrow_odbc_prepared_query_free(struct ArrowOdbcPreparedQuery *prepared);
+
 /**
  * Creates an Arrow ODBC reader instance.
  *
@@ -89,17 +503,13 @@ struct ArrowOdbcParameter *arrow_odbc_parameter_string_make(const uint8_t *char_
  *   afterwards.
  * * `query_buf` must point to a valid utf-8 string
  * * `query_len` describes the len of `query_buf` in bytes.
+ * * `batch_size` maximum number of rows in each batch.
  * * `parameters` must contain only valid pointers. This function takes ownership of all of them
  *   independent if the function succeeds or not. Yet it does not take ownership of the array
  *   itself.
  * * `parameters_len` number of elements in parameters.
- * * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
- *   uppper bound applies.
- * * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
- *   that no uppper bound applies.
- * * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
- *   to abort the process. Enabling might have a performance overhead, so it might be desirable to
- *   disable it, if you know there is enough memory available.
+ * * `options` must point to valid options. The schema and attributes they point to are copied, so
+ *   they only need to outlive the call. Options which can not be combined cause an error.
  * * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
  *   Ownership is transferred to the caller.
  */
@@ -109,11 +519,54 @@ struct ArrowOdbcError *arrow_odbc_reader_make(struct OdbcConnection *connection,
                                               uintptr_t batch_size,
                                               struct ArrowOdbcParameter *const *parameters,
                                               uintptr_t parameters_len,
-                                              uintptr_t max_text_size,
-                                              uintptr_t max_binary_size,
-                                              bool fallibale_allocations,
+                                              const struct ArrowOdbcReaderOptions *options,
                                               struct ArrowOdbcReader **reader_out);
 
+/**
+ * Creates an Arrow ODBC reader, which executes the same query for several sets of parameters
+ * (partitions) concurrently. Each connection is used by a dedicated system thread, which executes
+ * one partition after another. The resulting reader yields the batches of all partitions. It
+ * reports the schema of the result set of the first partition executed.
+ *
+ * Takes ownership of all connections even in case of an error.
+ *
+ * # Safety
+ *
+ * * `connections` must point to an array of `connections_len` valid OdbcConnections. This
+ *   function takes ownership of all of them, even in case of an error. Yet it does not take
+ *   ownership of the array itself.
+ * * `query_buf` must point to a valid utf-8 string
+ * * `query_len` describes the len of `query_buf` in bytes.
+ * * `batch_size` maximum number of rows in each batch.
+ * * `parameters` must point to an array of `num_partitions * parameters_per_partition` valid
+ *   parameters. The parameters of the first partition come first, followed by the ones of the
+ *   second partition and so on. This function takes ownership of all of them independent if the
+ *   function succeeds or not. Yet it does not take ownership of the array itself.
+ * * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+ *   uppper bound applies.
+ * * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+ *   that no uppper bound applies.
+ * * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+ *   to abort the process.
+ * * `ordered`: `TRUE` to yield all batches of a partition, before any batch of the next one.
+ *   `FALSE` to yield batches as soon as they are fetched, regardless of the partition.
+ * * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
+ *   Ownership is transferred to the caller.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_make_partitioned(struct OdbcConnection *const *connections,
+                                                          uintptr_t connections_len,
+                                                          const uint8_t *query_buf,
+                                                          uintptr_t query_len,
+                                                          uintptr_t batch_size,
+                                                          struct ArrowOdbcParameter *const *parameters,
+                                                          uintptr_t parameters_per_partition,
+                                                          uintptr_t num_partitions,
+                                                          uintptr_t max_text_size,
+                                                          uintptr_t max_binary_size,
+                                                          bool fallibale_allocations,
+                                                          bool ordered,
+                                                          struct ArrowOdbcReader **reader_out);
+
 /**
  * Frees the resources associated with an ArrowOdbcReader
  *
@@ -134,11 +587,267 @@ struct ArrowOdbcError *arrow_odbc_reader_next(struct ArrowOdbcReader *reader,
                                               void *schema,
                                               int *has_next_out);
 
+/**
+ * Like [`arrow_odbc_reader_next`], but returns immediately if the next batch is still fetched by
+ * another thread. In that case `pending_out` is set to `TRUE` and `array` and `schema` are left
+ * untouched. Use [`arrow_odbc_reader_notify`] to learn when to try again. Readers not fetching
+ * concurrently block, like [`arrow_odbc_reader_next`].
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ * * `array_out` and `schema_out` must both point to valid pointers, which themselves may be null.
+ * * `has_next_out` and `pending_out` must be valid pointers.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_try_next(struct ArrowOdbcReader *reader,
+                                                  void *array,
+                                                  void *schema,
+                                                  int *has_next_out,
+                                                  bool *pending_out);
+
+/**
+ * Makes a reader fetching concurrently write to `socket` each time it is about to hand over a
+ * batch, and once the result set is consumed. An event loop can wait for the socket to become
+ * readable, before calling [`arrow_odbc_reader_try_next`] again. Notifications may be spurious,
+ * and several of them may be written for one batch.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`] with
+ *   `fetch_concurrently` set to `TRUE`.
+ * * `socket` must be the file descriptor (a `SOCKET` on windows) of a non-blocking stream socket,
+ *   e.g. one end of a socket pair. It must stay open until the reader is freed, it is not closed
+ *   by the reader.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_notify(struct ArrowOdbcReader *reader, uint64_t socket);
+
+/**
+ * Advances a reader created with `more_results` to the next result set, which may have another
+ * schema. Batches of the current result set not fetched yet are discarded. `has_more_out` is set
+ * to `FALSE` once all result sets are consumed.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`] with
+ *   `more_results` set to `TRUE`.
+ * * `has_more_out` must be a valid pointer.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_next_result_set(struct ArrowOdbcReader *reader,
+                                                         bool *has_more_out);
+
+/**
+ * Maximum number of rows in each batch yielded by the reader. This may be smaller than the
+ * `batch_size` requested in [`arrow_odbc_reader_make`], if an upper limit for the size of a batch
+ * in bytes has been specified.
+ *
+ * # Safety
+ *
+ * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ */
+uintptr_t arrow_odbc_reader_batch_size(struct ArrowOdbcReader *reader);
+
 /**
  * Retrieve the associated schema from a reader.
  */
 struct ArrowOdbcError *arrow_odbc_reader_schema(struct ArrowOdbcReader *reader, void *out_schema);
 
+/**
+ * Dictionary encode a text column of the batches yielded by the reader from now on. The
+ * dictionary persists across batches, so each value keeps its key for the entire result set. The
+ * schema reported for the reader changes accordingly. Fetching a batch fails once the column
+ * exceeds 65536 distinct values.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ * * `column_buf` must point to a valid utf-8 string, holding the name of a text column.
+ * * `column_len` describes the len of `column_buf` in bytes.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_dictionary_encode(struct ArrowOdbcReader *reader,
+                                                           const uint8_t *column_buf,
+                                                           uintptr_t column_len);
+
+/**
+ * Track the largest value of a column in the batches yielded by the reader from now on, e.g. to
+ * start the next incremental extract after it. Retrieve it with [`arrow_odbc_reader_watermark`].
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ * * `column_buf` must point to a valid utf-8 string, holding the name of an integer, floating
+ *   point, date, timestamp or text column.
+ * * `column_len` describes the len of `column_buf` in bytes.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_track_watermark(struct ArrowOdbcReader *reader,
+                                                         const uint8_t *column_buf,
+                                                         uintptr_t column_len);
+
+/**
+ * Exports the largest value of the column tracked with [`arrow_odbc_reader_track_watermark`], as
+ * an array with a single element. `has_value_out` is set to `FALSE` if there has not been any
+ * value yet, other than `NULL`. The structures are not touched in that case.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ * * `array` must be a valid pointer to an `FFI_ArrowArray`, which is overwritten.
+ * * `schema` must be a valid pointer to an `FFI_ArrowSchema`, which is overwritten.
+ * * `has_value_out` must be a valid pointer.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_watermark(struct ArrowOdbcReader *reader,
+                                                   void *array,
+                                                   void *schema,
+                                                   bool *has_value_out);
+
+/**
+ * Cumulative counters of the reader, e.g. to tell time spent fetching from the data source apart
+ * from time spent exporting batches.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+ * * `stats_out` must point to a valid `ArrowOdbcReaderStats`, which is overwritten.
+ */
+void arrow_odbc_reader_stats(struct ArrowOdbcReader *reader,
+                             struct ArrowOdbcReaderStats *stats_out);
+
+/**
+ * Creates a reader yielding the batches cached for the key, without connecting to the data
+ * source. Returns `NULL` if there is no such entry, or it has expired.
+ *
+ * # Safety
+ *
+ * * `key_buf` must point to a valid utf-8 string, identifying the result set.
+ * * `key_len` describes the len of `key_buf` in bytes.
+ */
+struct ArrowOdbcReader *arrow_odbc_cache_lookup(const uint8_t *key_buf, uintptr_t key_len);
+
+/**
+ * Caches the batches yielded by the reader under the key, once it has been consumed entirely.
+ * Readers which are dropped early, or fail, are not cached. Batches are cached before
+ * dictionary encoding.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`], which
+ *   has not yielded any batches yet.
+ * * `key_buf` must point to a valid utf-8 string, identifying the result set.
+ * * `key_len` describes the len of `key_buf` in bytes.
+ * * `ttl_ms` time in milliseconds the result set is served from the cache, after it has been
+ *   consumed.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_cache(struct ArrowOdbcReader *reader,
+                                               const uint8_t *key_buf,
+                                               uintptr_t key_len,
+                                               uint64_t ttl_ms);
+
+/**
+ * Sets the upper bound for the memory held by cached result sets. The least recently used ones
+ * are evicted to meet it. Result sets larger than the bound are not cached at all. Use `0` to
+ * disable caching.
+ */
+void arrow_odbc_cache_set_max_bytes(uintptr_t max_bytes);
+
+/**
+ * Removes all result sets from the cache.
+ */
+void arrow_odbc_cache_clear(void);
+
+/**
+ * Writes the remaining batches of the reader to a Parquet file. Batches are encoded by a
+ * dedicated system thread, while the calling thread fetches the next one. They never leave Rust,
+ * so they do not need to be exported over the C Data Interface.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`]. It is
+ *   not freed by this function.
+ * * `path_buf` must point to the path of the file, encoded like `os.fsencode` does. An existing
+ *   file is overwritten.
+ * * `path_len` describes the len of `path_buf` in bytes.
+ * * `row_group_size` maximum number of rows in each row group. Batches are buffered until enough
+ *   rows for a row group are collected. Use `0` for the default of the parquet crate.
+ * * `compression_buf` must point to a valid utf-8 string. One of `uncompressed`, `snappy`,
+ *   `gzip`, `brotli`, `lz4` or `zstd`.
+ * * `compression_len` describes the len of `compression_buf` in bytes.
+ * * `rows_out` in case of success this will hold the number of rows written.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_write_parquet(struct ArrowOdbcReader *reader,
+                                                       const uint8_t *path_buf,
+                                                       uintptr_t path_len,
+                                                       uintptr_t row_group_size,
+                                                       const uint8_t *compression_buf,
+                                                       uintptr_t compression_len,
+                                                       uint64_t *rows_out);
+
+/**
+ * Writes the remaining batches of the reader to an Arrow IPC file, also known as Feather V2.
+ * Batches are encoded by a dedicated system thread, while the calling thread fetches the next
+ * one.
+ *
+ * # Safety
+ *
+ * * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`]. It is
+ *   not freed by this function.
+ * * `path_buf` must point to the path of the file, encoded like `os.fsencode` does. An existing
+ *   file is overwritten.
+ * * `path_len` describes the len of `path_buf` in bytes.
+ * * `rows_out` in case of success this will hold the number of rows written.
+ */
+struct ArrowOdbcError *arrow_odbc_reader_write_ipc(struct ArrowOdbcReader *reader,
+                                                   const uint8_t *path_buf,
+                                                   uintptr_t path_len,
+                                                   uint64_t *rows_out);
+
+/**
+ * Executes a query on the source connection and inserts the result set into a table of the
+ * target connection. Batches are fetched by a dedicated system thread, while the calling thread
+ * inserts the previous batch. Batches never leave Rust, so they do not need to be exported over
+ * the C Data Interface.
+ *
+ * Takes ownership of both connections even in case of an error.
+ *
+ * # Safety
+ *
+ * * `source` and `target` must point to valid OdbcConnections. This function takes ownership of
+ *   both of them, even in case of an error. So the connections must not be freed explicitly
+ *   afterwards.
+ * * `query_buf` must point to a valid utf-8 string
+ * * `query_len` describes the len of `query_buf` in bytes.
+ * * `parameters` must contain only valid pointers. This function takes ownership of all of them
+ *   independent if the function succeeds or not. Yet it does not take ownership of the array
+ *   itself.
+ * * `parameters_len` number of elements in parameters.
+ * * `batch_size` maximum number of rows fetched in each batch.
+ * * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+ *   uppper bound applies.
+ * * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+ *   that no uppper bound applies.
+ * * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+ *   to abort the process.
+ * * `prefetch_depth`: Maximum number of batches fetched ahead of the inserting thread. `0` is
+ *   treated like `1`.
+ * * `table_buf` must point to a valid utf-8 string
+ * * `table_len` describes the len of `table_buf` in bytes.
+ * * `chunk_size` number of rows inserted in each round trip to the target.
+ * * `rows_out` in case of success this will hold the number of rows copied.
+ */
+struct ArrowOdbcError *arrow_odbc_copy_table(struct OdbcConnection *source,
+                                             const uint8_t *query_buf,
+                                             uintptr_t query_len,
+                                             struct ArrowOdbcParameter *const *parameters,
+                                             uintptr_t parameters_len,
+                                             uintptr_t batch_size,
+                                             uintptr_t max_text_size,
+                                             uintptr_t max_binary_size,
+                                             bool fallibale_allocations,
+                                             uintptr_t prefetch_depth,
+                                             struct OdbcConnection *target,
+                                             const uint8_t *table_buf,
+                                             uintptr_t table_len,
+                                             uintptr_t chunk_size,
+                                             uintptr_t *rows_out);
+
 /**
  * Frees the resources associated with an ArrowOdbcWriter
  *
@@ -161,6 +870,19 @@ void arrow_odbc_writer_free(struct ArrowOdbcWriter *writer);
  * * `table_buf` must point to a valid utf-8 string
  * * `table_len` describes the len of `table_buf` in bytes.
  * * `schema` pointer to an arrow schema.
+ * * `pipelined`: `TRUE` to insert batches on a dedicated system thread. Calls to
+ *   [`arrow_odbc_writer_write_batch`] return once the batch is handed over, so the caller can
+ *   prepare the next batch, while the previous one is still sent to the database. Errors are
+ *   reported by the next call to write a batch or to flush.
+ * * `autocommit`: `TRUE` to let the driver commit every chunk once it is executed. `FALSE` to
+ *   control transactions according to `commit_every`. In case of an error the current transaction
+ *   is rolled back. Rows not committed once the writer is freed are rolled back, too.
+ * * `commit_every`: Number of chunks inserted in one transaction. `0` inserts all rows in a single
+ *   transaction, committed by [`arrow_odbc_writer_flush`]. Ignored if `autocommit` is `TRUE`.
+ * * `bulk`: `TRUE` to add the hints of the database management system for large inserts to the
+ *   insert statement. E.g. this takes a table lock on Microsoft SQL Server and performs a direct
+ *   path insert on Oracle. Rows are still sent as arrays of parameters. Other database management
+ *   systems are inserted into like with `FALSE`. Requires `autocommit` to be `TRUE`.
  * * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
  *   is transferred to the caller.
  */
@@ -169,8 +891,70 @@ struct ArrowOdbcError *arrow_odbc_writer_make(struct OdbcConnection *connection,
                                               uintptr_t table_len,
                                               uintptr_t chunk_size,
                                               const void *schema,
+                                              bool pipelined,
+                                              bool autocommit,
+                                              uintptr_t commit_every,
+                                              bool bulk,
                                               struct ArrowOdbcWriter **writer_out);
 
+/**
+ * Creates an Arrow ODBC writer instance, which inserts into the table over several connections
+ * concurrently. Batches are distributed round-robin over the connections. Each connection has
+ * its own insert thread, so batches are inserted in a pipelined fashion. Errors are reported by a
+ * later call to write a batch or to flush.
+ *
+ * Takes ownership of all connections even in case of an error.
+ *
+ * # Safety
+ *
+ * * `connections` must point to an array of `connections_len` valid OdbcConnections. This
+ *   function takes ownership of all of them, even in case of an error. Yet it does not take
+ *   ownership of the array itself.
+ * * `table_buf` must point to a valid utf-8 string
+ * * `table_len` describes the len of `table_buf` in bytes.
+ * * `schema` pointer to an arrow schema.
+ * * `autocommit`, `commit_every` and `bulk` are applied to each connection, like they are by
+ *   [`arrow_odbc_writer_make`]. `bulk` can not be combined with more than one connection.
+ * * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
+ *   is transferred to the caller.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_make_parallel(struct OdbcConnection *const *connections,
+                                                       uintptr_t connections_len,
+                                                       const uint8_t *table_buf,
+                                                       uintptr_t table_len,
+                                                       uintptr_t chunk_size,
+                                                       const void *schema,
+                                                       bool autocommit,
+                                                       uintptr_t commit_every,
+                                                       bool bulk,
+                                                       struct ArrowOdbcWriter **writer_out);
+
+/**
+ * Creates an Arrow ODBC writer instance, which executes an arbitrary statement once for each row
+ * written to it. The columns of each batch are bound as arrays of parameters to the placeholders
+ * (`?`) of the statement, in order. So the statement is executed for up to `chunk_size` rows in a
+ * single round trip.
+ *
+ * Takes ownership of connection even in case of an error.
+ *
+ * # Safety
+ *
+ * * `connection` must point to a valid OdbcConnection. This function takes ownership of the
+ *   connection, even in case of an error. So The connection must not be freed explicitly
+ *   afterwards.
+ * * `statement_buf` must point to a valid utf-8 string
+ * * `statement_len` describes the len of `statement_buf` in bytes.
+ * * `schema` pointer to an arrow schema. It must have one field for each placeholder.
+ * * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
+ *   is transferred to the caller.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_make_with_statement(struct OdbcConnection *connection,
+                                                             const uint8_t *statement_buf,
+                                                             uintptr_t statement_len,
+                                                             uintptr_t chunk_size,
+                                                             const void *schema,
+                                                             struct ArrowOdbcWriter **writer_out);
+
 /**
  * # Safety
  *
@@ -181,9 +965,77 @@ struct ArrowOdbcError *arrow_odbc_writer_write_batch(struct ArrowOdbcWriter *wri
                                                      void *array_ptr,
                                                      void *schema_ptr);
 
+/**
+ * Like [`arrow_odbc_writer_write_batch`], but returns immediately, if a pipelined writer is still
+ * busy with earlier batches. In that case `ready_out` is set to `FALSE` and the batch is handed
+ * over by a later call to [`arrow_odbc_writer_poll`]. Use [`arrow_odbc_writer_notify`] to learn
+ * when to call it. Other writers block, like [`arrow_odbc_writer_write_batch`].
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+ * * `batch` must be a valid pointer to an arrow batch
+ * * `ready_out` must be a valid pointer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_try_write_batch(struct ArrowOdbcWriter *writer,
+                                                         void *array_ptr,
+                                                         void *schema_ptr,
+                                                         bool *ready_out);
+
+/**
+ * Like [`arrow_odbc_writer_flush`], but returns immediately, if a pipelined writer is still
+ * inserting. In that case `ready_out` is set to `FALSE`, and the outcome is reported by a later
+ * call to [`arrow_odbc_writer_poll`].
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+ * * `ready_out` must be a valid pointer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_try_flush(struct ArrowOdbcWriter *writer, bool *ready_out);
+
+/**
+ * Continues the operation started by [`arrow_odbc_writer_try_write_batch`] or
+ * [`arrow_odbc_writer_try_flush`], without blocking. `ready_out` is set to `TRUE` once it is
+ * complete. Errors of the operation are reported by this call.
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+ * * `ready_out` must be a valid pointer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_poll(struct ArrowOdbcWriter *writer, bool *ready_out);
+
+/**
+ * Makes a pipelined writer write to `socket` each time its insert thread is done with a batch or
+ * a flush, and once it stops. An event loop can wait for the socket to become readable, before
+ * calling [`arrow_odbc_writer_poll`] again. Notifications may be spurious.
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`] with
+ *   `pipelined` set to `TRUE`.
+ * * `socket` must be the file descriptor (a `SOCKET` on windows) of a non-blocking stream socket,
+ *   e.g. one end of a socket pair. It must stay open until the writer is freed, it is not closed
+ *   by the writer.
+ */
+struct ArrowOdbcError *arrow_odbc_writer_notify(struct ArrowOdbcWriter *writer, uint64_t socket);
+
 /**
  * # Safety
  *
  * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
  */
 struct ArrowOdbcError *arrow_odbc_writer_flush(struct ArrowOdbcWriter *writer);
+
+/**
+ * Cumulative counters of the writer, e.g. to tell time spent executing apart from time spent
+ * committing.
+ *
+ * # Safety
+ *
+ * * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+ * * `stats_out` must point to a valid `ArrowOdbcWriterStats`, which is overwritten.
+ */
+void arrow_odbc_writer_stats(struct ArrowOdbcWriter *writer,
+                             struct ArrowOdbcWriterStats *stats_out);
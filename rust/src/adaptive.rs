@@ -0,0 +1,259 @@
+use std::cmp::min;
+
+use arrow_odbc::{
+    arrow::{
+        array::{Array, StringArray},
+        datatypes::SchemaRef,
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::{
+        parameter::InputParameter, CursorImpl, Error, Prepared, ResultSetMetadata,
+        StatementConnection,
+    },
+    BufferAllocationOptions, OdbcReader,
+};
+
+use crate::{
+    buffer_size::{bytes_per_row, limit_batch_size},
+    statement::{LentStatement, StatementSlot},
+};
+
+/// Options for creating an [`AdaptiveReader`].
+pub struct AdaptiveOptions {
+    pub batch_size: usize,
+    /// Size of the text buffers the first attempt to fetch the first batch is made with.
+    pub initial_text_size: usize,
+    /// Upper bound for the size of text buffers. Values exceeding it are truncated, just like
+    /// without adaptive sizing.
+    pub max_text_size: Option<usize>,
+    pub max_binary_size: Option<usize>,
+    pub fallibale_allocations: bool,
+    pub max_bytes_per_batch: Option<usize>,
+    /// Used instead of the schema inferred from the column types reported by the driver.
+    pub schema: Option<SchemaRef>,
+}
+
+/// Sizes the buffers bound to text columns from the values in the result set, rather than from
+/// the size the driver declares for the column. The first batch is fetched with small buffers.
+/// As long as it contains values which may have been truncated, the query is executed again with
+/// larger buffers. Only the columns holding such values determine how much larger: the buffers
+/// grow to twice the size, or to the longest value the declared octet length of these columns
+/// allows for, whichever is smaller. `arrow-odbc` takes a single upper bound for all text columns,
+/// so other columns declared larger than the previous bound grow with it, while columns already
+/// holding their longest possible value are not affected. Once the first batch fits, the
+/// remaining batches are fetched with the same buffers. A forward only cursor can not fetch a batch again, so should a later batch not
+/// fit, an error is reported instead of silently truncating its values.
+pub struct AdaptiveReader {
+    /// Its cursor owns the statement.
+    reader: OdbcReader<CursorImpl<LentStatement>>,
+    /// Fetched while sizing the buffers, yielded before any other batch. `None` once yielded.
+    first_batch: Option<RecordBatch>,
+    /// `true` if the first batch already consumed the cursor.
+    exhausted: bool,
+    /// Size of the buffers bound to text columns.
+    text_size: usize,
+    /// Longest value each column may hold according to the driver, see [`declared_text_lens`].
+    declared: Vec<Option<usize>>,
+    /// `true` if `text_size` is the upper bound requested by the caller. Truncation is expected
+    /// in this case.
+    at_max_text_size: bool,
+    batch_size: usize,
+    /// Estimated size of the buffers bound to the cursor.
+    buffer_bytes: usize,
+}
+
+impl AdaptiveReader {
+    /// Executes the prepared statement until the first batch fits into the text buffers. `None`
+    /// if the statement does not produce a result set.
+    pub fn new(
+        statement: Prepared<StatementConnection<'static>>,
+        parameters: &[Box<dyn InputParameter + '_>],
+        options: &AdaptiveOptions,
+    ) -> Result<Option<Self>, String> {
+        let statement = StatementSlot::new(statement);
+        let mut text_size = options.initial_text_size;
+        loop {
+            if let Some(max_text_size) = options.max_text_size {
+                text_size = min(text_size, max_text_size);
+            }
+            let at_max_text_size = options.max_text_size == Some(text_size);
+
+            let mut cursor = match statement.execute(parameters)? {
+                Some(cursor) => cursor,
+                None => return Ok(None),
+            };
+            if let Some(schema) = &options.schema {
+                let num_cols = cursor
+                    .num_result_cols()
+                    .map_err(|error| error.to_string())?;
+                if schema.fields().len() != num_cols as usize {
+                    return Err(format!(
+                        "The schema has {} fields, yet the result set has {num_cols} columns.",
+                        schema.fields().len()
+                    ));
+                }
+            }
+            let bytes_per_row =
+                bytes_per_row(&mut cursor, Some(text_size), options.max_binary_size)
+                    .map_err(|error| error.to_string())?;
+            let declared = declared_text_lens(&mut cursor).map_err(|error| error.to_string())?;
+            let batch_size = limit_batch_size(
+                options.batch_size,
+                options.max_bytes_per_batch,
+                bytes_per_row,
+            )?;
+            let buffer_bytes = bytes_per_row * batch_size;
+            let buffer_allocation_options = BufferAllocationOptions {
+                max_text_size: Some(text_size),
+                max_binary_size: options.max_binary_size,
+                fallibale_allocations: options.fallibale_allocations,
+            };
+            let mut reader = OdbcReader::with(
+                cursor,
+                batch_size,
+                options.schema.clone(),
+                buffer_allocation_options,
+            )
+            .map_err(|error| error.to_string())?;
+            let first_batch = reader
+                .next()
+                .transpose()
+                .map_err(|error| error.to_string())?;
+
+            let truncated = first_batch.as_ref().map_or_else(Vec::new, |batch| {
+                truncated_columns(batch, text_size, &declared)
+            });
+            if truncated.is_empty() || at_max_text_size {
+                return Ok(Some(Self {
+                    reader,
+                    exhausted: first_batch.is_none(),
+                    first_batch,
+                    text_size,
+                    declared,
+                    at_max_text_size,
+                    batch_size,
+                    buffer_bytes,
+                }));
+            }
+            // Nothing has been handed out yet, so we can start over with larger buffers. Closes
+            // the cursor and returns the statement to its slot.
+            drop(reader);
+            // A column of unknown size may need any amount of room.
+            let needed = truncated
+                .iter()
+                .map(|&index| declared[index].unwrap_or(usize::MAX))
+                .max()
+                .unwrap();
+            // Truncated columns are declared larger than the current buffers, so they grow.
+            text_size = min(text_size * 2, needed);
+        }
+    }
+
+    /// Maximum number of rows in each batch. It has been reduced to fit `max_bytes_per_batch`
+    /// with the buffers the first batch fits in.
+    pub fn batch_size(&self) -> usize {
+        self.batch_size
+    }
+
+    /// Estimated size of the buffers bound to the cursor, once the first batch fits.
+    pub fn buffer_bytes(&self) -> usize {
+        self.buffer_bytes
+    }
+}
+
+impl Iterator for AdaptiveReader {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if let Some(batch) = self.first_batch.take() {
+            return Some(Ok(batch));
+        }
+        if self.exhausted {
+            return None;
+        }
+        let batch = match self.reader.next()? {
+            Ok(batch) => batch,
+            Err(error) => return Some(Err(error)),
+        };
+        if !self.at_max_text_size
+            && !truncated_columns(&batch, self.text_size, &self.declared).is_empty()
+        {
+            return Some(Err(ArrowError::ExternalError(
+                format!(
+                    "A text value may exceed the buffer size of {} chosen based on the first batch \
+                    and can not be fetched again. Start with a larger initial text size.",
+                    self.text_size
+                )
+                .into(),
+            )));
+        }
+        Some(Ok(batch))
+    }
+}
+
+impl RecordBatchReader for AdaptiveReader {
+    fn schema(&self) -> SchemaRef {
+        self.reader.schema()
+    }
+}
+
+/// Indices of the text columns holding a value which fills its buffer entirely and may therefore
+/// have been truncated. The indicators are not exposed by the reader, but it clamps each value to
+/// the smaller of indicator and buffer length. So a truncated value, i.e. one with an indicator
+/// exceeding the buffer length or `SQL_NO_TOTAL`, always spans the whole buffer, while any shorter
+/// value is known to be complete. Columns whose `declared` length fits into the buffers can not
+/// be truncated, even if a value spans the whole buffer.
+fn truncated_columns(
+    batch: &RecordBatch,
+    text_size: usize,
+    declared: &[Option<usize>],
+) -> Vec<usize> {
+    batch
+        .columns()
+        .iter()
+        .enumerate()
+        .filter(|&(index, _)| declared[index].map_or(true, |len| len > text_size))
+        .filter(|(_, column)| {
+            column
+                .as_any()
+                .downcast_ref::<StringArray>()
+                .map_or(false, |text| {
+                    (0..text.len()).any(|index| {
+                        text.is_valid(index) && text_len(text.value(index)) >= text_size
+                    })
+                })
+        })
+        .map(|(index, _)| index)
+        .collect()
+}
+
+/// Longest value of each column, in the unit the text buffers are sized in, derived from the
+/// `SQL_DESC_OCTET_LENGTH` reported by the driver. `None` if the driver does not know it, e.g. for
+/// `VARCHAR(MAX)`. The octet length refers to the representation of the data source, which may
+/// take less room than the text it converts to. On windows every byte yields at most one UTF-16
+/// code unit. Everywhere else a byte of any encoding yields at most four bytes of UTF-8.
+fn declared_text_lens(cursor: &mut impl ResultSetMetadata) -> Result<Vec<Option<usize>>, Error> {
+    let num_cols: u16 = cursor.num_result_cols()?.try_into().unwrap();
+    (1..(num_cols + 1))
+        .map(|col_index| {
+            let octet_length = cursor.col_octet_length(col_index)?;
+            Ok(if octet_length <= 0 {
+                None
+            } else if cfg!(target_os = "windows") {
+                Some(octet_length as usize)
+            } else {
+                Some(octet_length as usize * 4)
+            })
+        })
+        .collect()
+}
+
+/// Length of the value in the unit the text buffers are sized in.
+fn text_len(value: &str) -> usize {
+    if cfg!(target_os = "windows") {
+        value.encode_utf16().count()
+    } else {
+        value.len()
+    }
+}
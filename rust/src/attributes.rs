@@ -0,0 +1,175 @@
+use std::slice;
+
+use arrow_odbc::{
+    arrow::{
+        datatypes::SchemaRef,
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::{
+        handles::{AsStatementRef, Statement},
+        parameter::InputParameter,
+        Connection, CursorImpl, Prepared, ResultSetMetadata, StatementConnection,
+    },
+    BufferAllocationOptions, OdbcReader,
+};
+
+use crate::{
+    buffer_size::{bytes_per_row, limit_batch_size},
+    handles::{set_connection_attribute_by_id, set_statement_attribute_by_id},
+    statement::{LentStatement, StatementSlot},
+};
+
+/// An integer valued statement or connection attribute, e.g. `SQL_ATTR_MAX_LENGTH` or a driver
+/// specific one controlling how many rows are prefetched.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct ArrowOdbcAttribute {
+    /// ODBC constant identifying the attribute, e.g. `3` for `SQL_ATTR_MAX_LENGTH`.
+    pub attribute: i32,
+    pub value: isize,
+}
+
+/// Copies the attributes passed by the caller. `NULL` is treated like an empty array.
+///
+/// # Safety
+///
+/// `attributes` must either be `NULL` or point to an array of at least `len` elements.
+pub unsafe fn attributes_from_raw(
+    attributes: *const ArrowOdbcAttribute,
+    len: usize,
+) -> Vec<ArrowOdbcAttribute> {
+    if attributes.is_null() {
+        Vec::new()
+    } else {
+        slice::from_raw_parts(attributes, len).to_vec()
+    }
+}
+
+/// Sets the attributes on the connection, in the order given.
+pub fn apply_connection_attributes(
+    connection: Connection<'static>,
+    attributes: &[ArrowOdbcAttribute],
+) -> Result<Connection<'static>, String> {
+    if attributes.is_empty() {
+        return Ok(connection);
+    }
+    let hdbc = connection.into_sys();
+    // Safety: We own the handle, which is valid, since it belongs to an open connection. It is
+    // owned by a connection again, before any error is returned, so it is freed in any case.
+    let connection = unsafe { Connection::from_handle(hdbc) };
+    for attribute in attributes {
+        unsafe { set_connection_attribute_by_id(hdbc, attribute.attribute, attribute.value)? };
+    }
+    Ok(connection)
+}
+
+/// Sets the attributes on the statement, in the order given. They apply to all executions
+/// following, so this must happen before the statement is executed.
+pub fn apply_statement_attributes(
+    statement: &mut Prepared<StatementConnection<'static>>,
+    attributes: &[ArrowOdbcAttribute],
+) -> Result<(), String> {
+    let hstmt = statement.as_stmt_ref().as_sys();
+    for attribute in attributes {
+        unsafe { set_statement_attribute_by_id(hstmt, attribute.attribute, attribute.value)? };
+    }
+    Ok(())
+}
+
+/// Options for creating an [`AttributedReader`].
+pub struct AttributedOptions {
+    pub batch_size: usize,
+    pub max_bytes_per_batch: Option<usize>,
+    pub buffer_allocation_options: BufferAllocationOptions,
+    /// Used instead of the schema inferred from the column types reported by the driver.
+    pub schema: Option<SchemaRef>,
+}
+
+/// Fetches batches of a statement, which had statement attributes set before it was executed.
+/// `odbc-api` allocates and executes statements in one go, if it owns their cursor. So this reader
+/// executes the statement itself, lending it to the cursor of the result set.
+pub struct AttributedReader {
+    /// Its cursor owns the statement.
+    reader: OdbcReader<CursorImpl<LentStatement>>,
+    batch_size: usize,
+    /// Estimated size of the buffers bound to the cursor.
+    buffer_bytes: usize,
+}
+
+impl AttributedReader {
+    /// Sets the attributes and executes the statement. `None` if the statement does not produce a
+    /// result set.
+    pub fn new(
+        mut statement: Prepared<StatementConnection<'static>>,
+        attributes: &[ArrowOdbcAttribute],
+        parameters: &[Box<dyn InputParameter + '_>],
+        options: AttributedOptions,
+    ) -> Result<Option<Self>, String> {
+        apply_statement_attributes(&mut statement, attributes)?;
+        let mut cursor = match StatementSlot::new(statement).execute(parameters)? {
+            Some(cursor) => cursor,
+            None => return Ok(None),
+        };
+        if let Some(schema) = &options.schema {
+            let num_cols = cursor
+                .num_result_cols()
+                .map_err(|error| error.to_string())?;
+            if schema.fields().len() != num_cols as usize {
+                return Err(format!(
+                    "The schema has {} fields, yet the result set has {num_cols} columns.",
+                    schema.fields().len()
+                ));
+            }
+        }
+        let BufferAllocationOptions {
+            max_text_size,
+            max_binary_size,
+            ..
+        } = options.buffer_allocation_options;
+        let bytes_per_row = bytes_per_row(&mut cursor, max_text_size, max_binary_size)
+            .map_err(|error| error.to_string())?;
+        let batch_size = limit_batch_size(
+            options.batch_size,
+            options.max_bytes_per_batch,
+            bytes_per_row,
+        )?;
+        let buffer_bytes = bytes_per_row * batch_size;
+        let reader = OdbcReader::with(
+            cursor,
+            batch_size,
+            options.schema,
+            options.buffer_allocation_options,
+        )
+        .map_err(|error| error.to_string())?;
+        Ok(Some(Self {
+            reader,
+            batch_size,
+            buffer_bytes,
+        }))
+    }
+
+    /// Maximum number of rows in each batch, limited by `max_bytes_per_batch`.
+    pub fn batch_size(&self) -> usize {
+        self.batch_size
+    }
+
+    /// Estimated size of the buffers bound to the cursor.
+    pub fn buffer_bytes(&self) -> usize {
+        self.buffer_bytes
+    }
+}
+
+impl Iterator for AttributedReader {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        self.reader.next()
+    }
+}
+
+impl RecordBatchReader for AttributedReader {
+    fn schema(&self) -> SchemaRef {
+        self.reader.schema()
+    }
+}
@@ -0,0 +1,98 @@
+use std::{cmp::min, mem::size_of};
+
+use arrow_odbc::odbc_api::{
+    sys::{Date, Timestamp},
+    DataType, Error, ResultSetMetadata,
+};
+
+/// Reduces `batch_size`, so the buffers bound to the cursor do not exceed `max_bytes_per_batch`.
+/// `None` means no upper bound applies. `bytes_per_row` is the estimate of [`bytes_per_row`].
+pub fn limit_batch_size(
+    batch_size: usize,
+    max_bytes_per_batch: Option<usize>,
+    bytes_per_row: usize,
+) -> Result<usize, String> {
+    let max_bytes_per_batch = match max_bytes_per_batch {
+        Some(max_bytes_per_batch) => max_bytes_per_batch,
+        None => return Ok(batch_size),
+    };
+    if bytes_per_row > max_bytes_per_batch {
+        return Err(format!(
+            "A single row requires {bytes_per_row} bytes in the buffers bound to the cursor. This \
+            exceeds the upper limit of {max_bytes_per_batch} bytes per batch."
+        ));
+    }
+    Ok(min(batch_size, max_bytes_per_batch / bytes_per_row))
+}
+
+/// Estimates the number of bytes a single row occupies in the buffers bound to the cursor. This
+/// mirrors the way `arrow-odbc` chooses buffers for the columns of a result set, including the
+/// indicators holding the length of each value. It is intended to be an upper bound, e.g. for
+/// fixed size columns an indicator is accounted for, even if the column is not nullable.
+pub fn bytes_per_row(
+    cursor: &mut impl ResultSetMetadata,
+    max_text_size: Option<usize>,
+    max_binary_size: Option<usize>,
+) -> Result<usize, Error> {
+    let num_cols: u16 = cursor.num_result_cols()?.try_into().unwrap();
+    let mut total = 0;
+    for col_index in 1..(num_cols + 1) {
+        let data_type = cursor.col_data_type(col_index)?;
+        total += bytes_per_element(data_type, max_text_size, max_binary_size) + size_of::<isize>();
+    }
+    Ok(total)
+}
+
+/// Size of a single value of a column with the given type in the buffers bound to the cursor.
+fn bytes_per_element(
+    data_type: DataType,
+    max_text_size: Option<usize>,
+    max_binary_size: Option<usize>,
+) -> usize {
+    match data_type {
+        DataType::TinyInt | DataType::Bit => 1,
+        DataType::SmallInt => 2,
+        DataType::Integer | DataType::Real => 4,
+        DataType::BigInt | DataType::Double => 8,
+        DataType::Float { precision } => {
+            if precision <= 24 {
+                4
+            } else {
+                8
+            }
+        }
+        DataType::Date => size_of::<Date>(),
+        DataType::Timestamp { .. } => size_of::<Timestamp>(),
+        // Decimals are fetched as text. Sign and radix character need extra room.
+        DataType::Numeric { precision, .. } | DataType::Decimal { precision, .. } => {
+            text_bytes(precision + 2, None)
+        }
+        DataType::Binary { length }
+        | DataType::Varbinary { length }
+        | DataType::LongVarbinary { length } => apply_limit(length, max_binary_size),
+        // Everything else is fetched as text.
+        other => text_bytes(other.column_size(), max_text_size),
+    }
+}
+
+/// Bytes required to hold text with `length` characters, including the terminating zero.
+fn text_bytes(length: usize, max_text_size: Option<usize>) -> usize {
+    // On windows text is fetched as UTF-16. One character may take two code units, yet the upper
+    // limit is specified in code units.
+    if cfg!(target_os = "windows") {
+        (apply_limit(length * 2, max_text_size) + 1) * 2
+    } else {
+        // Everywhere else we assume UTF-8, there one character may take up to four bytes. The
+        // upper limit is specified in bytes.
+        apply_limit(length * 4, max_text_size) + 1
+    }
+}
+
+/// An upper limit applies if the reported size is larger, or if no size could be reported at all.
+fn apply_limit(length: usize, limit: Option<usize>) -> usize {
+    match limit {
+        Some(limit) if length == 0 => limit,
+        Some(limit) => min(length, limit),
+        None => length,
+    }
+}
@@ -0,0 +1,77 @@
+use arrow_odbc::{
+    arrow::datatypes::Schema,
+    odbc_api::{Connection, StatementConnection},
+    OdbcWriter,
+};
+
+/// Creates a writer inserting into `table`. With `bulk` the insert statement carries the hints of
+/// the database management system for large inserts, see [`bulk_insert_statement`]. Rows are still
+/// sent as arrays of parameters, this is not the bulk copy interface of any driver. Database
+/// management systems without such hints are inserted into like without `bulk`.
+pub fn table_writer(
+    connection: Connection<'static>,
+    schema: &Schema,
+    table: &str,
+    chunk_size: usize,
+    bulk: bool,
+) -> Result<OdbcWriter<StatementConnection<'static>>, String> {
+    if !bulk {
+        return OdbcWriter::from_connection(connection, schema, table, chunk_size)
+            .map_err(|error| error.to_string());
+    }
+    let dbms = connection
+        .database_management_system_name()
+        .map_err(|error| error.to_string())?;
+    let statement = bulk_insert_statement(&dbms, table, schema);
+    let prepared = connection
+        .into_prepared(&statement)
+        .map_err(|error| error.to_string())?;
+    OdbcWriter::new(chunk_size, schema, prepared).map_err(|error| error.to_string())
+}
+
+/// Rejects writer options which do not work together with `bulk` inserts. `num_connections` is the
+/// number of connections inserting concurrently.
+pub fn check_bulk_options(autocommit: bool, num_connections: usize) -> Result<(), String> {
+    if num_connections > 1 {
+        // Each connection would wait for the table lock held by the open transaction of another.
+        return Err(
+            "Bulk inserts can not be combined with parallelism, since the table lock \
+            allows only one connection to insert at a time."
+                .to_owned(),
+        );
+    }
+    if !autocommit {
+        // A table inserted into by a direct path insert can not be accessed again on Oracle, before
+        // the transaction is committed (ORA-12838). Autocommit commits each chunk once executed.
+        return Err(
+            "Bulk inserts require autocommit, since every chunk must be committed before \
+            the next one is inserted."
+                .to_owned(),
+        );
+    }
+    Ok(())
+}
+
+/// Insert statement for `table` with a placeholder for each field of `schema`. `dbms` is the name
+/// reported by the driver for `SQL_DBMS_NAME`.
+fn bulk_insert_statement(dbms: &str, table: &str, schema: &Schema) -> String {
+    let columns = schema
+        .fields()
+        .iter()
+        .map(|field| field.name().as_str())
+        .collect::<Vec<_>>()
+        .join(", ");
+    let placeholders = vec!["?"; schema.fields().len()].join(", ");
+    match dbms {
+        // Takes a single lock on the table, instead of acquiring locks row by row.
+        "Microsoft SQL Server" => {
+            format!("INSERT INTO {table} WITH (TABLOCK) ({columns}) VALUES ({placeholders})")
+        }
+        // Direct path insert. Rows are written above the high water mark of the table, bypassing
+        // the buffer cache. Each chunk must be committed before the next one is inserted.
+        "Oracle" => {
+            format!("INSERT /*+ APPEND_VALUES */ INTO {table} ({columns}) VALUES ({placeholders})")
+        }
+        _ => format!("INSERT INTO {table} ({columns}) VALUES ({placeholders})"),
+    }
+}
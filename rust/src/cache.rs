@@ -0,0 +1,283 @@
+use std::{
+    collections::HashMap,
+    ptr::null_mut,
+    slice, str,
+    sync::{Arc, Mutex},
+    time::{Duration, Instant},
+};
+
+use arrow_odbc::arrow::{
+    datatypes::SchemaRef,
+    error::ArrowError,
+    record_batch::{RecordBatch, RecordBatchReader},
+};
+use lazy_static::lazy_static;
+
+use crate::{
+    reader::{ArrowOdbcReader, Batches},
+    try_, ArrowOdbcError,
+};
+
+/// Upper bound for the memory held by the cache, unless configured otherwise.
+const DEFAULT_MAX_BYTES: usize = 256 * 1024 * 1024;
+
+lazy_static! {
+    static ref CACHE: Mutex<ResultCache> = Mutex::new(ResultCache::new(DEFAULT_MAX_BYTES));
+}
+
+/// Converted result sets of queries, keyed by everything which determines their batches, e.g.
+/// connection string, query and parameters. Entries expire after their time to live. If the
+/// cache exceeds its size bound, the least recently used entries are evicted.
+struct ResultCache {
+    entries: HashMap<String, Entry>,
+    /// Sum of the memory held by the batches of all entries.
+    bytes: usize,
+    max_bytes: usize,
+    /// Incremented with every access, to tell the least recently used entry.
+    clock: u64,
+}
+
+struct Entry {
+    result: Arc<CachedResult>,
+    expires_at: Instant,
+    last_used: u64,
+}
+
+/// The batches of a result set, as yielded by the reader which has fetched them.
+pub struct CachedResult {
+    schema: SchemaRef,
+    batches: Vec<RecordBatch>,
+    batch_size: usize,
+    bytes: usize,
+}
+
+impl ResultCache {
+    fn new(max_bytes: usize) -> Self {
+        Self {
+            entries: HashMap::new(),
+            bytes: 0,
+            max_bytes,
+            clock: 0,
+        }
+    }
+
+    fn get(&mut self, key: &str) -> Option<Arc<CachedResult>> {
+        self.clock += 1;
+        let entry = self.entries.get_mut(key)?;
+        if entry.expires_at <= Instant::now() {
+            self.remove(key);
+            return None;
+        }
+        entry.last_used = self.clock;
+        Some(entry.result.clone())
+    }
+
+    fn insert(&mut self, key: String, result: CachedResult, ttl: Duration) {
+        self.remove(&key);
+        self.remove_expired();
+        if result.bytes > self.max_bytes {
+            return;
+        }
+        self.clock += 1;
+        self.bytes += result.bytes;
+        let entry = Entry {
+            result: Arc::new(result),
+            expires_at: Instant::now() + ttl,
+            last_used: self.clock,
+        };
+        self.entries.insert(key, entry);
+        self.evict();
+    }
+
+    fn set_max_bytes(&mut self, max_bytes: usize) {
+        self.max_bytes = max_bytes;
+        self.evict();
+    }
+
+    fn clear(&mut self) {
+        self.entries.clear();
+        self.bytes = 0;
+    }
+
+    /// Removes the least recently used entries, until the size bound is met.
+    fn evict(&mut self) {
+        while self.bytes > self.max_bytes {
+            let least_recently_used = self
+                .entries
+                .iter()
+                .min_by_key(|(_, entry)| entry.last_used)
+                .map(|(key, _)| key.clone())
+                .unwrap();
+            self.remove(&least_recently_used);
+        }
+    }
+
+    fn remove_expired(&mut self) {
+        let now = Instant::now();
+        let expired: Vec<String> = self
+            .entries
+            .iter()
+            .filter(|(_, entry)| entry.expires_at <= now)
+            .map(|(key, _)| key.clone())
+            .collect();
+        for key in expired {
+            self.remove(&key);
+        }
+    }
+
+    fn remove(&mut self, key: &str) {
+        if let Some(entry) = self.entries.remove(key) {
+            self.bytes -= entry.result.bytes;
+        }
+    }
+}
+
+/// Collects the batches yielded by a reader. Once the result set is consumed, they are inserted
+/// into the cache.
+pub struct Recorder {
+    key: String,
+    ttl: Duration,
+    result: CachedResult,
+    /// Size bound of the cache once recording started. Captured, so recording a batch does not
+    /// need to lock the cache.
+    max_bytes: usize,
+    /// `true` once the batches exceed the size bound of the cache. They are no longer collected
+    /// then, since they could not be inserted anyway.
+    too_large: bool,
+}
+
+impl Recorder {
+    pub fn new(key: String, ttl: Duration, schema: SchemaRef, batch_size: usize) -> Self {
+        Self {
+            key,
+            ttl,
+            result: CachedResult {
+                schema,
+                batches: Vec::new(),
+                batch_size,
+                bytes: 0,
+            },
+            max_bytes: CACHE.lock().unwrap().max_bytes,
+            too_large: false,
+        }
+    }
+
+    /// Batches share their buffers with the ones handed to the consumer, so this does not copy
+    /// any values.
+    pub fn record(&mut self, batch: &RecordBatch) {
+        if self.too_large {
+            return;
+        }
+        self.result.bytes += batch
+            .columns()
+            .iter()
+            .map(|column| column.get_array_memory_size())
+            .sum::<usize>();
+        if self.result.bytes > self.max_bytes {
+            self.too_large = true;
+            self.result.batches.clear();
+            return;
+        }
+        self.result.batches.push(batch.clone());
+    }
+
+    /// Inserts the batches into the cache. Called once the result set is consumed.
+    pub fn finish(self) {
+        if self.too_large {
+            return;
+        }
+        CACHE
+            .lock()
+            .unwrap()
+            .insert(self.key, self.result, self.ttl);
+    }
+}
+
+/// Yields the batches of a cached result set.
+pub struct CachedBatches {
+    result: Arc<CachedResult>,
+    /// Index of the next batch.
+    next: usize,
+}
+
+impl Iterator for CachedBatches {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let batch = self.result.batches.get(self.next)?.clone();
+        self.next += 1;
+        Some(Ok(batch))
+    }
+}
+
+impl RecordBatchReader for CachedBatches {
+    fn schema(&self) -> SchemaRef {
+        self.result.schema.clone()
+    }
+}
+
+/// Creates a reader yielding the batches cached for the key, without connecting to the data
+/// source. Returns `NULL` if there is no such entry, or it has expired.
+///
+/// # Safety
+///
+/// * `key_buf` must point to a valid utf-8 string, identifying the result set.
+/// * `key_len` describes the len of `key_buf` in bytes.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_cache_lookup(
+    key_buf: *const u8,
+    key_len: usize,
+) -> *mut ArrowOdbcReader {
+    let key = slice::from_raw_parts(key_buf, key_len);
+    let key = str::from_utf8(key).unwrap();
+
+    let result = match CACHE.lock().unwrap().get(key) {
+        Some(result) => result,
+        None => return null_mut(),
+    };
+    let batch_size = result.batch_size;
+    let batches = Batches::Cached(CachedBatches { result, next: 0 });
+    Box::into_raw(Box::new(ArrowOdbcReader::new(batches, batch_size)))
+}
+
+/// Caches the batches yielded by the reader under the key, once it has been consumed entirely.
+/// Readers which are dropped early, or fail, are not cached. Batches are cached before
+/// dictionary encoding.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`], which
+///   has not yielded any batches yet.
+/// * `key_buf` must point to a valid utf-8 string, identifying the result set.
+/// * `key_len` describes the len of `key_buf` in bytes.
+/// * `ttl_ms` time in milliseconds the result set is served from the cache, after it has been
+///   consumed.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_cache(
+    mut reader: std::ptr::NonNull<ArrowOdbcReader>,
+    key_buf: *const u8,
+    key_len: usize,
+    ttl_ms: u64,
+) -> *mut ArrowOdbcError {
+    let key = slice::from_raw_parts(key_buf, key_len);
+    let key = str::from_utf8(key).unwrap();
+
+    try_!(reader
+        .as_mut()
+        .cache_result(key.to_owned(), Duration::from_millis(ttl_ms)));
+    null_mut() // Ok(())
+}
+
+/// Sets the upper bound for the memory held by cached result sets. The least recently used ones
+/// are evicted to meet it. Result sets larger than the bound are not cached at all. Use `0` to
+/// disable caching.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_cache_set_max_bytes(max_bytes: usize) {
+    CACHE.lock().unwrap().set_max_bytes(max_bytes);
+}
+
+/// Removes all result sets from the cache.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_cache_clear() {
+    CACHE.lock().unwrap().clear();
+}
@@ -0,0 +1,182 @@
+use std::{
+    fs::File,
+    io::BufReader,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        mpsc::{sync_channel, Receiver, TryRecvError},
+        Arc,
+    },
+    task::Poll,
+    thread::{self, JoinHandle},
+};
+
+use arrow_odbc::{
+    arrow::{
+        datatypes::SchemaRef,
+        error::ArrowError,
+        ipc::reader::FileReader,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::{CursorImpl, StatementConnection},
+    OdbcReader,
+};
+
+use crate::{
+    adaptive::AdaptiveReader, attributes::AttributedReader, lob::LobReader,
+    notification::Notification, ramp_up::RampUpReader, zero_copy::ZeroCopyReader,
+};
+
+/// Fetches record batches from a reader (e.g. an `OdbcReader`) on a dedicated system thread. While
+/// the consumer is still busy processing the current batch, the next one is already fetched from
+/// the data source.
+pub struct ConcurrentOdbcReader {
+    schema: SchemaRef,
+    /// Only `None` during drop, so we can hang up on the fetch thread before joining it.
+    receiver: Option<Receiver<Result<RecordBatch, ArrowError>>>,
+    /// Only `None` during drop.
+    fetch_thread: Option<JoinHandle<()>>,
+    /// Notified by the fetch thread each time it is about to hand over a batch, and once it stops.
+    notification: Notification,
+    /// Number of batches the fetch thread is committed to send. Incremented before each send, so
+    /// [`Self::try_next`] can tell a batch is on its way, even if the channel has no capacity.
+    announced: Arc<AtomicUsize>,
+    /// Number of batches received so far.
+    received: usize,
+}
+
+impl ConcurrentOdbcReader {
+    /// Moves the reader to a new system thread, which immediately starts fetching the first batch.
+    ///
+    /// `prefetch_depth` is the maximum number of batches which are fetched ahead of the consumer.
+    /// Once that many batches are waiting, the fetch thread blocks until the consumer catches up.
+    /// A depth of `0` is treated like `1`.
+    pub fn new(reader: impl FetchOnAnyThread, prefetch_depth: usize) -> Self {
+        let schema = reader.schema();
+        // The fetch thread holds on to one batch while blocking in `send`, so a channel with a
+        // capacity of `0` (rendezvous) already allows for one batch fetched ahead. In that case
+        // there are two sets of buffers in use: the ones bound to the cursor and the ones of the
+        // batch the consumer is currently processing. Every additional slot in the channel adds
+        // one more batch.
+        let (sender, receiver) = sync_channel(prefetch_depth.saturating_sub(1));
+        let reader = AssertSend(reader);
+        let notification = Notification::default();
+        let thread_notification = notification.clone();
+        let announced = Arc::new(AtomicUsize::new(0));
+        let thread_announced = announced.clone();
+        let fetch_thread = thread::spawn(move || {
+            for batch in reader.into_inner() {
+                thread_announced.fetch_add(1, Ordering::SeqCst);
+                thread_notification.notify();
+                if sender.send(batch).is_err() {
+                    // Receiver hung up. No need to fetch any more batches.
+                    break;
+                }
+            }
+            // Dropping the sender first, so the consumer sees the end of the result set once it
+            // wakes up.
+            drop(sender);
+            thread_notification.notify();
+        });
+        Self {
+            schema,
+            receiver: Some(receiver),
+            fetch_thread: Some(fetch_thread),
+            notification,
+            announced,
+            received: 0,
+        }
+    }
+
+    pub fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+
+    pub fn notification(&self) -> &Notification {
+        &self.notification
+    }
+
+    /// Like `next`, but does not wait for the next batch to be fetched. `Poll::Pending` if the
+    /// fetch thread is still fetching it. Once it announced the batch, it is received even if the
+    /// fetch thread has yet to enter `send`, which is only a matter of moments.
+    pub fn try_next(&mut self) -> Poll<Option<Result<RecordBatch, ArrowError>>> {
+        let receiver = self.receiver.as_ref().unwrap();
+        let batch = if self.announced.load(Ordering::SeqCst) > self.received {
+            receiver.recv().ok()
+        } else {
+            match receiver.try_recv() {
+                Ok(batch) => Some(batch),
+                Err(TryRecvError::Empty) => return Poll::Pending,
+                Err(TryRecvError::Disconnected) => None,
+            }
+        };
+        if batch.is_some() {
+            self.received += 1;
+        }
+        Poll::Ready(batch)
+    }
+}
+
+impl Iterator for ConcurrentOdbcReader {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        // An error means the fetch thread dropped the sender, because the cursor is consumed.
+        let batch = self.receiver.as_ref().unwrap().recv().ok();
+        if batch.is_some() {
+            self.received += 1;
+        }
+        batch
+    }
+}
+
+impl Drop for ConcurrentOdbcReader {
+    fn drop(&mut self) {
+        // Hang up first, so the fetch thread stops once it tries to hand over the next batch. Then
+        // wait for it, so the cursor and connection are closed once this reader is freed.
+        self.receiver.take();
+        if let Some(fetch_thread) = self.fetch_thread.take() {
+            // Panics abort the process, so joining can not fail.
+            fetch_thread.join().unwrap();
+        }
+    }
+}
+
+/// Readers which may be moved to the fetch thread of a [`ConcurrentOdbcReader`].
+///
+/// # Safety
+///
+/// The column buffers of an `OdbcReader` are not marked as `Send`, neither are the raw handles
+/// owned by its cursor, yet nothing about them is bound to the thread which allocated them. ODBC
+/// handles may be used from any thread, as long as they are not used concurrently. Implement this
+/// only for readers which own all of their handles and buffers, so moving the reader moves them,
+/// too. Readers sharing them with anything left behind on the calling thread (e.g. a prepared
+/// query) must not implement it.
+pub unsafe trait FetchOnAnyThread: RecordBatchReader + 'static {}
+
+type OwnedCursor = CursorImpl<StatementConnection<'static>>;
+
+unsafe impl FetchOnAnyThread for OdbcReader<OwnedCursor> {}
+unsafe impl FetchOnAnyThread for ZeroCopyReader<OwnedCursor> {}
+unsafe impl FetchOnAnyThread for LobReader<OwnedCursor> {}
+unsafe impl FetchOnAnyThread for RampUpReader<OwnedCursor> {}
+unsafe impl FetchOnAnyThread for AdaptiveReader {}
+unsafe impl FetchOnAnyThread for AttributedReader {}
+// `Send` already, implemented so the batches of Arrow IPC files can be decoded ahead.
+unsafe impl FetchOnAnyThread for FileReader<BufReader<File>> {}
+
+/// Moves a reader into the fetch thread of a [`ConcurrentOdbcReader`].
+struct AssertSend<R>(R);
+
+// Safety: `R` owns all of its buffers and handles, none of which are bound to the calling thread,
+// see [`FetchOnAnyThread`]. The wrapper is moved into the fetch thread as a whole and consumed
+// there. From then on only the fetch thread accesses the reader, until it is dropped at the end of
+// the thread, before `ConcurrentOdbcReader` returns from joining it.
+unsafe impl<R: FetchOnAnyThread> Send for AssertSend<R> {}
+
+impl<R> AssertSend<R> {
+    /// Closures would capture only the inner field if we destructure `self` within them. Consuming
+    /// it with a method makes sure we move the entire wrapper into the thread.
+    fn into_inner(self) -> R {
+        self.0
+    }
+}
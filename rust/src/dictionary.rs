@@ -0,0 +1,151 @@
+use std::{collections::HashMap, sync::Arc};
+
+use arrow_odbc::arrow::{
+    array::{Array, ArrayData, ArrayRef, DictionaryArray, Int32Array, StringArray},
+    buffer::Buffer,
+    datatypes::{DataType, Field, Int32Type, Schema, SchemaRef},
+    error::ArrowError,
+    record_batch::RecordBatch,
+};
+
+/// Replaces text columns of the batches yielded by a reader with dictionary encoded ones. Each
+/// column has one dictionary, which persists across batches. Values keep their keys for the
+/// entire result set, and the dictionary of each batch holds all values seen so far. Each column
+/// may have at most [`MAX_DISTINCT_VALUES`], which bounds the cost of passing the dictionary along
+/// with every batch.
+pub struct DictionaryEncoder {
+    /// Schema of the encoded batches.
+    schema: SchemaRef,
+    /// Index of each encoded column, along with its dictionary.
+    columns: Vec<(usize, Dictionary)>,
+}
+
+impl DictionaryEncoder {
+    /// Encoder for batches with the given schema, without any columns to encode yet.
+    pub fn new(schema: SchemaRef) -> Self {
+        Self {
+            schema,
+            columns: Vec::new(),
+        }
+    }
+
+    /// Dictionary encode the column with the given name from now on. It must be a text column.
+    pub fn add_column(&mut self, name: &str) -> Result<(), String> {
+        let index = self
+            .schema
+            .index_of(name)
+            .map_err(|_| format!("The result set has no column named '{name}'."))?;
+        if self.columns.iter().any(|(encoded, _)| *encoded == index) {
+            return Ok(());
+        }
+        let field = self.schema.field(index);
+        if field.data_type() != &DataType::Utf8 {
+            return Err(format!(
+                "Column '{name}' is of type {:?}. Only text columns can be dictionary encoded.",
+                field.data_type()
+            ));
+        }
+        let mut fields = self.schema.fields().clone();
+        fields[index] = Field::new(
+            name,
+            DataType::Dictionary(Box::new(DataType::Int32), Box::new(DataType::Utf8)),
+            field.is_nullable(),
+        );
+        self.schema = Arc::new(Schema::new_with_metadata(
+            fields,
+            self.schema.metadata().clone(),
+        ));
+        self.columns.push((index, Dictionary::new(name)));
+        Ok(())
+    }
+
+    pub fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+
+    pub fn encode(&mut self, batch: RecordBatch) -> Result<RecordBatch, ArrowError> {
+        let mut columns = batch.columns().to_vec();
+        for (index, dictionary) in &mut self.columns {
+            let text = columns[*index]
+                .as_any()
+                .downcast_ref::<StringArray>()
+                .unwrap();
+            columns[*index] = dictionary.encode(text)?;
+        }
+        RecordBatch::try_new(self.schema.clone(), columns)
+    }
+}
+
+/// Upper bound for the number of distinct values in a dictionary encoded column. Every batch
+/// carries the entire dictionary, so it is copied once for each batch adding new values.
+pub const MAX_DISTINCT_VALUES: usize = 1 << 16;
+
+/// Distinct values of a column, in the order they have been encountered.
+struct Dictionary {
+    /// Name of the column, for error messages.
+    name: String,
+    keys: HashMap<String, i32>,
+    /// Offsets of the values in `data`, in the layout of a `StringArray`. Only ever appended to.
+    offsets: Vec<i32>,
+    /// Concatenated utf-8 bytes of the values.
+    data: Vec<u8>,
+    /// The values as an array, shared by the batches. `None` if new values have been added since
+    /// it has been created.
+    array: Option<ArrayRef>,
+}
+
+impl Dictionary {
+    fn new(name: &str) -> Self {
+        Self {
+            name: name.to_owned(),
+            keys: HashMap::new(),
+            offsets: vec![0],
+            data: Vec::new(),
+            array: None,
+        }
+    }
+
+    fn encode(&mut self, text: &StringArray) -> Result<ArrayRef, ArrowError> {
+        let keys = (0..text.len())
+            .map(|index| {
+                if text.is_null(index) {
+                    Ok(None)
+                } else {
+                    self.key(text.value(index)).map(Some)
+                }
+            })
+            .collect::<Result<Int32Array, ArrowError>>()?;
+        if self.array.is_none() {
+            // Copies the buffers as they are, rather than assembling the values one by one.
+            let values = ArrayData::builder(DataType::Utf8)
+                .len(self.keys.len())
+                .add_buffer(Buffer::from_slice_ref(&self.offsets))
+                .add_buffer(Buffer::from_slice_ref(&self.data))
+                .build()?;
+            self.array = Some(Arc::new(StringArray::from(values)));
+        }
+        let values = self.array.as_ref().unwrap();
+        let encoded = DictionaryArray::<Int32Type>::try_new(&keys, values.as_ref())?;
+        Ok(Arc::new(encoded))
+    }
+
+    fn key(&mut self, value: &str) -> Result<i32, ArrowError> {
+        if let Some(&key) = self.keys.get(value) {
+            return Ok(key);
+        }
+        let end = i32::try_from(self.data.len() + value.len());
+        if self.keys.len() == MAX_DISTINCT_VALUES || end.is_err() {
+            return Err(ArrowError::ComputeError(format!(
+                "Column '{}' exceeds {MAX_DISTINCT_VALUES} distinct values or 2 GiB of text. \
+                Dictionary encoding is meant for columns with few distinct values.",
+                self.name
+            )));
+        }
+        let key = self.keys.len() as i32;
+        self.keys.insert(value.to_owned(), key);
+        self.data.extend_from_slice(value.as_bytes());
+        self.offsets.push(end.unwrap());
+        self.array = None;
+        Ok(key)
+    }
+}
@@ -0,0 +1,200 @@
+//! Helpers for calling into the ODBC C API directly, for functionality `odbc-api` does not offer.
+
+use std::ptr::null_mut;
+
+use arrow_odbc::odbc_api::sys::{
+    CompletionType, FreeStmtOption, HDbc, HStmt, Handle, HandleType, Integer, Pointer, SQLEndTran,
+    SQLFreeStmt, SQLGetDiagRec, SQLSetStmtAttr, SmallInt, SqlReturn, StatementAttribute, ULen,
+    USmallInt,
+};
+
+/// Describes the first diagnostic record associated with the statement handle. Used to generate
+/// error messages, after a call to the C API reported an error.
+///
+/// # Safety
+///
+/// `hstmt` must be a valid statement handle.
+pub unsafe fn statement_error(hstmt: HStmt, function: &str) -> String {
+    diagnostics(HandleType::Stmt, hstmt as Handle, function)
+}
+
+/// Describes the first diagnostic record associated with the connection handle.
+///
+/// # Safety
+///
+/// `hdbc` must be a valid connection handle.
+pub unsafe fn connection_error(hdbc: HDbc, function: &str) -> String {
+    diagnostics(HandleType::Dbc, hdbc as Handle, function)
+}
+
+unsafe fn diagnostics(handle_type: HandleType, handle: Handle, function: &str) -> String {
+    let mut state = [0u8; 6];
+    let mut native_error: Integer = 0;
+    let mut message = [0u8; 512];
+    let mut message_len: SmallInt = 0;
+    let ret = SQLGetDiagRec(
+        handle_type,
+        handle,
+        1,
+        state.as_mut_ptr(),
+        &mut native_error,
+        message.as_mut_ptr(),
+        message.len().try_into().unwrap(),
+        &mut message_len,
+    );
+    match ret {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => {
+            // Message may have been truncated to fit into the buffer.
+            let message_len = (message_len as usize).min(message.len() - 1);
+            format!(
+                "ODBC emitted an error calling '{function}':\nState: {}, Native error: {}, \
+                Message: {}",
+                String::from_utf8_lossy(&state[..5]),
+                native_error,
+                String::from_utf8_lossy(&message[..message_len]),
+            )
+        }
+        _ => format!("ODBC emitted an error calling '{function}'. No diagnostics available."),
+    }
+}
+
+/// Sets a statement attribute.
+///
+/// # Safety
+///
+/// `hstmt` must be a valid statement handle. `value` must be valid for the attribute, i.e. either
+/// an integer value or a pointer which stays valid for as long as the attribute is in use.
+pub unsafe fn set_statement_attribute(
+    hstmt: HStmt,
+    attribute: StatementAttribute,
+    value: Pointer,
+) -> Result<(), String> {
+    match SQLSetStmtAttr(hstmt, attribute, value, 0) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(()),
+        _ => Err(statement_error(hstmt, "SQLSetStmtAttr")),
+    }
+}
+
+/// `StringLength` argument of `SQLSetStmtAttr` and `SQLSetConnectAttr`, telling the driver that
+/// the value is an integer rather than a pointer. Driver specific attributes require it.
+const SQL_IS_INTEGER: Integer = -6;
+
+// Declared with plain integers for the attribute, rather than the enums of `odbc-sys`, so
+// attributes unknown to it, e.g. driver specific ones, can be set as well.
+extern "system" {
+    #[link_name = "SQLSetStmtAttr"]
+    fn sql_set_stmt_attr(
+        hstmt: HStmt,
+        attribute: Integer,
+        value: Pointer,
+        len: Integer,
+    ) -> SqlReturn;
+    #[link_name = "SQLSetConnectAttr"]
+    fn sql_set_connect_attr(
+        hdbc: HDbc,
+        attribute: Integer,
+        value: Pointer,
+        len: Integer,
+    ) -> SqlReturn;
+    #[link_name = "SQLGetInfo"]
+    fn sql_get_info(
+        hdbc: HDbc,
+        info_type: USmallInt,
+        value: Pointer,
+        buffer_len: SmallInt,
+        string_len: *mut SmallInt,
+    ) -> SqlReturn;
+    #[link_name = "SQLSetPos"]
+    fn sql_set_pos(
+        hstmt: HStmt,
+        row_number: ULen,
+        operation: USmallInt,
+        lock_type: USmallInt,
+    ) -> SqlReturn;
+}
+
+/// Sets an integer valued statement attribute, identified by its ODBC constant.
+///
+/// # Safety
+///
+/// `hstmt` must be a valid statement handle.
+pub unsafe fn set_statement_attribute_by_id(
+    hstmt: HStmt,
+    attribute: i32,
+    value: isize,
+) -> Result<(), String> {
+    match sql_set_stmt_attr(hstmt, attribute, value as Pointer, SQL_IS_INTEGER) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(()),
+        _ => Err(statement_error(hstmt, "SQLSetStmtAttr")),
+    }
+}
+
+/// Sets an integer valued connection attribute, identified by its ODBC constant.
+///
+/// # Safety
+///
+/// `hdbc` must be a valid connection handle.
+pub unsafe fn set_connection_attribute_by_id(
+    hdbc: HDbc,
+    attribute: i32,
+    value: isize,
+) -> Result<(), String> {
+    match sql_set_connect_attr(hdbc, attribute, value as Pointer, SQL_IS_INTEGER) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(()),
+        _ => Err(connection_error(hdbc, "SQLSetConnectAttr")),
+    }
+}
+
+/// Retrieves a 32 bit integer valued information about the driver, identified by its ODBC
+/// constant, e.g. a bitmask like `SQL_GETDATA_EXTENSIONS`.
+///
+/// # Safety
+///
+/// `hdbc` must be a valid connection handle. The information must be a 32 bit integer.
+pub unsafe fn get_info_u32(hdbc: HDbc, info_type: u16) -> Result<u32, String> {
+    let mut value: u32 = 0;
+    let value_ptr = &mut value as *mut u32 as Pointer;
+    match sql_get_info(hdbc, info_type, value_ptr, 0, null_mut()) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(value),
+        _ => Err(connection_error(hdbc, "SQLGetInfo")),
+    }
+}
+
+/// Positions the cursor on a row of the current rowset, so `SQLGetData` retrieves the values of
+/// that row. `row` starts at `1`.
+///
+/// # Safety
+///
+/// `hstmt` must be a valid statement handle, which fetched a rowset with at least `row` rows.
+pub unsafe fn position_in_rowset(hstmt: HStmt, row: usize) -> Result<(), String> {
+    // 0 is SQL_POSITION
+    const POSITION: USmallInt = 0;
+    // 0 is SQL_LOCK_NO_CHANGE
+    const LOCK_NO_CHANGE: USmallInt = 0;
+    match sql_set_pos(hstmt, row as ULen, POSITION, LOCK_NO_CHANGE) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(()),
+        _ => Err(statement_error(hstmt, "SQLSetPos")),
+    }
+}
+
+/// Releases all column buffers bound to the statement.
+///
+/// # Safety
+///
+/// `hstmt` must be a valid statement handle.
+pub unsafe fn unbind_columns(hstmt: HStmt) {
+    // Can only fail for invalid handles.
+    SQLFreeStmt(hstmt, FreeStmtOption::Unbind);
+}
+
+/// Commits or rolls back the current transaction of the connection.
+///
+/// # Safety
+///
+/// `hdbc` must be a valid connection handle.
+pub unsafe fn end_transaction(hdbc: HDbc, completion: CompletionType) -> Result<(), String> {
+    match SQLEndTran(HandleType::Dbc, hdbc as Handle, completion) {
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(()),
+        _ => Err(connection_error(hdbc, "SQLEndTran")),
+    }
+}
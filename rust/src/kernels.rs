@@ -0,0 +1,131 @@
+//! Conversion of ODBC date and timestamp structs into the integer representation used by Arrow.
+//!
+//! The loops are free of branches and divisions by runtime values, so the compiler vectorizes
+//! them. They are compiled once for the baseline of the target and, on x86-64, once more with AVX2
+//! enabled, which is chosen at runtime if the CPU supports it. On aarch64 NEON is part of the
+//! baseline.
+
+use std::mem::MaybeUninit;
+
+use arrow_odbc::{
+    arrow::datatypes::TimeUnit,
+    odbc_api::sys::{Date, Timestamp},
+};
+
+/// Converts each date into days since 1970-01-01. Writes every element of `days`, which must be as
+/// long as `dates`.
+pub fn dates_to_days(dates: &[Date], days: &mut [MaybeUninit<i32>]) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") {
+            // Safety: The CPU supports AVX2.
+            return unsafe { dates_to_days_avx2(dates, days) };
+        }
+    }
+    dates_to_days_generic(dates, days)
+}
+
+/// Converts each timestamp into ticks of `unit` since 1970-01-01 00:00:00. The fraction of the
+/// timestamps is given in nanoseconds. Finer parts than `unit` are truncated. Writes every element
+/// of `ticks`, which must be as long as `timestamps`.
+pub fn timestamps_to_ticks(
+    timestamps: &[Timestamp],
+    unit: &TimeUnit,
+    ticks: &mut [MaybeUninit<i64>],
+) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx2") {
+            // Safety: The CPU supports AVX2.
+            return unsafe { timestamps_to_ticks_avx2(timestamps, unit, ticks) };
+        }
+    }
+    timestamps_to_ticks_generic(timestamps, unit, ticks)
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn dates_to_days_avx2(dates: &[Date], days: &mut [MaybeUninit<i32>]) {
+    dates_to_days_generic(dates, days)
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn timestamps_to_ticks_avx2(
+    timestamps: &[Timestamp],
+    unit: &TimeUnit,
+    ticks: &mut [MaybeUninit<i64>],
+) {
+    timestamps_to_ticks_generic(timestamps, unit, ticks)
+}
+
+#[inline(always)]
+fn dates_to_days_generic(dates: &[Date], days: &mut [MaybeUninit<i32>]) {
+    for (date, days) in dates.iter().zip(days) {
+        days.write(days_since_epoch(date.year, date.month, date.day));
+    }
+}
+
+#[inline(always)]
+fn timestamps_to_ticks_generic(
+    timestamps: &[Timestamp],
+    unit: &TimeUnit,
+    ticks: &mut [MaybeUninit<i64>],
+) {
+    // Dispatch once for the entire slice, so the scale factors are constants within the loop.
+    match unit {
+        TimeUnit::Second => scale_timestamps::<1, 1_000_000_000>(timestamps, ticks),
+        TimeUnit::Millisecond => scale_timestamps::<1_000, 1_000_000>(timestamps, ticks),
+        TimeUnit::Microsecond => scale_timestamps::<1_000_000, 1_000>(timestamps, ticks),
+        TimeUnit::Nanosecond => scale_timestamps::<1_000_000_000, 1>(timestamps, ticks),
+    }
+}
+
+#[inline(always)]
+fn scale_timestamps<const TICKS_PER_SECOND: i64, const NANOS_PER_TICK: i64>(
+    timestamps: &[Timestamp],
+    ticks: &mut [MaybeUninit<i64>],
+) {
+    for (timestamp, ticks) in timestamps.iter().zip(ticks) {
+        let value = ticks_since_epoch::<TICKS_PER_SECOND, NANOS_PER_TICK>(timestamp);
+        ticks.write(value);
+    }
+}
+
+/// Ticks since 1970-01-01 00:00:00 of a single timestamp.
+#[inline(always)]
+pub fn ticks_since_epoch<const TICKS_PER_SECOND: i64, const NANOS_PER_TICK: i64>(
+    timestamp: &Timestamp,
+) -> i64 {
+    let days = days_since_epoch(timestamp.year, timestamp.month, timestamp.day) as i64;
+    let seconds = days * 86_400
+        + timestamp.hour as i64 * 3_600
+        + timestamp.minute as i64 * 60
+        + timestamp.second as i64;
+    seconds * TICKS_PER_SECOND + timestamp.fraction as i64 / NANOS_PER_TICK
+}
+
+/// Ticks of `unit` since 1970-01-01 00:00:00 of a single timestamp.
+pub fn ticks_in_unit(timestamp: &Timestamp, unit: &TimeUnit) -> i64 {
+    match unit {
+        TimeUnit::Second => ticks_since_epoch::<1, 1_000_000_000>(timestamp),
+        TimeUnit::Millisecond => ticks_since_epoch::<1_000, 1_000_000>(timestamp),
+        TimeUnit::Microsecond => ticks_since_epoch::<1_000_000, 1_000>(timestamp),
+        TimeUnit::Nanosecond => ticks_since_epoch::<1_000_000_000, 1>(timestamp),
+    }
+}
+
+/// Days since 1970-01-01 in the proleptic gregorian calendar. See
+/// http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+#[inline(always)]
+pub fn days_since_epoch(year: i16, month: u16, day: u16) -> i32 {
+    let month = month as i32;
+    // Years start in March, so the leap day is the last day of the year.
+    let year = year as i32 - (month <= 2) as i32;
+    let era = (if year >= 0 { year } else { year - 399 }) / 400;
+    let year_of_era = year - era * 400;
+    let month_of_year = (month + 9) % 12;
+    let day_of_year = (153 * month_of_year + 2) / 5 + day as i32 - 1;
+    let day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    era * 146_097 + day_of_era - 719_468
+}
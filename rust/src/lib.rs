@@ -1,25 +1,109 @@
 //! Defines C bindings for `arrow-odbc` to enable using it from Python.
 
+mod adaptive;
+mod attributes;
+mod buffer_size;
+mod bulk;
+mod cache;
+mod concurrent;
+mod dictionary;
 mod error;
+mod handles;
+mod kernels;
+mod load;
+mod lob;
+mod notification;
 mod parameter;
+mod partitioned;
+mod pipelined;
+mod pool;
+mod prepared;
+mod ramp_up;
 mod reader;
+mod result_sets;
+mod sink;
+mod statement;
+mod stats;
+mod transaction;
+mod transfer;
+mod watermark;
 mod writer;
+mod zero_copy;
 
-use std::{borrow::Cow, ptr::null_mut, slice, str};
+use std::{
+    borrow::Cow,
+    ptr::{null_mut, NonNull},
+    slice, str,
+    sync::atomic::{AtomicBool, Ordering},
+};
 
-use arrow_odbc::odbc_api::{escape_attribute_value, Connection, Environment};
+use arrow_odbc::odbc_api::{
+    escape_attribute_value, sys::AttrConnectionPooling, Connection, Environment,
+};
 use lazy_static::lazy_static;
 
+pub use attributes::ArrowOdbcAttribute;
+pub use cache::{
+    arrow_odbc_cache_clear, arrow_odbc_cache_lookup, arrow_odbc_cache_set_max_bytes,
+    arrow_odbc_reader_cache,
+};
 pub use error::{arrow_odbc_error_free, arrow_odbc_error_message, ArrowOdbcError};
+pub use load::{
+    arrow_odbc_parquet_schema, arrow_odbc_writer_write_ipc, arrow_odbc_writer_write_parquet,
+};
+pub use prepared::{
+    arrow_odbc_prepared_query_execute, arrow_odbc_prepared_query_free,
+    arrow_odbc_prepared_query_make, ArrowOdbcPreparedQuery,
+};
 pub use reader::{
-    arrow_odbc_reader_free, arrow_odbc_reader_make, arrow_odbc_reader_next, ArrowOdbcReader,
+    arrow_odbc_reader_batch_size, arrow_odbc_reader_dictionary_encode, arrow_odbc_reader_free,
+    arrow_odbc_reader_make, arrow_odbc_reader_next, arrow_odbc_reader_next_result_set,
+    arrow_odbc_reader_notify, arrow_odbc_reader_stats, arrow_odbc_reader_track_watermark,
+    arrow_odbc_reader_try_next, arrow_odbc_reader_watermark, ArrowOdbcReader,
+    ArrowOdbcReaderOptions,
 };
+pub use sink::{arrow_odbc_reader_write_ipc, arrow_odbc_reader_write_parquet};
+pub use stats::{ArrowOdbcReaderStats, ArrowOdbcWriterStats};
+pub use transfer::arrow_odbc_copy_table;
 pub use writer::{
-    arrow_odbc_writer_free, arrow_odbc_writer_make, arrow_odbc_writer_write_batch, ArrowOdbcWriter,
+    arrow_odbc_writer_free, arrow_odbc_writer_make, arrow_odbc_writer_make_parallel,
+    arrow_odbc_writer_make_with_statement, arrow_odbc_writer_notify, arrow_odbc_writer_poll,
+    arrow_odbc_writer_stats, arrow_odbc_writer_try_flush, arrow_odbc_writer_try_write_batch,
+    arrow_odbc_writer_write_batch, ArrowOdbcWriter,
 };
 
+/// `true` once the ODBC environment has been allocated. Settings like connection pooling must be
+/// applied before that.
+static ENV_ALLOCATED: AtomicBool = AtomicBool::new(false);
+
 lazy_static! {
-    static ref ENV: Environment = Environment::new().unwrap();
+    static ref ENV: Environment = {
+        ENV_ALLOCATED.store(true, Ordering::SeqCst);
+        Environment::new().unwrap()
+    };
+}
+
+/// Enables connection pooling by the ODBC driver manager. Connections are no longer closed then
+/// they are freed, but returned to a pool. Later requests to connect with an identical connection
+/// string reuse a connection from the pool, rather than establishing a new one.
+///
+/// Must be called before the first connection is opened, otherwise an error is returned.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_enable_connection_pooling() -> *mut ArrowOdbcError {
+    if ENV_ALLOCATED.load(Ordering::SeqCst) {
+        return ArrowOdbcError::new(
+            "Connection pooling must be enabled before the first connection is opened.",
+        )
+        .into_raw();
+    }
+    // One pool for our one environment.
+    //
+    // Safety: Pooling is configured before the environment is allocated and no driver has been
+    // loaded yet.
+    try_!(unsafe { Environment::set_connection_pooling(AttrConnectionPooling::OnePerHenv) });
+    // Allocate environment now, so it is guaranteed to be affected by the setting.
+    lazy_static::initialize(&ENV);
+    null_mut()
 }
 
 /// Opaque type to transport connection to an ODBC Datasource over language boundry
@@ -55,6 +139,17 @@ pub unsafe extern "C" fn arrow_odbc_connect_with_connection_string(
     null_mut()
 }
 
+/// Closes the connection and frees its associated resources. Only required for connections which
+/// have not been passed to a function taking ownership of them.
+///
+/// # Safety
+///
+/// `connection` must point to a valid OdbcConnection.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_connection_free(connection: NonNull<OdbcConnection>) {
+    Box::from_raw(connection.as_ptr());
+}
+
 /// Append attribute like user and value to connection string
 unsafe fn append_attribute(
     attribute_name: &'static str,
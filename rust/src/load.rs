@@ -0,0 +1,209 @@
+use std::{
+    ffi::c_void,
+    fs::File,
+    io::BufReader,
+    path::Path,
+    ptr::{null_mut, NonNull},
+    sync::{
+        mpsc::{sync_channel, Receiver},
+        Arc,
+    },
+    thread::{self, JoinHandle},
+};
+
+use arrow_odbc::arrow::{
+    datatypes::Schema, error::ArrowError, ffi::FFI_ArrowSchema, ipc::reader::FileReader,
+    record_batch::RecordBatch,
+};
+use parquet::{
+    arrow::{arrow_reader::ParquetRecordBatchReader, ArrowReader, ParquetFileArrowReader},
+    errors::ParquetError,
+    file::serialized_reader::{ReadOptionsBuilder, SerializedFileReader},
+};
+
+use crate::{
+    concurrent::ConcurrentOdbcReader, sink::path_from_raw, try_, writer::ArrowOdbcWriter,
+    ArrowOdbcError,
+};
+
+/// Decodes the row groups of a Parquet file on several system threads. Each thread opens the file
+/// on its own and decodes every n-th row group, so batches are not yielded in the order of the
+/// file.
+struct ParquetBatches {
+    /// Only `None` during drop, so we can hang up on the decoding threads before joining them.
+    receiver: Option<Receiver<Result<RecordBatch, ArrowError>>>,
+    decode_threads: Vec<JoinHandle<()>>,
+}
+
+impl ParquetBatches {
+    /// `num_threads` of `0` is treated like `1`.
+    fn new(path: &Path, batch_size: usize, num_threads: usize) -> Self {
+        let num_threads = num_threads.max(1);
+        // One batch waiting per thread keeps all of them busy, while the consumer inserts.
+        let (sender, receiver) = sync_channel(num_threads);
+        let decode_threads = (0..num_threads)
+            .map(|index| {
+                let sender = sender.clone();
+                let path = path.to_path_buf();
+                thread::spawn(move || {
+                    let batches = match row_groups(&path, batch_size, index, num_threads) {
+                        Ok(batches) => batches,
+                        Err(error) => {
+                            let _ = sender.send(Err(error));
+                            return;
+                        }
+                    };
+                    for batch in batches {
+                        if sender.send(batch).is_err() {
+                            // Receiver hung up. No need to decode any more batches.
+                            break;
+                        }
+                    }
+                })
+            })
+            .collect();
+        Self {
+            receiver: Some(receiver),
+            decode_threads,
+        }
+    }
+}
+
+impl Iterator for ParquetBatches {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        // An error means all decoding threads dropped their senders, because they are done.
+        self.receiver.as_ref().unwrap().recv().ok()
+    }
+}
+
+impl Drop for ParquetBatches {
+    fn drop(&mut self) {
+        self.receiver.take();
+        for decode_thread in self.decode_threads.drain(..) {
+            // Panics abort the process, so joining can not fail.
+            decode_thread.join().unwrap();
+        }
+    }
+}
+
+/// Batches of every `num_threads`-th row group, starting with the one at `index`.
+fn row_groups(
+    path: &Path,
+    batch_size: usize,
+    index: usize,
+    num_threads: usize,
+) -> Result<ParquetRecordBatchReader, ArrowError> {
+    let file = File::open(path)?;
+    let options = ReadOptionsBuilder::new()
+        .with_predicate(Box::new(move |_, row_group| {
+            row_group % num_threads == index
+        }))
+        .build();
+    let file_reader = SerializedFileReader::new_with_options(file, options).map_err(external)?;
+    let mut arrow_reader = ParquetFileArrowReader::new(Arc::new(file_reader));
+    arrow_reader.get_record_reader(batch_size).map_err(external)
+}
+
+fn external(error: ParquetError) -> ArrowError {
+    ArrowError::ExternalError(Box::new(error))
+}
+
+/// Arrow schema of the batches decoded from a Parquet file. Used to create a writer for
+/// [`arrow_odbc_writer_write_parquet`], as the schema inferred by other implementations may
+/// differ, e.g. for files written without an embedded Arrow schema.
+///
+/// # Safety
+///
+/// * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+/// * `path_len` describes the len of `path_buf` in bytes.
+/// * `schema_out` must point to a valid `FFI_ArrowSchema`, which is overwritten.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_parquet_schema(
+    path_buf: *const u8,
+    path_len: usize,
+    schema_out: *mut c_void,
+) -> *mut ArrowOdbcError {
+    let path = try_!(path_from_raw(path_buf, path_len));
+
+    let file = try_!(File::open(path));
+    let file_reader = try_!(SerializedFileReader::new(file));
+    let schema: Schema = try_!(ParquetFileArrowReader::new(Arc::new(file_reader)).get_schema());
+    let schema_ffi = try_!((&schema).try_into());
+    *(schema_out as *mut FFI_ArrowSchema) = schema_ffi;
+    null_mut() // Ok(())
+}
+
+/// Decodes a Parquet file and passes its batches to the writer. Row groups are decoded by
+/// `num_threads` system threads, while the calling thread hands the batches to the writer. The
+/// batches never leave Rust, so they do not need to be imported over the C Data Interface. The
+/// writer is not flushed.
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`crate::arrow_odbc_writer_make`] or
+///   [`crate::arrow_odbc_writer_make_parallel`] with the schema reported by
+///   [`arrow_odbc_parquet_schema`].
+/// * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+/// * `path_len` describes the len of `path_buf` in bytes.
+/// * `batch_size` maximum number of rows in each decoded batch.
+/// * `num_threads` number of threads decoding row groups. `0` is treated like `1`.
+/// * `rows_out` in case of success this will hold the number of rows passed to the writer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_write_parquet(
+    mut writer: NonNull<ArrowOdbcWriter>,
+    path_buf: *const u8,
+    path_len: usize,
+    batch_size: usize,
+    num_threads: usize,
+    rows_out: *mut u64,
+) -> *mut ArrowOdbcError {
+    let path = try_!(path_from_raw(path_buf, path_len));
+
+    let batches = ParquetBatches::new(path, batch_size, num_threads);
+    *rows_out = try_!(write_all(writer.as_mut(), batches));
+    null_mut() // Ok(())
+}
+
+/// Decodes an Arrow IPC file and passes its batches to the writer. The next batch is decoded by a
+/// dedicated system thread, while the calling thread hands the previous one to the writer. The
+/// writer is not flushed.
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`crate::arrow_odbc_writer_make`] or
+///   [`crate::arrow_odbc_writer_make_parallel`] with the schema of the file.
+/// * `path_buf` must point to the path of the file, encoded like `os.fsencode` does.
+/// * `path_len` describes the len of `path_buf` in bytes.
+/// * `rows_out` in case of success this will hold the number of rows passed to the writer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_write_ipc(
+    mut writer: NonNull<ArrowOdbcWriter>,
+    path_buf: *const u8,
+    path_len: usize,
+    rows_out: *mut u64,
+) -> *mut ArrowOdbcError {
+    let path = try_!(path_from_raw(path_buf, path_len));
+
+    let file = BufReader::new(try_!(File::open(path)));
+    let reader = try_!(FileReader::try_new(file, None));
+    let batches = ConcurrentOdbcReader::new(reader, 1);
+    *rows_out = try_!(write_all(writer.as_mut(), batches));
+    null_mut() // Ok(())
+}
+
+/// Returns the number of rows written.
+fn write_all(
+    writer: &mut ArrowOdbcWriter,
+    batches: impl Iterator<Item = Result<RecordBatch, ArrowError>>,
+) -> Result<u64, String> {
+    let mut num_rows = 0;
+    for batch in batches {
+        let batch = batch.map_err(|error| error.to_string())?;
+        num_rows += batch.num_rows() as u64;
+        writer.count_batch(&batch);
+        writer.write_batch(batch)?;
+    }
+    Ok(num_rows)
+}
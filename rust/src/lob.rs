@@ -0,0 +1,807 @@
+use std::{
+    cmp::{max, min},
+    mem::{size_of, MaybeUninit},
+    ptr::{null_mut, read_unaligned},
+    sync::Arc,
+};
+
+use arrow_odbc::{
+    arrow::{
+        array::{
+            ArrayRef, BinaryArray, BooleanArray, Date32Array, Float32Array, Float64Array,
+            Int16Array, Int32Array, Int64Array, Int8Array, LargeBinaryArray, LargeStringArray,
+            StringArray, TimestampMicrosecondArray, TimestampMillisecondArray,
+            TimestampNanosecondArray, TimestampSecondArray, UInt8Array,
+        },
+        datatypes::{DataType, Field, Schema, SchemaRef, TimeUnit},
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::{
+        handles::{AsStatementRef, Statement},
+        sys::{
+            CDataType, Date, HStmt, Len, Pointer, SQLBindCol, SQLFetch, SQLGetData, SqlReturn,
+            StatementAttribute, Timestamp, ULen, NO_TOTAL, NULL_DATA,
+        },
+        Connection, Cursor, Error, ResultSetMetadata,
+    },
+};
+
+use crate::{
+    handles::{
+        get_info_u32, position_in_rowset, set_statement_attribute, statement_error, unbind_columns,
+    },
+    kernels::{days_since_epoch, ticks_in_unit},
+    ramp_up::RampUp,
+};
+
+/// `SQL_GETDATA_EXTENSIONS`
+const SQL_GETDATA_EXTENSIONS: u16 = 81;
+/// `SQLGetData` may be called for unbound columns preceding a bound one.
+const SQL_GD_ANY_COLUMN: u32 = 1;
+/// `SQLGetData` may be called for the rows of a block cursor, once it is positioned on them.
+const SQL_GD_BLOCK: u32 = 4;
+
+/// Text or binary columns, which are larger than `lob_threshold` or whose size the driver can not
+/// tell. `None` if there is no such column, i.e. the result set can be fetched the usual way.
+pub fn large_columns(
+    cursor: &mut impl ResultSetMetadata,
+    schema: &Schema,
+    lob_threshold: usize,
+) -> Result<Option<Vec<bool>>, Error> {
+    let mut large = Vec::with_capacity(schema.fields().len());
+    for (index, field) in schema.fields().iter().enumerate() {
+        let is_variadic = matches!(field.data_type(), DataType::Utf8 | DataType::Binary);
+        let column_size = cursor.col_data_type((index + 1) as u16)?.column_size();
+        large.push(is_variadic && (column_size == 0 || column_size > lob_threshold));
+    }
+    Ok(if large.contains(&true) {
+        Some(large)
+    } else {
+        None
+    })
+}
+
+/// Asks the driver of the connection which restrictions of `SQLGetData` it lifts
+/// (`SQL_GETDATA_EXTENSIONS`), see [`LobReader::with_block_fetch`]. Takes the connection and hands
+/// it back, in order to get hold of its handle.
+pub fn getdata_extensions(
+    connection: Connection<'static>,
+) -> Result<(Connection<'static>, u32), String> {
+    let hdbc = connection.into_sys();
+    // Safety: We own the handle, which is valid, since it belongs to an open connection. It is
+    // owned by a connection again, before any error is returned, so it is freed in any case.
+    let connection = unsafe { Connection::from_handle(hdbc) };
+    let extensions = unsafe { get_info_u32(hdbc, SQL_GETDATA_EXTENSIONS)? };
+    Ok((connection, extensions))
+}
+
+/// Fetches result sets with large text or binary columns (LOBs). Instead of binding buffers which
+/// could hold the largest value of each column for every row of a batch, values are retrieved with
+/// `SQLGetData` in chunks, until they are complete. So each value takes only as much memory as it
+/// needs.
+///
+/// Drivers need not support `SQLGetData` for block cursors, nor for columns preceding a bound
+/// column. So by default all columns are retrieved this way and rows are fetched one by one. If
+/// the driver lifts these restrictions, see [`Self::with_block_fetch`], the other columns are
+/// bound to buffers and a block of rows is fetched at once. Only the LOBs are retrieved row by row
+/// then.
+pub struct LobReader<C> {
+    /// Declared before the cursor, so the buffers are unbound before the cursor is dropped.
+    block: Option<BlockFetch>,
+    cursor: C,
+    rows: RowFetcher,
+}
+
+impl<C> LobReader<C>
+where
+    C: Cursor,
+{
+    /// Fetches one row at a time. See [`RowFetcher::new`].
+    pub fn new(
+        cursor: C,
+        schema: &Schema,
+        large: &[bool],
+        batch_size: usize,
+    ) -> Result<Self, String> {
+        Ok(Self {
+            block: None,
+            cursor,
+            rows: RowFetcher::new(schema, large, batch_size)?,
+        })
+    }
+
+    /// Starts out with smaller batches, growing up to the batch size.
+    pub fn with_ramp_up(mut self, ramp_up: RampUp) -> Self {
+        self.rows = self.rows.with_ramp_up(ramp_up);
+        self
+    }
+
+    /// Binds the columns which are not LOBs to buffers and fetches blocks of rows, if the driver
+    /// supports `SQLGetData` for them. `getdata_extensions` is the bitmask reported by the driver,
+    /// see [`getdata_extensions`]. With `SQL_GD_BLOCK` the LOBs of each row are retrieved after
+    /// positioning the cursor on it. Without `SQL_GD_ANY_COLUMN` only the columns preceding the
+    /// first LOB are bound, since `SQLGetData` can not be called for columns before a bound one.
+    /// Rows are still fetched one at a time, if the driver reports neither, or if no column can be
+    /// bound. Must be called before the first batch is fetched.
+    pub fn with_block_fetch(mut self, getdata_extensions: u32) -> Result<Self, String> {
+        if getdata_extensions & SQL_GD_BLOCK == 0 {
+            return Ok(self);
+        }
+        let any_column = getdata_extensions & SQL_GD_ANY_COLUMN != 0;
+        let mut bindable = Vec::new();
+        for (index, field) in self.rows.schema.fields().iter().enumerate() {
+            let column_size = self
+                .cursor
+                .col_data_type((index + 1) as u16)
+                .map_err(|error| error.to_string())?
+                .column_size();
+            match bind_type(field.data_type(), column_size) {
+                Some(bind) => bindable.push((index, bind)),
+                None if any_column => (),
+                None => break,
+            }
+        }
+        if bindable.is_empty() {
+            return Ok(self);
+        }
+        let hstmt = self.cursor.as_stmt_ref().as_sys();
+        let num_cols = self.rows.schema.fields().len();
+        let capacity = self.rows.ramp_up.max_size();
+        // Safety: The statement of the cursor stays valid, as long as the block, which is dropped
+        // before the cursor.
+        self.block = Some(unsafe { BlockFetch::new(hstmt, &bindable, num_cols, capacity)? });
+        Ok(self)
+    }
+
+    /// `true` once all following batches have the full batch size.
+    pub fn is_ramped_up(&self) -> bool {
+        self.rows.ramp_up.is_complete()
+    }
+
+    /// `true` once the cursor reported that there are no more rows.
+    pub fn is_exhausted(&self) -> bool {
+        self.rows.exhausted
+    }
+
+    /// Number of rows the next batch is going to have at most.
+    pub fn next_batch_size(&self) -> usize {
+        self.rows.ramp_up.peek_size()
+    }
+
+    /// Size of the buffers bound to the cursor, in case blocks of rows are fetched.
+    pub fn buffer_bytes(&self) -> usize {
+        self.block.as_ref().map_or(0, BlockFetch::buffer_bytes)
+    }
+
+    /// Gives up the cursor, e.g. to bind buffers to it.
+    pub fn into_cursor(self) -> C {
+        let Self { block, cursor, .. } = self;
+        // Unbinds our buffers, before anyone else gets to fetch from the cursor.
+        drop(block);
+        cursor
+    }
+}
+
+/// State of a [`LobReader`] in between batches, without the cursor. Used by readers which can not
+/// hold on to a cursor, but create it anew for each batch.
+pub struct RowFetcher {
+    schema: SchemaRef,
+    /// Number of rows of the next batch.
+    ramp_up: RampUp,
+    /// `true` once the cursor reported that there are no more rows.
+    exhausted: bool,
+    /// Reused for retrieving text and binary values.
+    buffer: Vec<u8>,
+}
+
+impl RowFetcher {
+    /// `schema` is the one of the result set and `large` indicates which of its columns are LOBs,
+    /// see [`large_columns`]. LOBs are returned as `LargeUtf8` or `LargeBinary`. Fails for columns
+    /// of types which can not be retrieved directly, see [`is_supported`].
+    pub fn new(schema: &Schema, large: &[bool], batch_size: usize) -> Result<Self, String> {
+        let fields = schema
+            .fields()
+            .iter()
+            .zip(large)
+            .map(|(field, &large)| {
+                let data_type = match field.data_type() {
+                    DataType::Utf8 if large => DataType::LargeUtf8,
+                    DataType::Binary if large => DataType::LargeBinary,
+                    data_type if is_supported(data_type) => data_type.clone(),
+                    other => {
+                        return Err(format!(
+                            "Column '{}' is of type {other:?}, which can not be retrieved with \
+                            SQLGetData. Pass a schema mapping it to a supported type, e.g. to \
+                            text.",
+                            field.name()
+                        ))
+                    }
+                };
+                Ok(Field::new(field.name(), data_type, field.is_nullable()))
+            })
+            .collect::<Result<_, String>>()?;
+        Ok(Self {
+            schema: Arc::new(Schema::new(fields)),
+            ramp_up: RampUp::fixed(batch_size),
+            exhausted: false,
+            buffer: Vec::new(),
+        })
+    }
+
+    fn with_ramp_up(mut self, ramp_up: RampUp) -> Self {
+        self.ramp_up = ramp_up;
+        self
+    }
+
+    pub fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+
+    /// Fetches the next batch from `cursor` one row at a time, retrieving every value with
+    /// `SQLGetData`. The cursor must be positioned on the same result set for every call and
+    /// must not have any buffers bound to it.
+    pub fn next_batch(
+        &mut self,
+        cursor: &mut impl Cursor,
+    ) -> Result<Option<RecordBatch>, ArrowError> {
+        if self.exhausted {
+            return Ok(None);
+        }
+        let hstmt = cursor.as_stmt_ref().as_sys();
+        let batch_size = self.ramp_up.next_size();
+        let mut columns = self.new_columns(batch_size);
+        let mut num_rows = 0;
+        while num_rows < batch_size && !self.exhausted {
+            // Safety: The cursor is positioned on a result set, without buffers bound to it.
+            match unsafe { SQLFetch(hstmt) } {
+                SqlReturn::NO_DATA => self.exhausted = true,
+                SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => {
+                    for (index, column) in columns.iter_mut().enumerate() {
+                        // Safety: The cursor is positioned on the row just fetched.
+                        unsafe { column.fetch(hstmt, (index + 1) as u16, &mut self.buffer) }
+                            .map_err(external)?;
+                    }
+                    num_rows += 1;
+                }
+                _ => return Err(external(unsafe { statement_error(hstmt, "SQLFetch") })),
+            }
+        }
+        if num_rows == 0 {
+            return Ok(None);
+        }
+        self.finish(columns).map(Some)
+    }
+
+    /// Fetches the next batch as a block of rows into the buffers of `block`. The columns which
+    /// are not bound are retrieved with `SQLGetData`, after positioning the cursor on each row.
+    fn next_block(&mut self, block: &mut BlockFetch) -> Result<Option<RecordBatch>, ArrowError> {
+        if self.exhausted {
+            return Ok(None);
+        }
+        let hstmt = block.hstmt;
+        let capacity = min(self.ramp_up.next_size(), block.capacity);
+        if capacity != block.row_array_size {
+            unsafe {
+                set_statement_attribute(
+                    hstmt,
+                    StatementAttribute::RowArraySize,
+                    capacity as Pointer,
+                )
+            }
+            .map_err(external)?;
+            block.row_array_size = capacity;
+        }
+        // Safety: The buffers bound to the statement hold `block.capacity` rows.
+        match unsafe { SQLFetch(hstmt) } {
+            SqlReturn::NO_DATA => {
+                self.exhausted = true;
+                return Ok(None);
+            }
+            SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => (),
+            _ => return Err(external(unsafe { statement_error(hstmt, "SQLFetch") })),
+        }
+        let num_rows = *block.num_rows_fetched;
+        let mut columns = self.new_columns(num_rows);
+        for row in 0..num_rows {
+            // Safety: The rowset just fetched has `num_rows` rows. The unbound columns are
+            // retrieved in ascending order, which any driver supports.
+            unsafe { position_in_rowset(hstmt, row + 1) }.map_err(external)?;
+            for &index in &block.unbound {
+                unsafe { columns[index].fetch(hstmt, (index + 1) as u16, &mut self.buffer) }
+                    .map_err(external)?;
+            }
+        }
+        for bound in &block.bound {
+            for row in 0..num_rows {
+                columns[bound.index].push_bound(bound, row);
+            }
+        }
+        self.finish(columns).map(Some)
+    }
+
+    fn new_columns(&self, capacity: usize) -> Vec<Column> {
+        self.schema
+            .fields()
+            .iter()
+            .map(|field| Column::new(field.data_type(), capacity))
+            .collect()
+    }
+
+    fn finish(&self, columns: Vec<Column>) -> Result<RecordBatch, ArrowError> {
+        let arrays = columns.into_iter().map(Column::finish).collect();
+        RecordBatch::try_new(self.schema.clone(), arrays)
+    }
+}
+
+impl<C> Iterator for LobReader<C>
+where
+    C: Cursor,
+{
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        match &mut self.block {
+            Some(block) => self.rows.next_block(block),
+            None => self.rows.next_batch(&mut self.cursor),
+        }
+        .transpose()
+    }
+}
+
+impl<C> RecordBatchReader for LobReader<C>
+where
+    C: Cursor,
+{
+    fn schema(&self) -> SchemaRef {
+        self.rows.schema()
+    }
+}
+
+/// `true` if values of this type can be retrieved by a [`RowFetcher`].
+pub fn is_supported(data_type: &DataType) -> bool {
+    matches!(
+        data_type,
+        DataType::Boolean
+            | DataType::Int8
+            | DataType::Int16
+            | DataType::Int32
+            | DataType::Int64
+            | DataType::UInt8
+            | DataType::Float32
+            | DataType::Float64
+            | DataType::Date32
+            | DataType::Timestamp(_, None)
+            | DataType::Utf8
+            | DataType::Binary
+    )
+}
+
+/// Replaces the types of fields which can not be retrieved directly with text, so the driver
+/// converts their values, e.g. decimals, to text. For schemas inferred by us, rather than chosen
+/// by the caller.
+pub fn unsupported_as_text(schema: &Schema) -> Schema {
+    let fields = schema
+        .fields()
+        .iter()
+        .map(|field| {
+            if is_supported(field.data_type()) {
+                field.clone()
+            } else {
+                Field::new(field.name(), DataType::Utf8, field.is_nullable())
+            }
+        })
+        .collect();
+    Schema::new(fields)
+}
+
+/// C type and size in bytes of a single value, to bind a column to. `column_size` is the one
+/// reported by the driver. `None` if the column is retrieved with `SQLGetData` instead, i.e. for
+/// LOBs and text or binary columns of unknown size.
+fn bind_type(data_type: &DataType, column_size: usize) -> Option<(CDataType, usize)> {
+    let bind_type = match data_type {
+        DataType::Boolean => (CDataType::Bit, size_of::<u8>()),
+        DataType::Int8 => (CDataType::STinyInt, size_of::<i8>()),
+        DataType::Int16 => (CDataType::SShort, size_of::<i16>()),
+        DataType::Int32 => (CDataType::SLong, size_of::<i32>()),
+        DataType::Int64 => (CDataType::SBigInt, size_of::<i64>()),
+        DataType::UInt8 => (CDataType::UTinyInt, size_of::<u8>()),
+        DataType::Float32 => (CDataType::Float, size_of::<f32>()),
+        DataType::Float64 => (CDataType::Double, size_of::<f64>()),
+        DataType::Date32 => (CDataType::TypeDate, size_of::<Date>()),
+        DataType::Timestamp(_, None) => (CDataType::TypeTimestamp, size_of::<Timestamp>()),
+        // One character may take up to four bytes of UTF-8, plus the terminating zero.
+        DataType::Utf8 if column_size != 0 => (CDataType::Char, column_size * 4 + 1),
+        DataType::Binary if column_size != 0 => (CDataType::Binary, column_size),
+        _ => return None,
+    };
+    Some(bind_type)
+}
+
+/// Columns bound to buffers for a block of rows, while the other columns are retrieved with
+/// `SQLGetData`. Unbinds the buffers once dropped.
+struct BlockFetch {
+    hstmt: HStmt,
+    bound: Vec<BoundColumn>,
+    /// Positions of the columns retrieved with `SQLGetData`, in ascending order.
+    unbound: Vec<usize>,
+    /// Number of rows the buffers can hold.
+    capacity: usize,
+    /// Value of `SQL_ATTR_ROW_ARRAY_SIZE`, i.e. the number of rows fetched at once.
+    row_array_size: usize,
+    /// Written to by the driver in every fetch. Boxed, so the address stays valid, even if the
+    /// reader is moved.
+    num_rows_fetched: Box<ULen>,
+}
+
+impl BlockFetch {
+    /// Binds buffers holding `capacity` rows to the `bindable` columns, which are given with
+    /// their position and the type to bind them as.
+    ///
+    /// # Safety
+    ///
+    /// `hstmt` must be a valid statement handle, positioned on a result set with `num_cols`
+    /// columns. It must outlive the returned instance.
+    unsafe fn new(
+        hstmt: HStmt,
+        bindable: &[(usize, (CDataType, usize))],
+        num_cols: usize,
+        capacity: usize,
+    ) -> Result<Self, String> {
+        let unbound = (0..num_cols)
+            .filter(|index| bindable.iter().all(|(bound, _)| bound != index))
+            .collect();
+        // Created before binding anything, so the buffers are unbound again in case of an error.
+        let mut block = Self {
+            hstmt,
+            bound: Vec::with_capacity(bindable.len()),
+            unbound,
+            capacity,
+            row_array_size: capacity,
+            num_rows_fetched: Box::new(0),
+        };
+        // 0 is SQL_BIND_BY_COLUMN
+        set_statement_attribute(hstmt, StatementAttribute::RowBindType, 0 as Pointer)?;
+        set_statement_attribute(hstmt, StatementAttribute::RowArraySize, capacity as Pointer)?;
+        set_statement_attribute(
+            hstmt,
+            StatementAttribute::RowsFetchedPtr,
+            block.num_rows_fetched.as_mut() as *mut ULen as Pointer,
+        )?;
+        for &(index, (c_type, width)) in bindable {
+            let mut column = BoundColumn {
+                index,
+                width,
+                terminator: usize::from(matches!(c_type, CDataType::Char)),
+                values: vec![0; width * capacity],
+                indicators: vec![0; capacity],
+            };
+            let ret = SQLBindCol(
+                hstmt,
+                (index + 1).try_into().unwrap(),
+                c_type,
+                column.values.as_mut_ptr() as Pointer,
+                width as Len,
+                column.indicators.as_mut_ptr(),
+            );
+            if !matches!(ret, SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO) {
+                return Err(statement_error(hstmt, "SQLBindCol"));
+            }
+            // Moving the column does not move the heap memory of its buffers.
+            block.bound.push(column);
+        }
+        Ok(block)
+    }
+
+    fn buffer_bytes(&self) -> usize {
+        self.bound
+            .iter()
+            .map(|column| column.values.len() + column.indicators.len() * size_of::<Len>())
+            .sum()
+    }
+}
+
+impl Drop for BlockFetch {
+    fn drop(&mut self) {
+        // The statement may outlive the buffers. It must neither write into them, nor to
+        // `num_rows_fetched`, nor fetch blocks of rows, once we are gone.
+        let hstmt = self.hstmt;
+        unsafe {
+            unbind_columns(hstmt);
+            let _ = set_statement_attribute(hstmt, StatementAttribute::RowsFetchedPtr, null_mut());
+            let _ = set_statement_attribute(hstmt, StatementAttribute::RowArraySize, 1 as Pointer);
+        }
+    }
+}
+
+/// Buffers bound to a single column, receiving its values for a block of rows.
+struct BoundColumn {
+    /// Position of the column in the batch, starting at `0`.
+    index: usize,
+    /// Size of a single value in bytes, including the terminating zero of text.
+    width: usize,
+    /// `1` for text, which is terminated by a zero, `0` otherwise.
+    terminator: usize,
+    values: Vec<u8>,
+    indicators: Vec<Len>,
+}
+
+impl BoundColumn {
+    /// Fixed size value of `row`. `T` must be the type the driver writes for the bound C type.
+    fn fixed<T: Copy>(&self, row: usize) -> Option<T> {
+        if self.indicators[row] == NULL_DATA {
+            return None;
+        }
+        // Safety: The driver wrote a value of type `T` at this position. The buffer is not
+        // aligned for `T`, though.
+        Some(unsafe { read_unaligned(self.values[row * self.width..].as_ptr() as *const T) })
+    }
+
+    /// Text or binary value of `row`, without the terminating zero.
+    fn bytes(&self, row: usize) -> Option<&[u8]> {
+        let indicator = self.indicators[row];
+        if indicator == NULL_DATA {
+            return None;
+        }
+        // The column size reported by the driver rules out longer values, yet we must not read
+        // beyond the value, should it have been truncated anyway.
+        let max_len = self.width - self.terminator;
+        let len = if indicator == NO_TOTAL {
+            max_len
+        } else {
+            min(indicator as usize, max_len)
+        };
+        let start = row * self.width;
+        Some(&self.values[start..start + len])
+    }
+}
+
+/// Values of a single column of the batch, collected row by row.
+enum Column {
+    Boolean(Vec<Option<bool>>),
+    Int8(Vec<Option<i8>>),
+    Int16(Vec<Option<i16>>),
+    Int32(Vec<Option<i32>>),
+    Int64(Vec<Option<i64>>),
+    UInt8(Vec<Option<u8>>),
+    Float32(Vec<Option<f32>>),
+    Float64(Vec<Option<f64>>),
+    Date32(Vec<Option<i32>>),
+    Timestamp(TimeUnit, Vec<Option<i64>>),
+    Text {
+        large: bool,
+        values: Vec<Option<String>>,
+    },
+    Binary {
+        large: bool,
+        values: Vec<Option<Vec<u8>>>,
+    },
+}
+
+impl Column {
+    /// Must only be called for supported types and LOBs.
+    fn new(data_type: &DataType, capacity: usize) -> Self {
+        match data_type {
+            DataType::Boolean => Column::Boolean(Vec::with_capacity(capacity)),
+            DataType::Int8 => Column::Int8(Vec::with_capacity(capacity)),
+            DataType::Int16 => Column::Int16(Vec::with_capacity(capacity)),
+            DataType::Int32 => Column::Int32(Vec::with_capacity(capacity)),
+            DataType::Int64 => Column::Int64(Vec::with_capacity(capacity)),
+            DataType::UInt8 => Column::UInt8(Vec::with_capacity(capacity)),
+            DataType::Float32 => Column::Float32(Vec::with_capacity(capacity)),
+            DataType::Float64 => Column::Float64(Vec::with_capacity(capacity)),
+            DataType::Date32 => Column::Date32(Vec::with_capacity(capacity)),
+            DataType::Timestamp(unit, _) => {
+                Column::Timestamp(unit.clone(), Vec::with_capacity(capacity))
+            }
+            DataType::Binary | DataType::LargeBinary => Column::Binary {
+                large: matches!(data_type, DataType::LargeBinary),
+                values: Vec::with_capacity(capacity),
+            },
+            DataType::Utf8 | DataType::LargeUtf8 => Column::Text {
+                large: matches!(data_type, DataType::LargeUtf8),
+                values: Vec::with_capacity(capacity),
+            },
+            other => unreachable!("Fields of type {other:?} are rejected by RowFetcher::new."),
+        }
+    }
+
+    /// Retrieves the value of this column from the current row, with `SQLGetData`.
+    ///
+    /// # Safety
+    ///
+    /// `hstmt` must be positioned on a row and `col` must not be bound.
+    unsafe fn fetch(&mut self, hstmt: HStmt, col: u16, buffer: &mut Vec<u8>) -> Result<(), String> {
+        match self {
+            Column::Boolean(values) => {
+                let value = get_fixed::<u8>(hstmt, col, CDataType::Bit)?;
+                values.push(value.map(|bit| bit != 0))
+            }
+            Column::Int8(values) => values.push(get_fixed(hstmt, col, CDataType::STinyInt)?),
+            Column::Int16(values) => values.push(get_fixed(hstmt, col, CDataType::SShort)?),
+            Column::Int32(values) => values.push(get_fixed(hstmt, col, CDataType::SLong)?),
+            Column::Int64(values) => values.push(get_fixed(hstmt, col, CDataType::SBigInt)?),
+            Column::UInt8(values) => values.push(get_fixed(hstmt, col, CDataType::UTinyInt)?),
+            Column::Float32(values) => values.push(get_fixed(hstmt, col, CDataType::Float)?),
+            Column::Float64(values) => values.push(get_fixed(hstmt, col, CDataType::Double)?),
+            Column::Date32(values) => {
+                let value = get_fixed::<Date>(hstmt, col, CDataType::TypeDate)?;
+                values.push(value.map(|date| days_since_epoch(date.year, date.month, date.day)))
+            }
+            Column::Timestamp(unit, values) => {
+                let value = get_fixed::<Timestamp>(hstmt, col, CDataType::TypeTimestamp)?;
+                values.push(value.map(|timestamp| ticks_in_unit(&timestamp, unit)))
+            }
+            Column::Text { values, .. } => {
+                let is_some = get_variadic(hstmt, col, CDataType::Char, 1, buffer)?;
+                // Drivers are supposed to send UTF-8, yet we do not want to panic on an invalid
+                // byte in a document.
+                values.push(is_some.then(|| String::from_utf8_lossy(buffer).into_owned()))
+            }
+            Column::Binary { values, .. } => {
+                let is_some = get_variadic(hstmt, col, CDataType::Binary, 0, buffer)?;
+                values.push(is_some.then(|| buffer.clone()))
+            }
+        }
+        Ok(())
+    }
+
+    /// Appends the value of `row` fetched into the buffers of `bound`.
+    fn push_bound(&mut self, bound: &BoundColumn, row: usize) {
+        match self {
+            Column::Boolean(values) => values.push(bound.fixed::<u8>(row).map(|bit| bit != 0)),
+            Column::Int8(values) => values.push(bound.fixed(row)),
+            Column::Int16(values) => values.push(bound.fixed(row)),
+            Column::Int32(values) => values.push(bound.fixed(row)),
+            Column::Int64(values) => values.push(bound.fixed(row)),
+            Column::UInt8(values) => values.push(bound.fixed(row)),
+            Column::Float32(values) => values.push(bound.fixed(row)),
+            Column::Float64(values) => values.push(bound.fixed(row)),
+            Column::Date32(values) => {
+                let value = bound.fixed::<Date>(row);
+                values.push(value.map(|date| days_since_epoch(date.year, date.month, date.day)))
+            }
+            Column::Timestamp(unit, values) => {
+                let value = bound.fixed::<Timestamp>(row);
+                values.push(value.map(|timestamp| ticks_in_unit(&timestamp, unit)))
+            }
+            Column::Text { values, .. } => {
+                let value = bound.bytes(row);
+                values.push(value.map(|text| String::from_utf8_lossy(text).into_owned()))
+            }
+            Column::Binary { values, .. } => values.push(bound.bytes(row).map(<[u8]>::to_vec)),
+        }
+    }
+
+    fn finish(self) -> ArrayRef {
+        match self {
+            Column::Boolean(values) => Arc::new(values.into_iter().collect::<BooleanArray>()),
+            Column::Int8(values) => Arc::new(values.into_iter().collect::<Int8Array>()),
+            Column::Int16(values) => Arc::new(values.into_iter().collect::<Int16Array>()),
+            Column::Int32(values) => Arc::new(values.into_iter().collect::<Int32Array>()),
+            Column::Int64(values) => Arc::new(values.into_iter().collect::<Int64Array>()),
+            Column::UInt8(values) => Arc::new(values.into_iter().collect::<UInt8Array>()),
+            Column::Float32(values) => Arc::new(values.into_iter().collect::<Float32Array>()),
+            Column::Float64(values) => Arc::new(values.into_iter().collect::<Float64Array>()),
+            Column::Date32(values) => Arc::new(values.into_iter().collect::<Date32Array>()),
+            Column::Timestamp(unit, values) => {
+                let values = values.into_iter();
+                match unit {
+                    TimeUnit::Second => Arc::new(values.collect::<TimestampSecondArray>()),
+                    TimeUnit::Millisecond => {
+                        Arc::new(values.collect::<TimestampMillisecondArray>())
+                    }
+                    TimeUnit::Microsecond => {
+                        Arc::new(values.collect::<TimestampMicrosecondArray>())
+                    }
+                    TimeUnit::Nanosecond => Arc::new(values.collect::<TimestampNanosecondArray>()),
+                }
+            }
+            Column::Text { large, values } => {
+                let values = values.iter().map(Option::as_deref);
+                if large {
+                    Arc::new(values.collect::<LargeStringArray>())
+                } else {
+                    Arc::new(values.collect::<StringArray>())
+                }
+            }
+            Column::Binary { large, values } => {
+                let values = values.iter().map(Option::as_deref);
+                if large {
+                    Arc::new(values.collect::<LargeBinaryArray>())
+                } else {
+                    Arc::new(values.collect::<BinaryArray>())
+                }
+            }
+        }
+    }
+}
+
+/// Retrieves a fixed size value of the current row. `None` if it is NULL.
+///
+/// # Safety
+///
+/// `hstmt` must be positioned on a row and `col` must not be bound. `T` must be the type the
+/// driver writes for `c_type`.
+unsafe fn get_fixed<T>(hstmt: HStmt, col: u16, c_type: CDataType) -> Result<Option<T>, String> {
+    let mut value = MaybeUninit::<T>::uninit();
+    let mut indicator: Len = 0;
+    let ret = SQLGetData(
+        hstmt,
+        col,
+        c_type,
+        value.as_mut_ptr() as Pointer,
+        size_of::<T>() as Len,
+        &mut indicator,
+    );
+    match ret {
+        // The driver wrote the value, unless it is NULL.
+        SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => {
+            Ok((indicator != NULL_DATA).then(|| value.assume_init()))
+        }
+        _ => Err(statement_error(hstmt, "SQLGetData")),
+    }
+}
+
+/// Retrieves a text or binary value of the current row in chunks, until it is complete. `false` if
+/// it is NULL. Afterwards `buffer` holds the value, without the terminating zero of text, whose
+/// size is given by `terminator`.
+///
+/// # Safety
+///
+/// `hstmt` must be positioned on a row and `col` must not be bound.
+unsafe fn get_variadic(
+    hstmt: HStmt,
+    col: u16,
+    c_type: CDataType,
+    terminator: usize,
+    buffer: &mut Vec<u8>,
+) -> Result<bool, String> {
+    buffer.clear();
+    // Size of the next chunk, including the terminating zero. Starts out with the memory the
+    // buffer kept from previous values.
+    let mut chunk = max(buffer.capacity(), 256);
+    loop {
+        let start = buffer.len();
+        buffer.resize(start + chunk, 0);
+        let mut indicator: Len = 0;
+        let ret = SQLGetData(
+            hstmt,
+            col,
+            c_type,
+            buffer[start..].as_mut_ptr() as Pointer,
+            chunk as Len,
+            &mut indicator,
+        );
+        match ret {
+            SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => (),
+            // The previous chunk completed the value, even though it filled the buffer.
+            SqlReturn::NO_DATA => {
+                buffer.truncate(start);
+                return Ok(true);
+            }
+            _ => return Err(statement_error(hstmt, "SQLGetData")),
+        }
+        if indicator == NULL_DATA {
+            buffer.clear();
+            return Ok(false);
+        }
+        // `indicator` is the length of the value left before this call, if the driver knows it.
+        let room = chunk - terminator;
+        if indicator != NO_TOTAL && indicator as usize <= room {
+            buffer.truncate(start + indicator as usize);
+            return Ok(true);
+        }
+        // The chunk has been filled. Continue after it, overwriting its terminating zero.
+        buffer.truncate(start + room);
+        chunk = if indicator == NO_TOTAL {
+            chunk * 2
+        } else {
+            indicator as usize - room + terminator
+        };
+    }
+}
+
+fn external(message: String) -> ArrowError {
+    ArrowError::ExternalError(message.into())
+}
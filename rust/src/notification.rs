@@ -0,0 +1,44 @@
+use std::{
+    io::Write,
+    mem::ManuallyDrop,
+    sync::{Arc, Mutex},
+};
+
+#[cfg(unix)]
+use std::os::unix::{io::FromRawFd, net::UnixStream as Stream};
+#[cfg(windows)]
+use std::{net::TcpStream as Stream, os::windows::io::FromRawSocket};
+
+/// Wakes up an event loop by writing to a socket it waits on, e.g. the write end of a socket pair
+/// created by Python's `asyncio`. Readers and writers doing their work on a system thread use it
+/// to tell the event loop that it can make progress, without blocking it in the meantime.
+///
+/// Cloning yields a handle to the same notification. Until a socket is set, notifying does
+/// nothing.
+#[derive(Clone, Default)]
+pub struct Notification(Arc<Mutex<Option<ManuallyDrop<Stream>>>>);
+
+impl Notification {
+    /// Write to the socket from now on, each time [`Self::notify`] is called.
+    ///
+    /// # Safety
+    ///
+    /// `socket` must be a file descriptor (a `SOCKET` on windows) of a non-blocking stream socket,
+    /// which stays open as long as any clone of this notification is alive. It is not closed by
+    /// us.
+    pub unsafe fn set_socket(&self, socket: u64) {
+        #[cfg(unix)]
+        let stream = Stream::from_raw_fd(socket as i32);
+        #[cfg(windows)]
+        let stream = Stream::from_raw_socket(socket);
+        *self.0.lock().unwrap() = Some(ManuallyDrop::new(stream));
+    }
+
+    pub fn notify(&self) {
+        if let Some(stream) = self.0.lock().unwrap().as_ref() {
+            // If the socket buffer is full, the event loop has yet to wake up for an earlier
+            // notification. So a failed write can be ignored.
+            let _ = (&**stream).write(&[1]);
+        }
+    }
+}
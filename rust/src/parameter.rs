@@ -1,29 +1,56 @@
-use std::slice;
+use std::{ptr::NonNull, slice};
 
-use arrow_odbc::odbc_api::parameter::VarCharSlice;
+use arrow_odbc::odbc_api::{
+    parameter::{InputParameter, VarBinaryBox, VarBinarySlice, VarCharBox, VarCharSlice},
+    sys::Timestamp,
+};
+
+/// Parameter which owns its value, so it can be used after the call which passed it to us
+/// returned, e.g. by another thread.
+pub type OwnedParameter = Box<dyn InputParameter + Send>;
 
 /// Opaque type holding a parameter intended to be bound to a placeholder (`?`) in an SQL query.
-pub struct ArrowOdbcParameter<'a>(VarCharSlice<'a>);
+pub enum ArrowOdbcParameter<'a> {
+    /// Bound as VARCHAR. `None` is used for `NULL` parameters of any type.
+    Text(Option<&'a [u8]>),
+    /// Bound as VARBINARY.
+    Binary(&'a [u8]),
+    /// Bound as BIGINT.
+    Int64(i64),
+    /// Bound as DOUBLE.
+    Float64(f64),
+    /// Bound as TIMESTAMP.
+    Timestamp(Timestamp),
+}
 
 impl<'a> ArrowOdbcParameter<'a> {
-    fn from_opt_str(value: Option<&'a [u8]>) -> Self {
-        let inner = if let Some(slice) = value {
-            VarCharSlice::new(slice)
-        } else {
-            VarCharSlice::NULL
-        };
-        Self(inner)
+    pub fn unwrap(self) -> Box<dyn InputParameter + 'a> {
+        match self {
+            ArrowOdbcParameter::Text(Some(text)) => Box::new(VarCharSlice::new(text)),
+            ArrowOdbcParameter::Text(None) => Box::new(VarCharSlice::NULL),
+            ArrowOdbcParameter::Binary(bytes) => Box::new(VarBinarySlice::new(bytes)),
+            ArrowOdbcParameter::Int64(value) => Box::new(value),
+            ArrowOdbcParameter::Float64(value) => Box::new(value),
+            ArrowOdbcParameter::Timestamp(value) => Box::new(value),
+        }
     }
-}
 
-impl<'a> ArrowOdbcParameter<'a> {
-    pub fn unwrap(self) -> VarCharSlice<'a> {
-        self.0
+    /// Copies referenced text and binary values. Required if the parameter is used after the call
+    /// which passed it to us returned, e.g. by another thread.
+    pub fn into_owned(self) -> OwnedParameter {
+        match self {
+            ArrowOdbcParameter::Text(Some(text)) => Box::new(VarCharBox::from_vec(text.to_vec())),
+            ArrowOdbcParameter::Text(None) => Box::new(VarCharBox::null()),
+            ArrowOdbcParameter::Binary(bytes) => Box::new(VarBinaryBox::from_vec(bytes.to_vec())),
+            ArrowOdbcParameter::Int64(value) => Box::new(value),
+            ArrowOdbcParameter::Float64(value) => Box::new(value),
+            ArrowOdbcParameter::Timestamp(value) => Box::new(value),
+        }
     }
 }
 
 /// # Safety
-/// 
+///
 /// `char_buf` may be `NULL`, but if it is not, it must contain a valid utf-8 sequence not shorter
 /// than `char_len`. This function does not take ownership of the parameter. The parameter must at
 /// least be valid until the call make reader is finished.
@@ -38,6 +65,69 @@ pub unsafe extern "C" fn arrow_odbc_parameter_string_make(
         Some(slice::from_raw_parts(char_buf, char_len))
     };
 
-    let param = ArrowOdbcParameter::from_opt_str(opt);
+    let param = ArrowOdbcParameter::Text(opt);
     Box::into_raw(Box::new(param))
 }
+
+/// # Safety
+///
+/// `binary_buf` must point to at least `binary_len` bytes. This function does not take ownership
+/// of the buffer. It must at least be valid until the call make reader is finished.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_parameter_binary_make(
+    binary_buf: *const u8,
+    binary_len: usize,
+) -> *mut ArrowOdbcParameter<'static> {
+    let bytes = slice::from_raw_parts(binary_buf, binary_len);
+    Box::into_raw(Box::new(ArrowOdbcParameter::Binary(bytes)))
+}
+
+/// Creates a parameter bound as 64 bit integer.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_parameter_int64_make(value: i64) -> *mut ArrowOdbcParameter<'static> {
+    Box::into_raw(Box::new(ArrowOdbcParameter::Int64(value)))
+}
+
+/// Creates a parameter bound as 64 bit floating point.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_parameter_float64_make(
+    value: f64,
+) -> *mut ArrowOdbcParameter<'static> {
+    Box::into_raw(Box::new(ArrowOdbcParameter::Float64(value)))
+}
+
+/// Creates a parameter bound as timestamp. `fraction` is the fractional part of the second in
+/// nanoseconds.
+#[no_mangle]
+pub extern "C" fn arrow_odbc_parameter_timestamp_make(
+    year: i16,
+    month: u16,
+    day: u16,
+    hour: u16,
+    minute: u16,
+    second: u16,
+    fraction: u32,
+) -> *mut ArrowOdbcParameter<'static> {
+    let timestamp = Timestamp {
+        year,
+        month,
+        day,
+        hour,
+        minute,
+        second,
+        fraction,
+    };
+    Box::into_raw(Box::new(ArrowOdbcParameter::Timestamp(timestamp)))
+}
+
+/// Frees a parameter, which has not been passed to a function taking ownership of it, e.g. because
+/// creating the parameters following it failed.
+///
+/// # Safety
+///
+/// `parameter` must point to a valid parameter, created by one of the
+/// `arrow_odbc_parameter_*_make` functions.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_parameter_free(parameter: NonNull<ArrowOdbcParameter>) {
+    Box::from_raw(parameter.as_ptr());
+}
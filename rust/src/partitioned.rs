@@ -0,0 +1,238 @@
+use std::{
+    collections::VecDeque,
+    sync::{
+        mpsc::{sync_channel, Receiver, SyncSender},
+        Arc, Mutex,
+    },
+    thread::{self, JoinHandle},
+};
+
+use arrow_odbc::{
+    arrow::{
+        datatypes::{Schema, SchemaRef},
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::Connection,
+    BufferAllocationOptions, OdbcReader,
+};
+
+use crate::parameter::OwnedParameter;
+
+type BatchResult = Result<RecordBatch, ArrowError>;
+
+/// Executes the same query with different sets of parameters (partitions) concurrently, each on
+/// its own connection, and yields the batches of all partitions as one stream.
+pub struct PartitionedReader {
+    schema: SchemaRef,
+    /// Emptied during drop, so we can hang up on the worker threads before joining them.
+    receivers: Receivers,
+    workers: Vec<JoinHandle<()>>,
+}
+
+/// Options required for reading a single partition.
+pub struct ReadOptions {
+    pub batch_size: usize,
+    pub max_text_size: Option<usize>,
+    pub max_binary_size: Option<usize>,
+    pub fallibale_allocations: bool,
+}
+
+enum Receivers {
+    /// One channel for each partition, in the order of the partitions. Batches are yielded in the
+    /// order of the partitions.
+    Ordered(VecDeque<Receiver<BatchResult>>),
+    /// One channel shared by all partitions. Batches are yielded as soon as they are fetched.
+    Unordered(Option<Receiver<BatchResult>>),
+}
+
+/// A partition waiting for a worker thread to execute it.
+struct Partition {
+    parameters: Vec<OwnedParameter>,
+    sender: SyncSender<BatchResult>,
+}
+
+impl PartitionedReader {
+    /// Spawns one worker thread for each connection. Each worker executes the query for the next
+    /// partition not yet taken by any other worker, until all partitions are read. Blocks until the
+    /// schema of the result set is known.
+    pub fn new(
+        connections: Vec<Connection<'static>>,
+        query: String,
+        partitions: Vec<Vec<OwnedParameter>>,
+        options: ReadOptions,
+        ordered: bool,
+    ) -> Result<Self, ArrowError> {
+        let num_workers = connections.len();
+        let (partitions, receivers) = if ordered {
+            // Each worker may hold one batch ahead of the consumer for its current partition.
+            let (partitions, receivers): (Vec<_>, VecDeque<_>) = partitions
+                .into_iter()
+                .map(|parameters| {
+                    let (sender, receiver) = sync_channel(1);
+                    (Partition { parameters, sender }, receiver)
+                })
+                .unzip();
+            (partitions, Receivers::Ordered(receivers))
+        } else {
+            let (sender, receiver) = sync_channel(num_workers);
+            let partitions = partitions
+                .into_iter()
+                .map(|parameters| Partition {
+                    parameters,
+                    sender: sender.clone(),
+                })
+                .collect();
+            (partitions, Receivers::Unordered(Some(receiver)))
+        };
+        let partitions = Arc::new(Mutex::new(partitions.into_iter()));
+        let query = Arc::new(query);
+        let options = Arc::new(options);
+        // Every partition reports its schema, once its cursor is created. The channel has enough
+        // room, so this never blocks.
+        let (schema_sender, schema_receiver) = sync_channel(partitions.lock().unwrap().len());
+
+        let workers = connections
+            .into_iter()
+            .map(|connection| {
+                let partitions = partitions.clone();
+                let query = query.clone();
+                let options = options.clone();
+                let schema_sender = schema_sender.clone();
+                thread::spawn(move || loop {
+                    // Release the lock before reading, so other workers can take partitions.
+                    let next = partitions.lock().unwrap().next();
+                    let partition = match next {
+                        Some(partition) => partition,
+                        None => break,
+                    };
+                    let finished =
+                        read_partition(&connection, &query, partition, &options, &schema_sender);
+                    if !finished {
+                        // Consumer hung up
+                        break;
+                    }
+                })
+            })
+            .collect();
+        // Only the workers should keep the channel open.
+        drop(schema_sender);
+
+        let mut reader = PartitionedReader {
+            // Placeholder until the first partition reports its schema.
+            schema: Arc::new(Schema::empty()),
+            receivers,
+            workers,
+        };
+
+        // Wait for the first partition to report a schema. If none does, report the first error.
+        let mut first_error = None;
+        for result in schema_receiver.iter() {
+            match result {
+                Ok(schema) => {
+                    reader.schema = schema;
+                    return Ok(reader);
+                }
+                Err(error) => {
+                    first_error.get_or_insert(error);
+                }
+            }
+        }
+        Err(first_error.unwrap_or_else(|| {
+            ArrowError::ExternalError("None of the partitions produced a result set.".into())
+        }))
+    }
+}
+
+/// Executes the query for a single partition and sends its batches to the consumer. Returns
+/// `false` if the consumer hung up.
+fn read_partition(
+    connection: &Connection<'static>,
+    query: &str,
+    partition: Partition,
+    options: &ReadOptions,
+    schema_sender: &SyncSender<Result<SchemaRef, ArrowError>>,
+) -> bool {
+    let Partition { parameters, sender } = partition;
+    let result = connection
+        .execute(query, &parameters[..])
+        .map_err(external)
+        .and_then(|maybe_cursor| {
+            maybe_cursor
+                .map(|cursor| {
+                    let buffer_allocation_options = BufferAllocationOptions {
+                        max_text_size: options.max_text_size,
+                        max_binary_size: options.max_binary_size,
+                        fallibale_allocations: options.fallibale_allocations,
+                    };
+                    OdbcReader::with(cursor, options.batch_size, None, buffer_allocation_options)
+                        .map_err(external)
+                })
+                .transpose()
+        });
+    match result {
+        // Statement did not produce a result set. Nothing to send.
+        Ok(None) => true,
+        Ok(Some(reader)) => {
+            let _ = schema_sender.send(Ok(reader.schema()));
+            for batch in reader {
+                if sender.send(batch).is_err() {
+                    return false;
+                }
+            }
+            true
+        }
+        Err(error) => {
+            let message = error.to_string();
+            let _ = schema_sender.send(Err(error));
+            sender.send(Err(external(message))).is_ok()
+        }
+    }
+}
+
+impl Iterator for PartitionedReader {
+    type Item = BatchResult;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        match &mut self.receivers {
+            Receivers::Ordered(receivers) => loop {
+                // Channel is closed, once the worker finished the partition.
+                match receivers.front()?.recv() {
+                    Ok(batch) => return Some(batch),
+                    Err(_) => {
+                        receivers.pop_front();
+                    }
+                }
+            },
+            // Channel is closed, once all partitions are finished.
+            Receivers::Unordered(receiver) => receiver.as_ref().unwrap().recv().ok(),
+        }
+    }
+}
+
+impl RecordBatchReader for PartitionedReader {
+    fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+}
+
+impl Drop for PartitionedReader {
+    fn drop(&mut self) {
+        // Hang up first, so workers stop once they try to send their next batch. Then wait for
+        // them, so all the connections are closed once the reader is freed.
+        match &mut self.receivers {
+            Receivers::Ordered(receivers) => receivers.clear(),
+            Receivers::Unordered(receiver) => {
+                receiver.take();
+            }
+        }
+        for worker in self.workers.drain(..) {
+            // Panics abort the process, so joining can not fail.
+            worker.join().unwrap();
+        }
+    }
+}
+
+fn external(error: impl ToString) -> ArrowError {
+    ArrowError::ExternalError(error.to_string().into())
+}
@@ -0,0 +1,245 @@
+use std::{
+    sync::mpsc::{sync_channel, Receiver, SyncSender, TryRecvError, TrySendError},
+    thread::{self, JoinHandle},
+};
+
+use arrow_odbc::arrow::record_batch::RecordBatch;
+
+use crate::{notification::Notification, transaction::CommittingWriter};
+
+/// Inserts batches on a dedicated system thread. The caller hands over the next batch, while the
+/// previous one is still converted and sent to the database. Errors are reported by the first call
+/// to `write_batch` or `flush` after they occurred.
+pub struct PipelinedWriter {
+    /// Only `None` during drop, so we can hang up on the insert thread before joining it.
+    sender: Option<SyncSender<Message>>,
+    /// `None` once joined.
+    insert_thread: Option<JoinHandle<Result<(), String>>>,
+    /// Error which stopped the insert thread. Reported again by every subsequent call.
+    error: Option<String>,
+    /// Notified by the insert thread each time it is done with a message, and once it stops.
+    notification: Notification,
+    /// Message which could not be handed over yet without blocking, see [`Self::poll`].
+    pending: Option<Message>,
+    /// Receives the outcome of a flush requested by [`Self::try_flush`].
+    flush_reply: Option<Receiver<Result<(), String>>>,
+}
+
+enum Message {
+    Batch(RecordBatch),
+    /// Insert the remaining rows and report the outcome.
+    Flush(SyncSender<Result<(), String>>),
+}
+
+impl PipelinedWriter {
+    pub fn new(writer: CommittingWriter) -> Self {
+        // Room for one batch waiting, while the insert thread is busy with the previous one.
+        let (sender, receiver) = sync_channel(1);
+        let writer = SendWriter(writer);
+        let notification = Notification::default();
+        let thread_notification = notification.clone();
+        let insert_thread = thread::spawn(move || {
+            let mut writer = writer.into_inner();
+            let result = (|| {
+                for message in receiver {
+                    match message {
+                        // Returning early hangs up on the caller, so it learns about the error.
+                        Message::Batch(batch) => writer.write_batch(&batch)?,
+                        Message::Flush(reply) => {
+                            let _ = reply.send(writer.flush());
+                        }
+                    }
+                    thread_notification.notify();
+                }
+                Ok(())
+            })();
+            thread_notification.notify();
+            result
+        });
+        Self {
+            sender: Some(sender),
+            insert_thread: Some(insert_thread),
+            error: None,
+            notification,
+            pending: None,
+            flush_reply: None,
+        }
+    }
+
+    pub fn notification(&self) -> &Notification {
+        &self.notification
+    }
+
+    /// Like [`Self::write_batch`], but never blocks. `false` if the insert thread is still busy
+    /// with the batch before the previous one. In that case the batch is handed over by a later
+    /// call to [`Self::poll`], once the notification fired.
+    pub fn try_write_batch(&mut self, batch: RecordBatch) -> Result<bool, String> {
+        self.set_pending(Message::Batch(batch))?;
+        self.poll()
+    }
+
+    /// Like [`Self::flush`], but never blocks. `false` if the insert thread has not yet inserted
+    /// all batches. Call [`Self::poll`] once the notification fired, to learn about the outcome.
+    pub fn try_flush(&mut self) -> Result<bool, String> {
+        let (reply_sender, reply_receiver) = sync_channel(1);
+        self.set_pending(Message::Flush(reply_sender))?;
+        self.flush_reply = Some(reply_receiver);
+        self.poll()
+    }
+
+    /// Continues the work started by [`Self::try_write_batch`] or [`Self::try_flush`]. `true`
+    /// once it is complete.
+    pub fn poll(&mut self) -> Result<bool, String> {
+        if let Some(message) = self.pending.take() {
+            if self.insert_thread.is_none() {
+                return Err(self.join());
+            }
+            match self.sender.as_ref().unwrap().try_send(message) {
+                Ok(()) => (),
+                Err(TrySendError::Full(message)) => {
+                    self.pending = Some(message);
+                    return Ok(false);
+                }
+                Err(TrySendError::Disconnected(_)) => return Err(self.join()),
+            }
+        }
+        if let Some(reply) = &self.flush_reply {
+            let outcome = reply.try_recv();
+            if matches!(outcome, Err(TryRecvError::Empty)) {
+                return Ok(false);
+            }
+            self.flush_reply = None;
+            match outcome {
+                Ok(result) => result?,
+                // Insert thread stopped due to an error, before it received the flush.
+                Err(_) => return Err(self.join()),
+            }
+        }
+        Ok(true)
+    }
+
+    fn set_pending(&mut self, message: Message) -> Result<(), String> {
+        if self.pending.is_some() || self.flush_reply.is_some() {
+            return Err("The previous operation of the writer has not completed yet.".to_owned());
+        }
+        self.pending = Some(message);
+        Ok(())
+    }
+
+    /// Hands the batch over to the insert thread. Blocks only if the insert thread is still busy
+    /// with the batch before the previous one.
+    pub fn write_batch(&mut self, batch: RecordBatch) -> Result<(), String> {
+        self.complete_pending()?;
+        if self.send(Message::Batch(batch)) {
+            Ok(())
+        } else {
+            Err(self.join())
+        }
+    }
+
+    /// Waits for all batches handed over so far to be inserted.
+    pub fn flush(&mut self) -> Result<(), String> {
+        self.complete_pending()?;
+        let (reply_sender, reply_receiver) = sync_channel(1);
+        if !self.send(Message::Flush(reply_sender)) {
+            return Err(self.join());
+        }
+        match reply_receiver.recv() {
+            Ok(result) => result,
+            // Insert thread stopped due to an error, before it received the flush.
+            Err(_) => Err(self.join()),
+        }
+    }
+
+    /// Blocks until an operation started without blocking is complete, so blocking and non
+    /// blocking calls may be mixed.
+    fn complete_pending(&mut self) -> Result<(), String> {
+        if let Some(message) = self.pending.take() {
+            if !self.send(message) {
+                return Err(self.join());
+            }
+        }
+        if let Some(reply) = self.flush_reply.take() {
+            match reply.recv() {
+                Ok(result) => result?,
+                Err(_) => return Err(self.join()),
+            }
+        }
+        Ok(())
+    }
+
+    /// `false` if the insert thread is gone.
+    fn send(&mut self, message: Message) -> bool {
+        self.insert_thread.is_some() && self.sender.as_ref().unwrap().send(message).is_ok()
+    }
+
+    /// Waits for the insert thread to stop after it hung up and returns the error which stopped it.
+    fn join(&mut self) -> String {
+        if let Some(insert_thread) = self.insert_thread.take() {
+            // Panics abort the process, so joining can not fail. The thread only hangs up early
+            // due to an error.
+            let error = insert_thread.join().unwrap().unwrap_err();
+            self.error = Some(error);
+        }
+        self.error.clone().unwrap()
+    }
+}
+
+impl Drop for PipelinedWriter {
+    fn drop(&mut self) {
+        // Hang up first, so the insert thread stops once it processed the batches already handed
+        // over. Then wait for it, so the connection is closed once this writer is freed.
+        self.sender.take();
+        if let Some(insert_thread) = self.insert_thread.take() {
+            // Nobody is left to report an error to.
+            let _ = insert_thread.join().unwrap();
+        }
+    }
+}
+
+/// Distributes batches round-robin over several pipelined writers, each inserting over its own
+/// connection. Ingest of many data sources scales with the number of concurrent sessions.
+pub struct ParallelWriter {
+    writers: Vec<PipelinedWriter>,
+    /// Index of the writer receiving the next batch.
+    next: usize,
+}
+
+impl ParallelWriter {
+    pub fn new(writers: Vec<CommittingWriter>) -> Self {
+        let writers = writers.into_iter().map(PipelinedWriter::new).collect();
+        Self { writers, next: 0 }
+    }
+
+    pub fn write_batch(&mut self, batch: RecordBatch) -> Result<(), String> {
+        let index = self.next;
+        self.next = (index + 1) % self.writers.len();
+        self.writers[index].write_batch(batch)
+    }
+
+    /// Flushes all writers, even if some of them fail. Reports the first error.
+    pub fn flush(&mut self) -> Result<(), String> {
+        self.writers
+            .iter_mut()
+            .map(|writer| writer.flush())
+            .fold(Ok(()), |result, flushed| result.and(flushed))
+    }
+}
+
+/// Moves a writer into the insert thread of a [`PipelinedWriter`].
+struct SendWriter(CommittingWriter);
+
+// Safety: The column buffers of an `OdbcWriter` are not marked as `Send`, neither is the statement
+// handle it owns, yet nothing about them is bound to the thread which allocated them. ODBC handles
+// may be used from any thread, as long as they are not used concurrently. The writer is moved into
+// the insert thread as a whole and never touched by the calling thread again, which only exchanges
+// batches with it over a channel.
+unsafe impl Send for SendWriter {}
+
+impl SendWriter {
+    /// Closures would capture only the inner field if we destructure `self` within them. Consuming
+    /// it with a method makes sure we move the entire wrapper into the thread.
+    fn into_inner(self) -> CommittingWriter {
+        self.0
+    }
+}
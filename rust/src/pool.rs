@@ -0,0 +1,187 @@
+use std::{
+    alloc::{alloc, dealloc, handle_alloc_error, Layout},
+    mem::{size_of, MaybeUninit},
+    ptr::NonNull,
+    slice,
+    sync::{Arc, Mutex},
+};
+
+use arrow_odbc::arrow::buffer::Buffer;
+
+/// Alignment of the blocks handed out by the pool. Same as the one Arrow uses for its own
+/// buffers, so the values can be read with SIMD instructions.
+const ALIGNMENT: usize = 64;
+
+/// Recycles the memory of Arrow buffers. Buffers handed out to the consumer return their memory to
+/// the pool, once the last array referencing them is released (e.g. by pyarrow), so later batches
+/// can reuse it instead of asking the global allocator again. Cloning yields a handle to the same
+/// pool.
+#[derive(Clone)]
+pub struct BufferPool(Arc<Mutex<PoolState>>);
+
+struct PoolState {
+    /// Blocks released by the consumer, waiting to be reused.
+    free: Vec<Block>,
+    /// Sum of the capacity of the blocks in `free`.
+    free_bytes: usize,
+    /// Upper bound for `free_bytes`. Blocks released beyond it are returned to the global
+    /// allocator.
+    max_free_bytes: usize,
+    /// Memory currently held by the pool, including the blocks in use by the consumer.
+    allocated_bytes: u64,
+    /// Number of blocks handed out without asking the global allocator.
+    reuses: u64,
+}
+
+impl BufferPool {
+    /// `max_free_bytes` is the memory of released buffers retained for reuse. With `0` every
+    /// buffer is allocated from and returned to the global allocator, like without a pool.
+    pub fn new(max_free_bytes: usize) -> Self {
+        Self(Arc::new(Mutex::new(PoolState {
+            free: Vec::new(),
+            free_bytes: 0,
+            max_free_bytes,
+            allocated_bytes: 0,
+            reuses: 0,
+        })))
+    }
+
+    /// A block of at least `capacity` bytes. Its content is not initialized, the driver or a kernel
+    /// needs to write it, before it is handed over to Arrow. Aborts the process, if the memory can
+    /// not be allocated.
+    pub fn acquire(&self, capacity: usize) -> PooledBuffer {
+        self.try_acquire(capacity)
+            .unwrap_or_else(|| handle_alloc_error(Block::layout(capacity)))
+    }
+
+    /// Like [`Self::acquire`], but `None` if the memory can not be allocated.
+    pub fn try_acquire(&self, capacity: usize) -> Option<PooledBuffer> {
+        let mut state = self.0.lock().unwrap();
+        // Batches have the same size, apart from the last one, so there usually is an exact fit.
+        // Otherwise pick the smallest block large enough, to leave the larger ones for the larger
+        // requests.
+        let best_fit = state
+            .free
+            .iter()
+            .enumerate()
+            .filter(|(_, block)| block.capacity >= capacity)
+            .min_by_key(|(_, block)| block.capacity)
+            .map(|(index, _)| index);
+        let block = if let Some(index) = best_fit {
+            let block = state.free.swap_remove(index);
+            state.free_bytes -= block.capacity;
+            state.reuses += 1;
+            block
+        } else {
+            let block = Block::allocate(capacity)?;
+            state.allocated_bytes += capacity as u64;
+            block
+        };
+        Some(PooledBuffer {
+            block: Some(block),
+            pool: self.clone(),
+        })
+    }
+
+    /// Memory currently held by the pool, including buffers still used by the consumer.
+    pub fn allocated_bytes(&self) -> u64 {
+        self.0.lock().unwrap().allocated_bytes
+    }
+
+    /// Number of buffers which have reused the memory of a released one.
+    pub fn reuses(&self) -> u64 {
+        self.0.lock().unwrap().reuses
+    }
+
+    fn release(&self, block: Block) {
+        let mut state = self.0.lock().unwrap();
+        if state.free_bytes + block.capacity > state.max_free_bytes {
+            state.allocated_bytes -= block.capacity as u64;
+            // Dropping the block returns it to the global allocator.
+            return;
+        }
+        state.free_bytes += block.capacity;
+        state.free.push(block);
+    }
+}
+
+/// Memory acquired from a [`BufferPool`]. Returned to the pool once dropped.
+pub struct PooledBuffer {
+    /// Only `None` during drop.
+    block: Option<Block>,
+    pool: BufferPool,
+}
+
+impl PooledBuffer {
+    pub fn as_mut_ptr(&mut self) -> *mut u8 {
+        self.block.as_ref().unwrap().ptr.as_ptr()
+    }
+
+    pub fn as_ptr(&self) -> *const u8 {
+        self.block.as_ref().unwrap().ptr.as_ptr()
+    }
+
+    /// The first `len` elements of type `T`, to be written. `T` must be a primitive and `len`
+    /// elements must fit into the capacity of the buffer.
+    pub fn typed_data_mut<T: Copy>(&mut self, len: usize) -> &mut [MaybeUninit<T>] {
+        let block = self.block.as_ref().unwrap();
+        assert!(len * size_of::<T>() <= block.capacity);
+        // Safety: `MaybeUninit` does not require the memory to be initialized. Alignment of the
+        // block is larger than the one of any primitive.
+        unsafe { slice::from_raw_parts_mut(block.ptr.as_ptr() as *mut MaybeUninit<T>, len) }
+    }
+
+    /// Hands the first `len` bytes over to an Arrow buffer. The memory returns to the pool once
+    /// the last reference to the Arrow buffer is dropped.
+    ///
+    /// # Safety
+    ///
+    /// The first `len` bytes must have been written, e.g. by the driver during a fetch.
+    pub unsafe fn into_buffer(self, len: usize) -> Buffer {
+        let block = self.block.as_ref().unwrap();
+        assert!(len <= block.capacity);
+        let ptr = block.ptr;
+        // The memory stays valid until the owner, `self`, is dropped.
+        Buffer::from_custom_allocation(ptr, len, Arc::new(self))
+    }
+}
+
+impl Drop for PooledBuffer {
+    fn drop(&mut self) {
+        if let Some(block) = self.block.take() {
+            self.pool.release(block);
+        }
+    }
+}
+
+/// Memory allocated from the global allocator. Freed, if dropped.
+struct Block {
+    ptr: NonNull<u8>,
+    capacity: usize,
+}
+
+/// Blocks are owned exclusively, either by the pool or by one pooled buffer.
+unsafe impl Send for Block {}
+unsafe impl Sync for Block {}
+
+impl Block {
+    /// `None` if the global allocator is out of memory.
+    fn allocate(capacity: usize) -> Option<Self> {
+        let layout = Self::layout(capacity);
+        // Not zeroed. Every byte handed over to Arrow is written by the driver or a kernel first,
+        // so zeroing would only touch each page one more time.
+        let ptr = NonNull::new(unsafe { alloc(layout) })?;
+        Some(Self { ptr, capacity })
+    }
+
+    fn layout(capacity: usize) -> Layout {
+        // Allocate at least one byte, allocating zero bytes is undefined behaviour.
+        Layout::from_size_align(capacity.max(1), ALIGNMENT).unwrap()
+    }
+}
+
+impl Drop for Block {
+    fn drop(&mut self) {
+        unsafe { dealloc(self.ptr.as_ptr(), Self::layout(self.capacity)) }
+    }
+}
@@ -0,0 +1,228 @@
+use std::{
+    ptr::{null_mut, NonNull},
+    slice, str,
+    sync::{Arc, Mutex},
+};
+
+use arrow_odbc::{
+    arrow::{
+        datatypes::SchemaRef,
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::CursorImpl,
+    BufferAllocationOptions, OdbcReader,
+};
+
+use crate::{
+    parameter::ArrowOdbcParameter,
+    reader::{ArrowOdbcReader, Batches},
+    statement::{LentStatement, StatementSlot},
+    try_, ArrowOdbcError, OdbcConnection,
+};
+
+/// Opaque type holding a prepared query and the connection it has been prepared on. It can be
+/// executed many times with different parameters, without the data source parsing and planning
+/// it again.
+pub struct ArrowOdbcPreparedQuery(Arc<Mutex<PreparedState>>);
+
+/// State shared between a prepared query and the readers created by executing it.
+struct PreparedState {
+    /// Reader of the most recent execution. Its cursor owns the statement, until the reader is
+    /// dropped. `None` once the result set has been released.
+    reader: Option<OdbcReader<CursorImpl<LentStatement>>>,
+    /// Incremented with each execution. Readers of previous executions compare it to their own
+    /// generation, to tell that they have been invalidated.
+    generation: u64,
+    /// Holds the statement in between executions.
+    statement: StatementSlot,
+    batch_size: usize,
+    max_text_size: Option<usize>,
+    max_binary_size: Option<usize>,
+    fallibale_allocations: bool,
+}
+
+/// Batches of a result set produced by executing a prepared query.
+pub struct PreparedBatches {
+    state: Arc<Mutex<PreparedState>>,
+    generation: u64,
+    schema: SchemaRef,
+}
+
+impl Iterator for PreparedBatches {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let mut state = self.state.lock().unwrap();
+        if state.generation != self.generation {
+            return Some(Err(ArrowError::ExternalError(
+                "The result set is no longer available, because the prepared query has been \
+                executed again."
+                    .into(),
+            )));
+        }
+        state.reader.as_mut()?.next()
+    }
+}
+
+impl RecordBatchReader for PreparedBatches {
+    fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+}
+
+impl Drop for PreparedBatches {
+    fn drop(&mut self) {
+        // Release the resources of the result set on the data source early, rather than waiting
+        // for the next execution. Closes the cursor and returns the statement to its slot.
+        let mut state = self.state.lock().unwrap();
+        if state.generation == self.generation {
+            state.reader = None;
+        }
+    }
+}
+
+/// Prepares a query for repeated execution.
+///
+/// Takes ownership of connection even in case of an error.
+///
+/// # Safety
+///
+/// * `connection` must point to a valid OdbcConnection. This function takes ownership of the
+///   connection, even in case of an error. So The connection must not be freed explicitly
+///   afterwards.
+/// * `query_buf` must point to a valid utf-8 string
+/// * `query_len` describes the len of `query_buf` in bytes.
+/// * `batch_size` maximum number of rows in each batch.
+/// * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+///   uppper bound applies.
+/// * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+///   that no uppper bound applies.
+/// * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+///   to abort the process.
+/// * `prepared_out` in case of success this will point to an instance of
+///   `ArrowOdbcPreparedQuery`. Ownership is transferred to the caller.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_prepared_query_make(
+    connection: NonNull<OdbcConnection>,
+    query_buf: *const u8,
+    query_len: usize,
+    batch_size: usize,
+    max_text_size: usize,
+    max_binary_size: usize,
+    fallibale_allocations: bool,
+    prepared_out: *mut *mut ArrowOdbcPreparedQuery,
+) -> *mut ArrowOdbcError {
+    let query = slice::from_raw_parts(query_buf, query_len);
+    let query = str::from_utf8(query).unwrap();
+
+    let connection = *Box::from_raw(connection.as_ptr());
+
+    let statement = try_!(connection.0.into_prepared(query));
+
+    let state = PreparedState {
+        reader: None,
+        generation: 0,
+        statement: StatementSlot::new(statement),
+        batch_size,
+        max_text_size: if max_text_size == 0 {
+            None
+        } else {
+            Some(max_text_size)
+        },
+        max_binary_size: if max_binary_size == 0 {
+            None
+        } else {
+            Some(max_binary_size)
+        },
+        fallibale_allocations,
+    };
+    let state = Arc::new(Mutex::new(state));
+    *prepared_out = Box::into_raw(Box::new(ArrowOdbcPreparedQuery(state)));
+    null_mut() // Ok(())
+}
+
+/// Executes a prepared query. The result set of a previous execution becomes unavailable. Readers
+/// created for it yield an error from then on. Only the statement is reused. Column buffers are
+/// allocated and bound anew for every result set, even if its schema matches the previous one.
+/// `arrow-odbc` does not hand out the buffers owned by its reader, so they can not be kept across
+/// executions.
+///
+/// `reader_out` is assigned a NULL pointer in case the query does not return a result set.
+///
+/// # Safety
+///
+/// * `prepared` must be valid non-null prepared query, allocated by
+///   [`arrow_odbc_prepared_query_make`].
+/// * `parameters` must contain only valid pointers. This function takes ownership of all of them
+///   independent if the function succeeds or not. Yet it does not take ownership of the array
+///   itself.
+/// * `parameters_len` number of elements in parameters.
+/// * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
+///   Ownership is transferred to the caller.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_prepared_query_execute(
+    prepared: NonNull<ArrowOdbcPreparedQuery>,
+    parameters: *const *mut ArrowOdbcParameter,
+    parameters_len: usize,
+    reader_out: *mut *mut ArrowOdbcReader,
+) -> *mut ArrowOdbcError {
+    let parameters = if parameters.is_null() {
+        Vec::new()
+    } else {
+        slice::from_raw_parts(parameters, parameters_len)
+            .iter()
+            .map(|&p| Box::from_raw(p).unwrap())
+            .collect()
+    };
+
+    let shared = &prepared.as_ref().0;
+    let mut state = shared.lock().unwrap();
+    // Readers of the previous execution must not access the statement anymore. Dropping their
+    // reader closes the cursor and returns the statement to its slot.
+    state.generation += 1;
+    state.reader = None;
+
+    let maybe_cursor = try_!(state.statement.execute(&parameters[..]));
+    let cursor = if let Some(cursor) = maybe_cursor {
+        cursor
+    } else {
+        *reader_out = null_mut();
+        return null_mut();
+    };
+
+    let buffer_allocation_options = BufferAllocationOptions {
+        max_text_size: state.max_text_size,
+        max_binary_size: state.max_binary_size,
+        fallibale_allocations: state.fallibale_allocations,
+    };
+    let reader = try_!(OdbcReader::with(
+        cursor,
+        state.batch_size,
+        None,
+        buffer_allocation_options
+    ));
+    state.reader = Some(reader);
+
+    let batches = PreparedBatches {
+        state: shared.clone(),
+        generation: state.generation,
+        schema: state.reader.as_ref().unwrap().schema(),
+    };
+    *reader_out = Box::into_raw(Box::new(ArrowOdbcReader::new(
+        Batches::Prepared(batches),
+        state.batch_size,
+    )));
+    null_mut() // Ok(())
+}
+
+/// Frees the resources associated with an ArrowOdbcPreparedQuery. The connection is closed once
+/// all readers created from it are freed, too.
+///
+/// # Safety
+///
+/// `prepared` must point to a valid ArrowOdbcPreparedQuery.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_prepared_query_free(prepared: NonNull<ArrowOdbcPreparedQuery>) {
+    Box::from_raw(prepared.as_ptr());
+}
@@ -0,0 +1,163 @@
+use arrow_odbc::{
+    arrow::{
+        datatypes::SchemaRef,
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::Cursor,
+    BufferAllocationOptions, OdbcReader,
+};
+
+use crate::lob::LobReader;
+
+/// Upper bound for the batches of the ramp retrieved row by row. Retrieving values one by one is
+/// much slower than fetching them into bound buffers, so the ramp switches to buffers for a full
+/// batch, once the next batch would be larger.
+const MAX_ROW_BY_ROW_BATCH: usize = 1024;
+
+/// Number of rows of successive batches. Starts out small and doubles with every batch, until it
+/// reaches the batch size requested by the caller. Consumers see the first rows early, and small
+/// result sets never cause the allocation of buffers for a full batch.
+#[derive(Clone, Copy)]
+pub struct RampUp {
+    next: usize,
+    max: usize,
+}
+
+impl RampUp {
+    /// Every batch has `batch_size` rows.
+    pub fn fixed(batch_size: usize) -> Self {
+        Self {
+            next: batch_size,
+            max: batch_size,
+        }
+    }
+
+    /// The first batch has `initial_batch_size` rows. `0` is treated like [`RampUp::fixed`].
+    pub fn new(initial_batch_size: usize, batch_size: usize) -> Self {
+        let next = if initial_batch_size == 0 {
+            batch_size
+        } else {
+            initial_batch_size.min(batch_size)
+        };
+        Self {
+            next,
+            max: batch_size,
+        }
+    }
+
+    /// Number of rows of the full batches, which no batch exceeds.
+    pub fn max_size(&self) -> usize {
+        self.max
+    }
+
+    /// Number of rows of the next batch, without advancing the ramp.
+    pub fn peek_size(&self) -> usize {
+        self.next
+    }
+
+    /// Number of rows of the next batch.
+    pub fn next_size(&mut self) -> usize {
+        let size = self.next;
+        self.next = self.next.saturating_mul(2).min(self.max);
+        size
+    }
+
+    /// `true` once all following batches have the full batch size.
+    pub fn is_complete(&self) -> bool {
+        self.next == self.max
+    }
+}
+
+/// Fetches a result set the usual way, into buffers bound for `batch_size` rows, but ramps up to
+/// it. `arrow-odbc` binds buffers once for the entire result set, so the smaller batches of the
+/// ramp are retrieved row by row with `SQLGetData`, into buffers growing with their values. Once
+/// the ramp is complete, or its next batch would exceed [`MAX_ROW_BY_ROW_BATCH`] rows, buffers
+/// for a full batch are bound to the same cursor. Result sets smaller than the ramp are never
+/// bound at all.
+pub struct RampUpReader<C: Cursor> {
+    /// Only `None` while switching from row by row fetching to bound buffers.
+    stage: Option<Stage<C>>,
+    schema: SchemaRef,
+    batch_size: usize,
+    /// Used for the buffers bound once the ramp is complete. `None` once they are bound.
+    buffer_allocation_options: Option<BufferAllocationOptions>,
+}
+
+enum Stage<C: Cursor> {
+    RowByRow(LobReader<C>),
+    Bound(OdbcReader<C>),
+}
+
+impl<C> RampUpReader<C>
+where
+    C: Cursor,
+{
+    /// All fields of `schema` must be supported by [`LobReader`], so small and full batches share
+    /// the same schema. The first batch has at most [`MAX_ROW_BY_ROW_BATCH`] rows.
+    pub fn new(
+        cursor: C,
+        schema: SchemaRef,
+        initial_batch_size: usize,
+        batch_size: usize,
+        buffer_allocation_options: BufferAllocationOptions,
+    ) -> Result<Self, String> {
+        let large = vec![false; schema.fields().len()];
+        let ramp_up = RampUp::new(initial_batch_size.min(MAX_ROW_BY_ROW_BATCH), batch_size);
+        let reader = LobReader::new(cursor, &schema, &large, batch_size)?.with_ramp_up(ramp_up);
+        Ok(Self {
+            stage: Some(Stage::RowByRow(reader)),
+            schema,
+            batch_size,
+            buffer_allocation_options: Some(buffer_allocation_options),
+        })
+    }
+
+    fn bind_buffers(&mut self) -> Result<(), ArrowError> {
+        let cursor = match self.stage.take() {
+            Some(Stage::RowByRow(reader)) => reader.into_cursor(),
+            _ => unreachable!("Buffers are only bound once, following the ramp."),
+        };
+        let reader = OdbcReader::with(
+            cursor,
+            self.batch_size,
+            Some(self.schema.clone()),
+            self.buffer_allocation_options.take().unwrap(),
+        )
+        .map_err(|error| ArrowError::ExternalError(error.to_string().into()))?;
+        self.stage = Some(Stage::Bound(reader));
+        Ok(())
+    }
+}
+
+impl<C> Iterator for RampUpReader<C>
+where
+    C: Cursor,
+{
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if let Some(Stage::RowByRow(reader)) = &self.stage {
+            let ramp_done =
+                reader.is_ramped_up() || reader.next_batch_size() > MAX_ROW_BY_ROW_BATCH;
+            if ramp_done && !reader.is_exhausted() {
+                if let Err(error) = self.bind_buffers() {
+                    return Some(Err(error));
+                }
+            }
+        }
+        match self.stage.as_mut()? {
+            Stage::RowByRow(reader) => reader.next(),
+            Stage::Bound(reader) => reader.next(),
+        }
+    }
+}
+
+impl<C> RecordBatchReader for RampUpReader<C>
+where
+    C: Cursor,
+{
+    fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+}
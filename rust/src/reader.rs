@@ -5,23 +5,425 @@ use std::{
     ptr::{null_mut, NonNull},
     slice, str,
     sync::Arc,
+    task::Poll,
+    time::{Duration, Instant},
 };
 
 use arrow_odbc::{
     arrow::{
         array::{Array, StructArray},
+        datatypes::{Schema, SchemaRef},
+        error::ArrowError,
         ffi::{FFI_ArrowArray, FFI_ArrowSchema},
-        record_batch::RecordBatchReader,
+        record_batch::{RecordBatch, RecordBatchReader},
     },
-    odbc_api::{CursorImpl, StatementConnection},
-    OdbcReader, BufferAllocationOptions,
+    arrow_schema_from,
+    odbc_api::{CursorImpl, ResultSetMetadata, StatementConnection},
+    BufferAllocationOptions, OdbcReader,
 };
 
-use crate::{try_, ArrowOdbcError, OdbcConnection, parameter::ArrowOdbcParameter};
+use crate::{
+    adaptive::{AdaptiveOptions, AdaptiveReader},
+    attributes::{
+        apply_connection_attributes, apply_statement_attributes, attributes_from_raw,
+        ArrowOdbcAttribute, AttributedOptions, AttributedReader,
+    },
+    buffer_size::{bytes_per_row, limit_batch_size},
+    cache::{CachedBatches, Recorder},
+    concurrent::{ConcurrentOdbcReader, FetchOnAnyThread},
+    dictionary::DictionaryEncoder,
+    lob::{getdata_extensions, is_supported, large_columns, LobReader},
+    parameter::ArrowOdbcParameter,
+    partitioned::{PartitionedReader, ReadOptions},
+    pool::BufferPool,
+    prepared::PreparedBatches,
+    ramp_up::{RampUp, RampUpReader},
+    result_sets::ResultSets,
+    stats::{timed, ArrowOdbcReaderStats},
+    try_,
+    watermark::Watermark,
+    zero_copy::{supports_zero_copy, ZeroCopyReader},
+    ArrowOdbcError, OdbcConnection,
+};
+
+type Cursor = CursorImpl<StatementConnection<'static>>;
 
 /// Opaque type holding all the state associated with an ODBC reader implementation in Rust. This
 /// type also has ownership of the ODBC Connection handle.
-pub struct ArrowOdbcReader(OdbcReader<CursorImpl<StatementConnection<'static>>>);
+pub struct ArrowOdbcReader {
+    batches: Batches,
+    /// Maximum number of rows in each batch.
+    batch_size: usize,
+    /// Applied to every batch, if columns are to be dictionary encoded.
+    encoder: Option<DictionaryEncoder>,
+    stats: ArrowOdbcReaderStats,
+    /// Pool the Arrow buffers of the batches are allocated from, if the strategy supports it.
+    pool: Option<BufferPool>,
+    /// Largest value of a column seen so far, if one is tracked.
+    watermark: Option<Watermark>,
+    /// Collects the batches yielded, if they are to be cached once the result set is consumed.
+    recorder: Option<Recorder>,
+}
+
+/// The reader may be moved between threads, e.g. it may be created by one Python thread and
+/// consumed by another. ODBC handles may be used from any thread, as long as they are not used
+/// concurrently, which exclusive access to the reader guarantees.
+unsafe impl Send for ArrowOdbcReader {}
+
+/// Strategies for fetching batches from the data source.
+pub enum Batches {
+    /// Batches are fetched then `arrow_odbc_reader_next` is called.
+    Sequential(OdbcReader<Cursor>),
+    /// Like sequential, but the buffers bound to the cursor become part of the batch, instead of
+    /// copying their values.
+    ZeroCopy(ZeroCopyReader<Cursor>),
+    /// Batches are fetched from a dedicated system thread. The next batch is fetched while the
+    /// current one is still processed by the caller.
+    Concurrent(ConcurrentOdbcReader),
+    /// Several partitions of the result set are fetched concurrently over multiple connections.
+    Partitioned(PartitionedReader),
+    /// Result sets with large text or binary columns, fetched one row at a time.
+    Lob(LobReader<Cursor>),
+    /// Text buffers are sized from the values of the first batch.
+    Adaptive(AdaptiveReader),
+    /// Batches of the result set of a prepared query. Fetched sequentially, using the buffers
+    /// owned by the prepared query.
+    Prepared(PreparedBatches),
+    /// Batches of several result sets produced by one statement, fetched one row at a time.
+    ResultSets(ResultSets),
+    /// Like sequential, but statement attributes have been set before executing the query.
+    Attributed(AttributedReader),
+    /// Like sequential, but the first batches are smaller and fetched row by row.
+    RampUp(RampUpReader<Cursor>),
+    /// Batches of a result set cached by an earlier reader. Does not touch the data source.
+    Cached(CachedBatches),
+}
+
+impl Batches {
+    /// Wraps the reader into the variant of its strategy. Given a prefetch depth, fetching is moved
+    /// to a dedicated system thread instead.
+    fn fetched_by<R: FetchOnAnyThread>(
+        reader: R,
+        variant: fn(R) -> Batches,
+        prefetch_depth: Option<usize>,
+    ) -> Self {
+        match prefetch_depth {
+            Some(prefetch_depth) => {
+                Batches::Concurrent(ConcurrentOdbcReader::new(reader, prefetch_depth))
+            }
+            None => variant(reader),
+        }
+    }
+}
+
+impl ArrowOdbcReader {
+    /// Used by other modules to hand out batches fetched by their own strategies.
+    pub fn new(batches: Batches, batch_size: usize) -> Self {
+        Self {
+            batches,
+            batch_size,
+            encoder: None,
+            stats: ArrowOdbcReaderStats::default(),
+            pool: None,
+            watermark: None,
+            recorder: None,
+        }
+    }
+
+    /// Reports the memory held by the pool in the stats of the reader.
+    fn with_pool(mut self, pool: Option<BufferPool>) -> Self {
+        self.pool = pool;
+        self
+    }
+
+    fn stats(&self) -> ArrowOdbcReaderStats {
+        let mut stats = self.stats;
+        if let Some(pool) = &self.pool {
+            stats.pool_bytes = pool.allocated_bytes();
+            stats.pool_reuses = pool.reuses();
+        }
+        stats
+    }
+
+    /// Reports the estimated size of the buffers bound to the cursor in the stats of the reader.
+    fn with_buffer_bytes(mut self, buffer_bytes: usize) -> Self {
+        self.stats.buffer_bytes = buffer_bytes as u64;
+        self
+    }
+
+    pub fn schema(&self) -> SchemaRef {
+        if let Some(encoder) = &self.encoder {
+            return encoder.schema();
+        }
+        self.source_schema()
+    }
+
+    /// Schema of the batches, before dictionary encoding.
+    fn source_schema(&self) -> SchemaRef {
+        match &self.batches {
+            Batches::Sequential(reader) => reader.schema(),
+            Batches::ZeroCopy(reader) => reader.schema(),
+            Batches::Lob(reader) => reader.schema(),
+            Batches::Adaptive(reader) => reader.schema(),
+            Batches::Concurrent(reader) => reader.schema(),
+            Batches::Partitioned(reader) => reader.schema(),
+            Batches::Prepared(reader) => reader.schema(),
+            Batches::ResultSets(reader) => reader.schema(),
+            Batches::Attributed(reader) => reader.schema(),
+            Batches::RampUp(reader) => reader.schema(),
+            Batches::Cached(reader) => reader.schema(),
+        }
+    }
+
+    /// Fetches the next batch and applies dictionary encoding, like [`arrow_odbc_reader_next`],
+    /// without exporting it.
+    pub fn next_batch(&mut self) -> Option<Result<RecordBatch, ArrowError>> {
+        let fetch_start = Instant::now();
+        let batch = self.next_source_batch();
+        self.stats.fetch_ns += fetch_start.elapsed().as_nanos() as u64;
+        match batch {
+            Some(batch) => self.finish_batch(batch),
+            None => self.finish_result_set(),
+        }
+    }
+
+    /// Like [`Self::next_batch`], but does not wait for a batch fetched on another thread.
+    /// Readers fetching on the calling thread always block.
+    fn try_next_batch(&mut self) -> Poll<Option<Result<RecordBatch, ArrowError>>> {
+        let batch = match &mut self.batches {
+            Batches::Concurrent(reader) => match reader.try_next() {
+                Poll::Ready(batch) => batch,
+                Poll::Pending => return Poll::Pending,
+            },
+            _ => return Poll::Ready(self.next_batch()),
+        };
+        Poll::Ready(match batch {
+            Some(batch) => self.finish_batch(batch),
+            None => self.finish_result_set(),
+        })
+    }
+
+    /// Caches the batches yielded from now on, once the result set is consumed. Must be called
+    /// before the first batch is fetched, so the cached result set is complete.
+    pub fn cache_result(&mut self, key: String, ttl: Duration) -> Result<(), String> {
+        if self.stats.batches != 0 {
+            return Err(
+                "Only readers which have not yielded any batches can be cached.".to_owned(),
+            );
+        }
+        if matches!(self.batches, Batches::ResultSets(_)) {
+            return Err("Readers of multiple result sets can not be cached.".to_owned());
+        }
+        let recorder = Recorder::new(key, ttl, self.source_schema(), self.batch_size);
+        self.recorder = Some(recorder);
+        Ok(())
+    }
+
+    /// Inserts the batches into the cache, if they are recorded.
+    fn finish_result_set(&mut self) -> Option<Result<RecordBatch, ArrowError>> {
+        if let Some(recorder) = self.recorder.take() {
+            recorder.finish();
+        }
+        None
+    }
+
+    /// Updates the watermark, records the batch for the cache, applies dictionary encoding and
+    /// accounts for the batch in the stats. A result set which failed is not cached.
+    fn finish_batch(
+        &mut self,
+        batch: Result<RecordBatch, ArrowError>,
+    ) -> Option<Result<RecordBatch, ArrowError>> {
+        let batch = match (batch, &mut self.watermark) {
+            (Ok(batch), Some(watermark)) => watermark.update(&batch).map(|()| batch),
+            (batch, _) => batch,
+        };
+        match &batch {
+            Ok(batch) => {
+                if let Some(recorder) = &mut self.recorder {
+                    recorder.record(batch);
+                }
+            }
+            Err(_) => self.recorder = None,
+        }
+        let batch = match (batch, &mut self.encoder) {
+            (Ok(batch), Some(encoder)) => {
+                timed(&mut self.stats.conversion_ns, || encoder.encode(batch))
+            }
+            (batch, _) => batch,
+        };
+        if let Ok(batch) = &batch {
+            self.stats.batches += 1;
+            self.stats.rows += batch.num_rows() as u64;
+            self.stats.bytes += batch
+                .columns()
+                .iter()
+                .map(|column| column.get_array_memory_size() as u64)
+                .sum::<u64>();
+        }
+        Some(batch)
+    }
+
+    fn next_source_batch(&mut self) -> Option<Result<RecordBatch, ArrowError>> {
+        match &mut self.batches {
+            Batches::Sequential(reader) => reader.next(),
+            Batches::ZeroCopy(reader) => reader.next(),
+            Batches::Lob(reader) => reader.next(),
+            Batches::Adaptive(reader) => reader.next(),
+            Batches::Concurrent(reader) => reader.next(),
+            Batches::Partitioned(reader) => reader.next(),
+            Batches::Prepared(reader) => reader.next(),
+            Batches::ResultSets(reader) => reader.next(),
+            Batches::Attributed(reader) => reader.next(),
+            Batches::RampUp(reader) => reader.next(),
+            Batches::Cached(reader) => reader.next(),
+        }
+    }
+}
+
+/// Options of [`arrow_odbc_reader_make`], besides the query and its parameters. Options which
+/// can not be combined are rejected by it with an error.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct ArrowOdbcReaderOptions {
+    /// Optional upper bound for the size of text columns. Use `0` to indicate that no uppper bound
+    /// applies.
+    pub max_text_size: usize,
+    /// Optional upper bound for the size of binary columns. Use `0` to indicate that no uppper
+    /// bound applies.
+    pub max_binary_size: usize,
+    /// `TRUE` if allocations should return an error, `FALSE` if it is fine to abort the process.
+    /// Enabling might have a performance overhead, so it might be desirable to disable it, if you
+    /// know there is enough memory available.
+    pub fallibale_allocations: bool,
+    /// Upper bound for the size of the buffers bound to the cursor. If the rows of `batch_size`
+    /// would not fit, the number of rows per batch is reduced accordingly. Use `0` to indicate
+    /// that no upper bound applies.
+    pub max_bytes_per_batch: usize,
+    /// `TRUE` if batches should be fetched by a dedicated system thread, while the caller is still
+    /// processing the previous one. `FALSE` to fetch a batch then it is requested by
+    /// [`arrow_odbc_reader_next`].
+    pub fetch_concurrently: bool,
+    /// Maximum number of batches fetched ahead of the caller, if fetching concurrently. The fetch
+    /// thread blocks once this many batches are waiting to be consumed. Ignored if
+    /// `fetch_concurrently` is `FALSE`. `0` is treated like `1`.
+    pub prefetch_depth: usize,
+    /// `TRUE` to hand the buffers bound to the cursor over to the batch, rather than copying their
+    /// values. Only has an effect, if all columns of the result set are non nullable integers,
+    /// floating points, dates or timestamps, otherwise the values are copied as usual. Dates and
+    /// timestamps are converted from the structs ODBC uses by vectorized kernels.
+    pub zero_copy: bool,
+    /// Size of the buffers text columns are first fetched into. As long as the first batch holds
+    /// values which may not fit, the query is executed again with buffers of twice the size, up to
+    /// `max_text_size`, or up to the octet length declared for the columns which did not fit. The
+    /// remaining batches are fetched with the buffers the first batch fits in. Should a value of a
+    /// later batch not fit, fetching that batch fails. Use `0` to size the buffers from the column
+    /// sizes reported by the driver instead. `zero_copy` is ignored otherwise.
+    pub initial_text_size: usize,
+    /// Text and binary columns larger than this, or of unknown size, are retrieved in chunks with
+    /// `SQLGetData`, rather than being bound to buffers holding their largest possible value for
+    /// every row. If the driver reports `SQL_GD_BLOCK` for `SQL_GETDATA_EXTENSIONS`, the other
+    /// columns are bound and fetched in blocks of rows. Otherwise result sets with such a column
+    /// are fetched one row at a time. Columns of types which can not be retrieved with
+    /// `SQLGetData`, e.g. decimals, cause an error, unless `schema` maps them to a supported type.
+    /// Use `0` to bind all columns. Can not be combined with `initial_text_size`.
+    pub lob_threshold: usize,
+    /// Optional pointer to an arrow schema, which is used for the batches instead of the one
+    /// inferred from the column types reported by the driver. It must have one field for each
+    /// column of the result set. The driver converts the values to the C types matching the
+    /// fields, so e.g. IDs declared as `DECIMAL(38,0)` can be fetched as `Int64`. `NULL` to infer
+    /// the schema.
+    pub schema: *const c_void,
+    /// Memory of released Arrow buffers retained by the reader, so later batches can reuse it,
+    /// rather than allocating new buffers. Only has an effect, if the values are fetched with
+    /// `zero_copy`. Use `0` to allocate the buffers of each batch from the global allocator.
+    pub buffer_pool_bytes: usize,
+    /// `TRUE` to fetch all result sets produced by the query, e.g. a stored procedure or a batch of
+    /// several statements. Use [`arrow_odbc_reader_next_result_set`] to advance to the next one.
+    /// Columns of types which can not be retrieved with `SQLGetData`, e.g. decimals, are returned
+    /// as text. Values are retrieved with `SQLGetData` one row at a time, so this can not be
+    /// combined with `max_text_size`, `max_binary_size`, `max_bytes_per_batch`,
+    /// `fetch_concurrently`, `zero_copy`, `initial_text_size`, `lob_threshold`, `schema` or
+    /// `initial_batch_size`.
+    pub more_results: bool,
+    /// Optional pointer to an array of integer valued statement attributes, e.g.
+    /// `SQL_ATTR_MAX_LENGTH` or driver specific ones. They are set in the order given, before the
+    /// query is executed. If there are any, the query is prepared before executing it and the
+    /// values are fetched into bound buffers. So they can not be combined with `zero_copy`,
+    /// `lob_threshold` or `initial_batch_size`. `NULL` for no attributes.
+    pub statement_attributes: *const ArrowOdbcAttribute,
+    /// Number of elements in `statement_attributes`.
+    pub statement_attributes_len: usize,
+    /// Optional pointer to an array of integer valued connection attributes, e.g.
+    /// `SQL_ATTR_CONNECTION_TIMEOUT`. They are set in the order given, before the query is
+    /// executed. Attributes which must be set before connecting, like `SQL_ATTR_PACKET_SIZE`, are
+    /// rejected by most drivers and belong into the connection string. `NULL` for no attributes.
+    pub connection_attributes: *const ArrowOdbcAttribute,
+    /// Number of elements in `connection_attributes`.
+    pub connection_attributes_len: usize,
+    /// Number of rows of the first batch. Each following batch has twice as many rows, until
+    /// `batch_size` is reached. Consumers see the first rows sooner and small result sets do not
+    /// allocate buffers for a full batch. With `zero_copy` or large columns the buffers of each
+    /// batch are allocated for its size. Otherwise the smaller batches are retrieved row by row,
+    /// before buffers for `batch_size` rows are bound, unless the result set has columns which can
+    /// not be retrieved with `SQLGetData`. Batches retrieved row by row have at most 1024 rows,
+    /// buffers are bound once the next batch would be larger. `0` to start with `batch_size` rows.
+    /// Can not be combined with `initial_text_size`.
+    pub initial_batch_size: usize,
+}
+
+impl ArrowOdbcReaderOptions {
+    /// Rejects options which can not be combined, naming the first pair found.
+    fn check(&self) -> Result<(), String> {
+        let initial_text_size = self.initial_text_size != 0;
+        let lob_threshold = self.lob_threshold != 0;
+        let initial_batch_size = self.initial_batch_size != 0;
+        let statement_attributes =
+            !self.statement_attributes.is_null() && self.statement_attributes_len != 0;
+        let conflicts: [(&str, bool, &[(&str, bool)]); 4] = [
+            (
+                "initial_batch_size",
+                initial_batch_size,
+                &[("initial_text_size", initial_text_size)],
+            ),
+            (
+                "lob_threshold",
+                lob_threshold,
+                &[("initial_text_size", initial_text_size)],
+            ),
+            (
+                "statement_attributes",
+                statement_attributes,
+                &[
+                    ("zero_copy", self.zero_copy),
+                    ("lob_threshold", lob_threshold),
+                    ("initial_batch_size", initial_batch_size),
+                ],
+            ),
+            (
+                "more_results",
+                self.more_results,
+                &[
+                    ("max_text_size", self.max_text_size != 0),
+                    ("max_binary_size", self.max_binary_size != 0),
+                    ("max_bytes_per_batch", self.max_bytes_per_batch != 0),
+                    ("fetch_concurrently", self.fetch_concurrently),
+                    ("zero_copy", self.zero_copy),
+                    ("initial_text_size", initial_text_size),
+                    ("lob_threshold", lob_threshold),
+                    ("schema", !self.schema.is_null()),
+                    ("initial_batch_size", initial_batch_size),
+                ],
+            ),
+        ];
+        for (option, is_set, others) in conflicts {
+            let other = others.iter().find(|(_, other_is_set)| *other_is_set);
+            if let (true, Some((other, _))) = (is_set, other) {
+                return Err(format!("{option} can not be combined with {other}."));
+            }
+        }
+        Ok(())
+    }
+}
 
 /// Creates an Arrow ODBC reader instance.
 ///
@@ -35,17 +437,13 @@ pub struct ArrowOdbcReader(OdbcReader<CursorImpl<StatementConnection<'static>>>)
 ///   afterwards.
 /// * `query_buf` must point to a valid utf-8 string
 /// * `query_len` describes the len of `query_buf` in bytes.
+/// * `batch_size` maximum number of rows in each batch.
 /// * `parameters` must contain only valid pointers. This function takes ownership of all of them
 ///   independent if the function succeeds or not. Yet it does not take ownership of the array
 ///   itself.
 /// * `parameters_len` number of elements in parameters.
-/// * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
-///   uppper bound applies.
-/// * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
-///   that no uppper bound applies.
-/// * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
-///   to abort the process. Enabling might have a performance overhead, so it might be desirable to
-///   disable it, if you know there is enough memory available.
+/// * `options` must point to valid options. The schema and attributes they point to are copied, so
+///   they only need to outlive the call. Options which can not be combined cause an error.
 /// * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
 ///   Ownership is transferred to the caller.
 #[no_mangle]
@@ -56,16 +454,14 @@ pub unsafe extern "C" fn arrow_odbc_reader_make(
     batch_size: usize,
     parameters: *const *mut ArrowOdbcParameter,
     parameters_len: usize,
-    max_text_size: usize,
-    max_binary_size: usize,
-    fallibale_allocations: bool,
+    options: *const ArrowOdbcReaderOptions,
     reader_out: *mut *mut ArrowOdbcReader,
 ) -> *mut ArrowOdbcError {
     let query = slice::from_raw_parts(query_buf, query_len);
     let query = str::from_utf8(query).unwrap();
 
+    // Connection and parameters are owned before any error can occur, so they are freed with it.
     let connection = *Box::from_raw(connection.as_ptr());
-
     let parameters = if parameters.is_null() {
         Vec::new()
     } else {
@@ -75,6 +471,44 @@ pub unsafe extern "C" fn arrow_odbc_reader_make(
             .collect()
     };
 
+    let options = *options;
+    try_!(options.check());
+    let ArrowOdbcReaderOptions {
+        max_text_size,
+        max_binary_size,
+        fallibale_allocations,
+        max_bytes_per_batch,
+        fetch_concurrently,
+        prefetch_depth,
+        zero_copy,
+        initial_text_size,
+        lob_threshold,
+        schema,
+        buffer_pool_bytes,
+        more_results,
+        statement_attributes,
+        statement_attributes_len,
+        connection_attributes,
+        connection_attributes_len,
+        initial_batch_size,
+    } = options;
+    let prefetch_depth = fetch_concurrently.then(|| prefetch_depth);
+
+    let schema: Option<SchemaRef> = if schema.is_null() {
+        None
+    } else {
+        let schema: Schema = try_!((&*(schema as *const FFI_ArrowSchema)).try_into());
+        Some(Arc::new(schema))
+    };
+
+    let statement_attributes = attributes_from_raw(statement_attributes, statement_attributes_len);
+    let connection_attributes =
+        attributes_from_raw(connection_attributes, connection_attributes_len);
+    let connection = try_!(apply_connection_attributes(
+        connection.0,
+        &connection_attributes
+    ));
+
     let max_text_size = if max_text_size == 0 {
         None
     } else {
@@ -93,16 +527,279 @@ pub unsafe extern "C" fn arrow_odbc_reader_make(
         fallibale_allocations,
     };
 
-    let maybe_cursor = try_!(connection.0.into_cursor(query, &parameters[..]));
-    if let Some(cursor) = maybe_cursor {
-        let reader = try_!(OdbcReader::with(cursor, batch_size, None, buffer_allocation_options));
-        *reader_out = Box::into_raw(Box::new(ArrowOdbcReader(reader)))
+    let max_bytes_per_batch = if max_bytes_per_batch == 0 {
+        None
+    } else {
+        Some(max_bytes_per_batch)
+    };
+
+    if more_results {
+        // The statement must outlive the cursors of the individual result sets.
+        let mut statement = try_!(connection.into_prepared(query));
+        try_!(apply_statement_attributes(
+            &mut statement,
+            &statement_attributes
+        ));
+        let result_sets = try_!(ResultSets::new(statement, &parameters[..], batch_size));
+        if let Some(result_sets) = result_sets {
+            let reader = ArrowOdbcReader::new(Batches::ResultSets(result_sets), batch_size);
+            *reader_out = Box::into_raw(Box::new(reader))
+        } else {
+            *reader_out = null_mut()
+        }
+        return null_mut(); // Ok(())
+    }
+
+    if initial_text_size != 0 {
+        // Sizing the buffers may require executing the query more than once.
+        let mut statement = try_!(connection.into_prepared(query));
+        try_!(apply_statement_attributes(
+            &mut statement,
+            &statement_attributes
+        ));
+        let options = AdaptiveOptions {
+            batch_size,
+            initial_text_size,
+            max_text_size,
+            max_binary_size,
+            fallibale_allocations,
+            max_bytes_per_batch,
+            schema,
+        };
+        if let Some(reader) = try_!(AdaptiveReader::new(statement, &parameters[..], &options)) {
+            let batch_size = reader.batch_size();
+            let buffer_bytes = reader.buffer_bytes();
+            let batches = Batches::fetched_by(reader, Batches::Adaptive, prefetch_depth);
+            let reader = ArrowOdbcReader::new(batches, batch_size).with_buffer_bytes(buffer_bytes);
+            *reader_out = Box::into_raw(Box::new(reader))
+        } else {
+            *reader_out = null_mut()
+        }
+        return null_mut(); // Ok(())
+    }
+
+    if !statement_attributes.is_empty() {
+        // Statement attributes must be set before the statement is executed.
+        let statement = try_!(connection.into_prepared(query));
+        let options = AttributedOptions {
+            batch_size,
+            max_bytes_per_batch,
+            buffer_allocation_options,
+            schema,
+        };
+        let reader = try_!(AttributedReader::new(
+            statement,
+            &statement_attributes,
+            &parameters[..],
+            options
+        ));
+        if let Some(reader) = reader {
+            let batch_size = reader.batch_size();
+            let buffer_bytes = reader.buffer_bytes();
+            let batches = Batches::fetched_by(reader, Batches::Attributed, prefetch_depth);
+            let reader = ArrowOdbcReader::new(batches, batch_size).with_buffer_bytes(buffer_bytes);
+            *reader_out = Box::into_raw(Box::new(reader))
+        } else {
+            *reader_out = null_mut()
+        }
+        return null_mut(); // Ok(())
+    }
+
+    // Asked before the cursor takes ownership of the connection.
+    let (connection, getdata_extensions) = if lob_threshold != 0 {
+        try_!(getdata_extensions(connection))
+    } else {
+        (connection, 0)
+    };
+    let maybe_cursor = try_!(connection.into_cursor(query, &parameters[..]));
+    if let Some(mut cursor) = maybe_cursor {
+        // Estimated once, both to limit the batch size and to report the size of the buffers.
+        let bytes_per_row = try_!(bytes_per_row(&mut cursor, max_text_size, max_binary_size));
+        let batch_size = try_!(limit_batch_size(
+            batch_size,
+            max_bytes_per_batch,
+            bytes_per_row
+        ));
+        if let Some(schema) = &schema {
+            let num_cols = try_!(cursor.num_result_cols());
+            if schema.fields().len() != num_cols as usize {
+                return ArrowOdbcError::new(format!(
+                    "The schema has {} fields, yet the result set has {num_cols} columns.",
+                    schema.fields().len()
+                ))
+                .into_raw();
+            }
+        }
+        let ramp_up = RampUp::new(initial_batch_size, batch_size);
+        let infer_schema = zero_copy || lob_threshold != 0 || !ramp_up.is_complete();
+        let inferred_schema = match &schema {
+            Some(schema) if infer_schema => Some(schema.as_ref().clone()),
+            None if infer_schema => Some(try_!(arrow_schema_from(&mut cursor))),
+            _ => None,
+        };
+        let large = match &inferred_schema {
+            Some(schema) if lob_threshold != 0 => {
+                try_!(large_columns(&mut cursor, schema, lob_threshold))
+            }
+            _ => None,
+        };
+        let mut buffer_bytes = bytes_per_row * batch_size;
+        let mut pool = None;
+        let batches = match (inferred_schema, large) {
+            (Some(schema), Some(large)) => {
+                let reader = try_!(LobReader::new(cursor, &schema, &large, batch_size));
+                let reader = try_!(reader
+                    .with_ramp_up(ramp_up)
+                    .with_block_fetch(getdata_extensions));
+                // LOBs are not bound to buffers. The size of the values depends on the data.
+                buffer_bytes = reader.buffer_bytes();
+                Batches::fetched_by(reader, Batches::Lob, prefetch_depth)
+            }
+            (Some(schema), None) if zero_copy && supports_zero_copy(&schema) => {
+                let buffer_pool = BufferPool::new(buffer_pool_bytes);
+                pool = Some(buffer_pool.clone());
+                let reader = try_!(ZeroCopyReader::new(
+                    cursor,
+                    Arc::new(schema),
+                    batch_size,
+                    buffer_pool,
+                    fallibale_allocations
+                ));
+                let reader = reader.with_ramp_up(ramp_up);
+                Batches::fetched_by(reader, Batches::ZeroCopy, prefetch_depth)
+            }
+            (Some(schema), None)
+                if !ramp_up.is_complete()
+                    && schema
+                        .fields()
+                        .iter()
+                        .all(|field| is_supported(field.data_type())) =>
+            {
+                let reader = try_!(RampUpReader::new(
+                    cursor,
+                    Arc::new(schema),
+                    initial_batch_size,
+                    batch_size,
+                    buffer_allocation_options,
+                ));
+                Batches::fetched_by(reader, Batches::RampUp, prefetch_depth)
+            }
+            _ => {
+                let reader = try_!(OdbcReader::with(
+                    cursor,
+                    batch_size,
+                    schema,
+                    buffer_allocation_options
+                ));
+                Batches::fetched_by(reader, Batches::Sequential, prefetch_depth)
+            }
+        };
+        let reader = ArrowOdbcReader::new(batches, batch_size)
+            .with_buffer_bytes(buffer_bytes)
+            .with_pool(pool);
+        *reader_out = Box::into_raw(Box::new(reader))
     } else {
         *reader_out = null_mut()
     }
     null_mut() // Ok(())
 }
 
+/// Creates an Arrow ODBC reader, which executes the same query for several sets of parameters
+/// (partitions) concurrently. Each connection is used by a dedicated system thread, which executes
+/// one partition after another. The resulting reader yields the batches of all partitions. It
+/// reports the schema of the result set of the first partition executed.
+///
+/// Takes ownership of all connections even in case of an error.
+///
+/// # Safety
+///
+/// * `connections` must point to an array of `connections_len` valid OdbcConnections. This
+///   function takes ownership of all of them, even in case of an error. Yet it does not take
+///   ownership of the array itself.
+/// * `query_buf` must point to a valid utf-8 string
+/// * `query_len` describes the len of `query_buf` in bytes.
+/// * `batch_size` maximum number of rows in each batch.
+/// * `parameters` must point to an array of `num_partitions * parameters_per_partition` valid
+///   parameters. The parameters of the first partition come first, followed by the ones of the
+///   second partition and so on. This function takes ownership of all of them independent if the
+///   function succeeds or not. Yet it does not take ownership of the array itself.
+/// * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+///   uppper bound applies.
+/// * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+///   that no uppper bound applies.
+/// * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+///   to abort the process.
+/// * `ordered`: `TRUE` to yield all batches of a partition, before any batch of the next one.
+///   `FALSE` to yield batches as soon as they are fetched, regardless of the partition.
+/// * `reader_out` in case of success this will point to an instance of `ArrowOdbcReader`.
+///   Ownership is transferred to the caller.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_make_partitioned(
+    connections: *const *mut OdbcConnection,
+    connections_len: usize,
+    query_buf: *const u8,
+    query_len: usize,
+    batch_size: usize,
+    parameters: *const *mut ArrowOdbcParameter,
+    parameters_per_partition: usize,
+    num_partitions: usize,
+    max_text_size: usize,
+    max_binary_size: usize,
+    fallibale_allocations: bool,
+    ordered: bool,
+    reader_out: *mut *mut ArrowOdbcReader,
+) -> *mut ArrowOdbcError {
+    let connections = slice::from_raw_parts(connections, connections_len)
+        .iter()
+        .map(|&connection| Box::from_raw(connection).0)
+        .collect();
+
+    let query = slice::from_raw_parts(query_buf, query_len);
+    let query = str::from_utf8(query).unwrap().to_owned();
+
+    // Parameters must be owned, since they are used after this function returns.
+    let parameters: Vec<_> = if parameters.is_null() {
+        Vec::new()
+    } else {
+        slice::from_raw_parts(parameters, parameters_per_partition * num_partitions)
+            .iter()
+            .map(|&p| Box::from_raw(p).into_owned())
+            .collect()
+    };
+    let mut parameters = parameters.into_iter();
+    let partitions = (0..num_partitions)
+        .map(|_| parameters.by_ref().take(parameters_per_partition).collect())
+        .collect();
+
+    let options = ReadOptions {
+        batch_size,
+        max_text_size: if max_text_size == 0 {
+            None
+        } else {
+            Some(max_text_size)
+        },
+        max_binary_size: if max_binary_size == 0 {
+            None
+        } else {
+            Some(max_binary_size)
+        },
+        fallibale_allocations,
+    };
+
+    let reader = try_!(PartitionedReader::new(
+        connections,
+        query,
+        partitions,
+        options,
+        ordered
+    ));
+    *reader_out = Box::into_raw(Box::new(ArrowOdbcReader::new(
+        Batches::Partitioned(reader),
+        batch_size,
+    )));
+    null_mut() // Ok(())
+}
+
 /// Frees the resources associated with an ArrowOdbcReader
 ///
 /// # Safety
@@ -127,29 +824,9 @@ pub unsafe extern "C" fn arrow_odbc_reader_next(
     let schema = schema as *mut FFI_ArrowSchema;
     let array = array as *mut FFI_ArrowArray;
 
-    if let Some(result) = reader.as_mut().0.next() {
-        *array = FFI_ArrowArray::empty();
-        *schema = FFI_ArrowSchema::empty();
-
+    if let Some(result) = reader.as_mut().next_batch() {
         let batch = try_!(result);
-        let struct_array: StructArray = batch.into();
-
-        let (ffi_array_ptr, ffi_schema_ptr) = try_!(struct_array.to_raw());
-
-        // In order to avoid memory leaks we must convert both pointers returned by the  `to_raw`
-        // method. So we must back to `Arc` again, so they are freed at the end of this function
-        // call in order to avoid memory leaks. Furthermore it is the callers responsibility to
-        // provide us with the FFI_Arrow* structures to fill, and the caller maintains ownership
-        // over them.
-
-        let mut arc_schema = Arc::from_raw(ffi_schema_ptr);
-        let source_schema = Arc::get_mut(&mut arc_schema).unwrap();
-        swap(&mut *schema, source_schema);
-
-        let mut arc_array = Arc::from_raw(ffi_array_ptr);
-        let source_array = Arc::get_mut(&mut arc_array).unwrap();
-        swap(&mut *array, source_array);
-
+        try_!(export_batch(reader.as_mut(), batch, array, schema));
         *has_next_out = 1;
     } else {
         *has_next_out = 0;
@@ -157,6 +834,154 @@ pub unsafe extern "C" fn arrow_odbc_reader_next(
     null_mut()
 }
 
+/// Like [`arrow_odbc_reader_next`], but returns immediately if the next batch is still fetched by
+/// another thread. In that case `pending_out` is set to `TRUE` and `array` and `schema` are left
+/// untouched. Use [`arrow_odbc_reader_notify`] to learn when to try again. Readers not fetching
+/// concurrently block, like [`arrow_odbc_reader_next`].
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+/// * `array_out` and `schema_out` must both point to valid pointers, which themselves may be null.
+/// * `has_next_out` and `pending_out` must be valid pointers.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_try_next(
+    mut reader: NonNull<ArrowOdbcReader>,
+    array: *mut c_void,
+    schema: *mut c_void,
+    has_next_out: *mut c_int,
+    pending_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    let schema = schema as *mut FFI_ArrowSchema;
+    let array = array as *mut FFI_ArrowArray;
+
+    match reader.as_mut().try_next_batch() {
+        Poll::Pending => {
+            *pending_out = true;
+            return null_mut();
+        }
+        Poll::Ready(Some(result)) => {
+            *pending_out = false;
+            let batch = try_!(result);
+            try_!(export_batch(reader.as_mut(), batch, array, schema));
+            *has_next_out = 1;
+        }
+        Poll::Ready(None) => {
+            *pending_out = false;
+            *has_next_out = 0;
+        }
+    }
+    null_mut()
+}
+
+/// Makes a reader fetching concurrently write to `socket` each time it is about to hand over a
+/// batch, and once the result set is consumed. An event loop can wait for the socket to become
+/// readable, before calling [`arrow_odbc_reader_try_next`] again. Notifications may be spurious,
+/// and several of them may be written for one batch.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`] with
+///   `fetch_concurrently` set to `TRUE`.
+/// * `socket` must be the file descriptor (a `SOCKET` on windows) of a non-blocking stream socket,
+///   e.g. one end of a socket pair. It must stay open until the reader is freed, it is not closed
+///   by the reader.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_notify(
+    reader: NonNull<ArrowOdbcReader>,
+    socket: u64,
+) -> *mut ArrowOdbcError {
+    match &reader.as_ref().batches {
+        Batches::Concurrent(concurrent) => {
+            concurrent.notification().set_socket(socket);
+            null_mut() // Ok(())
+        }
+        _ => ArrowOdbcError::new("Only readers fetching concurrently can notify.").into_raw(),
+    }
+}
+
+/// Advances a reader created with `more_results` to the next result set, which may have another
+/// schema. Batches of the current result set not fetched yet are discarded. `has_more_out` is set
+/// to `FALSE` once all result sets are consumed.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`] with
+///   `more_results` set to `TRUE`.
+/// * `has_more_out` must be a valid pointer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_next_result_set(
+    mut reader: NonNull<ArrowOdbcReader>,
+    has_more_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    let reader = reader.as_mut();
+    match &mut reader.batches {
+        Batches::ResultSets(result_sets) => {
+            *has_more_out = try_!(result_sets.next_result_set());
+            // Columns to encode refer to the schema of the previous result set.
+            reader.encoder = None;
+            null_mut() // Ok(())
+        }
+        _ => ArrowOdbcError::new(
+            "Only readers created with more_results can advance to the next result set.",
+        )
+        .into_raw(),
+    }
+}
+
+/// Moves the batch into the C Data Interface structures provided by the caller.
+unsafe fn export_batch(
+    reader: &mut ArrowOdbcReader,
+    batch: RecordBatch,
+    array: *mut FFI_ArrowArray,
+    schema: *mut FFI_ArrowSchema,
+) -> Result<(), ArrowError> {
+    let export_start = Instant::now();
+    let struct_array: StructArray = batch.into();
+    export_array(&struct_array, array, schema)?;
+    reader.stats.export_ns += export_start.elapsed().as_nanos() as u64;
+    Ok(())
+}
+
+/// Moves the array into the C Data Interface structures provided by the caller.
+unsafe fn export_array(
+    source: &dyn Array,
+    array: *mut FFI_ArrowArray,
+    schema: *mut FFI_ArrowSchema,
+) -> Result<(), ArrowError> {
+    *array = FFI_ArrowArray::empty();
+    *schema = FFI_ArrowSchema::empty();
+
+    let (ffi_array_ptr, ffi_schema_ptr) = source.to_raw()?;
+
+    // In order to avoid memory leaks we must convert both pointers returned by the  `to_raw`
+    // method. So we must back to `Arc` again, so they are freed at the end of this function
+    // call in order to avoid memory leaks. Furthermore it is the callers responsibility to
+    // provide us with the FFI_Arrow* structures to fill, and the caller maintains ownership
+    // over them.
+
+    let mut arc_schema = Arc::from_raw(ffi_schema_ptr);
+    let source_schema = Arc::get_mut(&mut arc_schema).unwrap();
+    swap(&mut *schema, source_schema);
+
+    let mut arc_array = Arc::from_raw(ffi_array_ptr);
+    let source_array = Arc::get_mut(&mut arc_array).unwrap();
+    swap(&mut *array, source_array);
+    Ok(())
+}
+
+/// Maximum number of rows in each batch yielded by the reader. This may be smaller than the
+/// `batch_size` requested in [`arrow_odbc_reader_make`], if an upper limit for the size of a batch
+/// in bytes has been specified.
+///
+/// # Safety
+///
+/// `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_batch_size(reader: NonNull<ArrowOdbcReader>) -> usize {
+    reader.as_ref().batch_size
+}
+
 /// Retrieve the associated schema from a reader.
 #[no_mangle]
 pub unsafe extern "C" fn arrow_odbc_reader_schema(
@@ -165,10 +990,116 @@ pub unsafe extern "C" fn arrow_odbc_reader_schema(
 ) -> *mut ArrowOdbcError {
     let out_schema: *mut FFI_ArrowSchema = out_schema as *mut FFI_ArrowSchema;
 
-    let reader = &mut reader.as_mut().0;
-    let schema_ref = reader.schema();
+    let schema_ref = reader.as_mut().schema();
     let schema = &*schema_ref;
     let schema_ffi = try_!(schema.try_into());
     *out_schema = schema_ffi;
     null_mut()
 }
+
+/// Dictionary encode a text column of the batches yielded by the reader from now on. The
+/// dictionary persists across batches, so each value keeps its key for the entire result set. The
+/// schema reported for the reader changes accordingly. Fetching a batch fails once the column
+/// exceeds 65536 distinct values.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+/// * `column_buf` must point to a valid utf-8 string, holding the name of a text column.
+/// * `column_len` describes the len of `column_buf` in bytes.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_dictionary_encode(
+    mut reader: NonNull<ArrowOdbcReader>,
+    column_buf: *const u8,
+    column_len: usize,
+) -> *mut ArrowOdbcError {
+    let column = slice::from_raw_parts(column_buf, column_len);
+    let column = str::from_utf8(column).unwrap();
+
+    let reader = reader.as_mut();
+    // The schema changes with each result set, yet the dictionaries would persist.
+    if matches!(reader.batches, Batches::ResultSets(_)) {
+        return ArrowOdbcError::new("more_results can not be combined with dictionary_columns.")
+            .into_raw();
+    }
+    let source_schema = reader.source_schema();
+    let encoder = reader
+        .encoder
+        .get_or_insert_with(|| DictionaryEncoder::new(source_schema));
+    try_!(encoder.add_column(column));
+    null_mut() // Ok(())
+}
+
+/// Track the largest value of a column in the batches yielded by the reader from now on, e.g. to
+/// start the next incremental extract after it. Retrieve it with [`arrow_odbc_reader_watermark`].
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+/// * `column_buf` must point to a valid utf-8 string, holding the name of an integer, floating
+///   point, date, timestamp or text column.
+/// * `column_len` describes the len of `column_buf` in bytes.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_track_watermark(
+    mut reader: NonNull<ArrowOdbcReader>,
+    column_buf: *const u8,
+    column_len: usize,
+) -> *mut ArrowOdbcError {
+    let column = slice::from_raw_parts(column_buf, column_len);
+    let column = str::from_utf8(column).unwrap();
+
+    let reader = reader.as_mut();
+    let watermark = try_!(Watermark::new(&reader.source_schema(), column));
+    reader.watermark = Some(watermark);
+    null_mut() // Ok(())
+}
+
+/// Exports the largest value of the column tracked with [`arrow_odbc_reader_track_watermark`], as
+/// an array with a single element. `has_value_out` is set to `FALSE` if there has not been any
+/// value yet, other than `NULL`. The structures are not touched in that case.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+/// * `array` must be a valid pointer to an `FFI_ArrowArray`, which is overwritten.
+/// * `schema` must be a valid pointer to an `FFI_ArrowSchema`, which is overwritten.
+/// * `has_value_out` must be a valid pointer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_watermark(
+    reader: NonNull<ArrowOdbcReader>,
+    array: *mut c_void,
+    schema: *mut c_void,
+    has_value_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    let max = match &reader.as_ref().watermark {
+        Some(watermark) => watermark.max(),
+        None => {
+            return ArrowOdbcError::new("The reader does not track a watermark.").into_raw();
+        }
+    };
+    match max {
+        Some(max) => {
+            let array = array as *mut FFI_ArrowArray;
+            let schema = schema as *mut FFI_ArrowSchema;
+            try_!(export_array(max.as_ref(), array, schema));
+            *has_value_out = true;
+        }
+        None => *has_value_out = false,
+    }
+    null_mut() // Ok(())
+}
+
+/// Cumulative counters of the reader, e.g. to tell time spent fetching from the data source apart
+/// from time spent exporting batches.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`arrow_odbc_reader_make`].
+/// * `stats_out` must point to a valid `ArrowOdbcReaderStats`, which is overwritten.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_stats(
+    reader: NonNull<ArrowOdbcReader>,
+    stats_out: *mut ArrowOdbcReaderStats,
+) {
+    *stats_out = reader.as_ref().stats();
+}
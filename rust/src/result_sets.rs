@@ -0,0 +1,152 @@
+use std::{mem::forget, sync::Arc};
+
+use arrow_odbc::{
+    arrow::{
+        datatypes::{Schema, SchemaRef},
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    arrow_schema_from,
+    odbc_api::{
+        handles::{AsStatementRef, Statement, StatementRef},
+        parameter::InputParameter,
+        sys::{SQLMoreResults, SQLNumResultCols, SmallInt, SqlReturn},
+        CursorImpl, Prepared, StatementConnection,
+    },
+};
+
+use crate::{
+    handles::statement_error,
+    lob::{unsupported_as_text, RowFetcher},
+};
+
+/// Fetches all result sets produced by executing a statement, e.g. a stored procedure or a batch
+/// of several queries. Each result set has its own schema. Results without columns, like the row
+/// counts of inserts, are skipped. Columns of types which can not be retrieved directly, e.g.
+/// decimals, are returned as text.
+///
+/// The cursor of a result set closes all pending result sets once it is dropped. So rather than
+/// handing ownership of the cursor to a reader, the statement is owned by this type and the
+/// values are retrieved with `SQLGetData`, one row at a time. This way no buffers are bound to the
+/// statement and a cursor borrowing it is created for each batch and forgotten afterwards, see
+/// [`Self::with_cursor`]. Forgetting a cursor which only borrows the statement leaks nothing, it
+/// just skips closing the pending result sets.
+pub struct ResultSets {
+    /// Fetches the rows of the current result set. `None` once all result sets are consumed.
+    current: Option<RowFetcher>,
+    /// Schema of the current result set, or of the last one once all are consumed.
+    schema: SchemaRef,
+    /// Invariant: Positioned on a result set with columns, as long as `current` is `Some`.
+    statement: Prepared<StatementConnection<'static>>,
+    batch_size: usize,
+}
+
+impl ResultSets {
+    /// Executes the statement and positions it on the first result set with columns. `None` if
+    /// there is no such result set.
+    pub fn new(
+        mut statement: Prepared<StatementConnection<'static>>,
+        parameters: &[Box<dyn InputParameter + '_>],
+        batch_size: usize,
+    ) -> Result<Option<Self>, String> {
+        let cursor = statement
+            .execute(parameters)
+            .map_err(|error| error.to_string())?;
+        // We must not drop the cursor, since it would close the pending result sets. Cursors are
+        // created by `with_cursor` instead.
+        forget(cursor);
+        let mut result_sets = Self {
+            current: None,
+            schema: Arc::new(Schema::empty()),
+            statement,
+            batch_size,
+        };
+        while result_sets.num_result_cols()? == 0 {
+            if !result_sets.more_results()? {
+                return Ok(None);
+            }
+        }
+        result_sets.open_current()?;
+        Ok(Some(result_sets))
+    }
+
+    /// Advances to the next result set with columns. `false` if all result sets are consumed.
+    pub fn next_result_set(&mut self) -> Result<bool, String> {
+        if self.current.take().is_none() {
+            return Ok(false);
+        }
+        loop {
+            if !self.more_results()? {
+                return Ok(false);
+            }
+            if self.num_result_cols()? != 0 {
+                break;
+            }
+        }
+        self.open_current()?;
+        Ok(true)
+    }
+
+    /// Must only be called while the statement is positioned on a result set with columns.
+    fn open_current(&mut self) -> Result<(), String> {
+        let schema = self
+            .with_cursor(|cursor| arrow_schema_from(cursor))
+            .map_err(|error| error.to_string())?;
+        // There is no schema the caller could pass, so we choose text for them.
+        let schema = unsupported_as_text(&schema);
+        let large = vec![false; schema.fields().len()];
+        let rows = RowFetcher::new(&schema, &large, self.batch_size)?;
+        self.schema = rows.schema();
+        self.current = Some(rows);
+        Ok(())
+    }
+
+    /// Lends a cursor on the current result set to `f`. The cursor is forgotten rather than
+    /// dropped afterwards, so the pending result sets stay open. Must only be called while the
+    /// statement is positioned on a result set with columns.
+    fn with_cursor<T>(&mut self, f: impl FnOnce(&mut CursorImpl<StatementRef<'_>>) -> T) -> T {
+        // Safety: The statement is positioned on a result set, i.e. it is in cursor state. The
+        // cursor borrows the statement, so it can not outlive it.
+        let mut cursor = unsafe { CursorImpl::new(self.statement.as_stmt_ref()) };
+        let result = f(&mut cursor);
+        forget(cursor);
+        result
+    }
+
+    fn num_result_cols(&mut self) -> Result<SmallInt, String> {
+        let hstmt = self.statement.as_stmt_ref().as_sys();
+        let mut num_cols: SmallInt = 0;
+        match unsafe { SQLNumResultCols(hstmt, &mut num_cols) } {
+            SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(num_cols),
+            _ => Err(unsafe { statement_error(hstmt, "SQLNumResultCols") }),
+        }
+    }
+
+    /// Calls `SQLMoreResults`. `false` if there are no more results.
+    fn more_results(&mut self) -> Result<bool, String> {
+        let hstmt = self.statement.as_stmt_ref().as_sys();
+        match unsafe { SQLMoreResults(hstmt) } {
+            SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => Ok(true),
+            SqlReturn::NO_DATA => Ok(false),
+            _ => Err(unsafe { statement_error(hstmt, "SQLMoreResults") }),
+        }
+    }
+}
+
+impl Iterator for ResultSets {
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        // Taken, so the cursor may borrow the statement mutably in the meantime.
+        let mut rows = self.current.take()?;
+        let batch = self.with_cursor(|cursor| rows.next_batch(cursor));
+        self.current = Some(rows);
+        batch.transpose()
+    }
+}
+
+impl RecordBatchReader for ResultSets {
+    fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+}
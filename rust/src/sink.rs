@@ -0,0 +1,194 @@
+use std::{
+    error::Error,
+    fs::File,
+    io::BufWriter,
+    path::Path,
+    ptr::{null_mut, NonNull},
+    slice, str,
+    sync::mpsc::sync_channel,
+    thread,
+};
+
+use arrow_odbc::arrow::{ipc::writer::FileWriter, record_batch::RecordBatch};
+use parquet::{arrow::ArrowWriter, basic::Compression, file::properties::WriterProperties};
+
+use crate::{reader::ArrowOdbcReader, try_, ArrowOdbcError};
+
+type SinkError = Box<dyn Error + Send + Sync>;
+
+/// Path of a file, as encoded by `os.fsencode`. On Unix paths are arbitrary bytes, which need not
+/// be valid utf-8. Elsewhere they are encoded as utf-8.
+///
+/// # Safety
+///
+/// `path_buf` must point to `path_len` valid bytes, which outlive the returned path.
+pub unsafe fn path_from_raw<'a>(path_buf: *const u8, path_len: usize) -> Result<&'a Path, String> {
+    let path = slice::from_raw_parts(path_buf, path_len);
+    #[cfg(unix)]
+    {
+        use std::{ffi::OsStr, os::unix::ffi::OsStrExt};
+        Ok(Path::new(OsStr::from_bytes(path)))
+    }
+    #[cfg(not(unix))]
+    {
+        str::from_utf8(path)
+            .map(Path::new)
+            .map_err(|error| format!("Path is not valid utf-8: {error}"))
+    }
+}
+
+/// File format the batches of a reader are encoded into.
+trait Sink: Send + 'static {
+    fn write(&mut self, batch: &RecordBatch) -> Result<(), SinkError>;
+
+    /// Writes footers and metadata. The file is incomplete without it.
+    fn finish(self) -> Result<(), SinkError>;
+}
+
+impl Sink for ArrowWriter<File> {
+    fn write(&mut self, batch: &RecordBatch) -> Result<(), SinkError> {
+        Ok(ArrowWriter::write(self, batch)?)
+    }
+
+    fn finish(self) -> Result<(), SinkError> {
+        self.close()?;
+        Ok(())
+    }
+}
+
+impl Sink for FileWriter<BufWriter<File>> {
+    fn write(&mut self, batch: &RecordBatch) -> Result<(), SinkError> {
+        Ok(FileWriter::write(self, batch)?)
+    }
+
+    fn finish(mut self) -> Result<(), SinkError> {
+        FileWriter::finish(&mut self)?;
+        Ok(())
+    }
+}
+
+/// Writes the remaining batches of the reader to a Parquet file. Batches are encoded by a
+/// dedicated system thread, while the calling thread fetches the next one. They never leave Rust,
+/// so they do not need to be exported over the C Data Interface.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`]. It is
+///   not freed by this function.
+/// * `path_buf` must point to the path of the file, encoded like `os.fsencode` does. An existing
+///   file is overwritten.
+/// * `path_len` describes the len of `path_buf` in bytes.
+/// * `row_group_size` maximum number of rows in each row group. Batches are buffered until enough
+///   rows for a row group are collected. Use `0` for the default of the parquet crate.
+/// * `compression_buf` must point to a valid utf-8 string. One of `uncompressed`, `snappy`,
+///   `gzip`, `brotli`, `lz4` or `zstd`.
+/// * `compression_len` describes the len of `compression_buf` in bytes.
+/// * `rows_out` in case of success this will hold the number of rows written.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_write_parquet(
+    mut reader: NonNull<ArrowOdbcReader>,
+    path_buf: *const u8,
+    path_len: usize,
+    row_group_size: usize,
+    compression_buf: *const u8,
+    compression_len: usize,
+    rows_out: *mut u64,
+) -> *mut ArrowOdbcError {
+    let path = try_!(path_from_raw(path_buf, path_len));
+
+    let compression = slice::from_raw_parts(compression_buf, compression_len);
+    let compression = str::from_utf8(compression).unwrap();
+    let compression = match compression {
+        "uncompressed" => Compression::UNCOMPRESSED,
+        "snappy" => Compression::SNAPPY,
+        "gzip" => Compression::GZIP,
+        "brotli" => Compression::BROTLI,
+        "lz4" => Compression::LZ4,
+        "zstd" => Compression::ZSTD,
+        other => {
+            return ArrowOdbcError::new(format!("Unknown parquet compression: {other}")).into_raw()
+        }
+    };
+    let mut properties = WriterProperties::builder().set_compression(compression);
+    if row_group_size != 0 {
+        properties = properties.set_max_row_group_size(row_group_size);
+    }
+    let properties = properties.build();
+
+    let file = try_!(File::create(path));
+    let reader = reader.as_mut();
+    let writer = try_!(ArrowWriter::try_new(
+        file,
+        reader.schema(),
+        Some(properties)
+    ));
+    *rows_out = try_!(write_batches(reader, writer));
+    null_mut() // Ok(())
+}
+
+/// Writes the remaining batches of the reader to an Arrow IPC file, also known as Feather V2.
+/// Batches are encoded by a dedicated system thread, while the calling thread fetches the next
+/// one.
+///
+/// # Safety
+///
+/// * `reader` must be valid non-null reader, allocated by [`crate::arrow_odbc_reader_make`]. It is
+///   not freed by this function.
+/// * `path_buf` must point to the path of the file, encoded like `os.fsencode` does. An existing
+///   file is overwritten.
+/// * `path_len` describes the len of `path_buf` in bytes.
+/// * `rows_out` in case of success this will hold the number of rows written.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_reader_write_ipc(
+    mut reader: NonNull<ArrowOdbcReader>,
+    path_buf: *const u8,
+    path_len: usize,
+    rows_out: *mut u64,
+) -> *mut ArrowOdbcError {
+    let path = try_!(path_from_raw(path_buf, path_len));
+
+    let file = BufWriter::new(try_!(File::create(path)));
+    let reader = reader.as_mut();
+    let writer = try_!(FileWriter::try_new(file, &reader.schema()));
+    *rows_out = try_!(write_batches(reader, writer));
+    null_mut() // Ok(())
+}
+
+/// Fetches batches on the calling thread and hands them to an encoding thread, which writes them
+/// to the sink. Returns the number of rows written.
+fn write_batches(reader: &mut ArrowOdbcReader, mut sink: impl Sink) -> Result<u64, SinkError> {
+    // One batch waiting in the channel, while the encoding thread is busy with the previous one, is
+    // enough to keep both threads busy. More would only hold on to additional memory.
+    let (sender, receiver) = sync_channel::<RecordBatch>(1);
+    let encode_thread = thread::spawn(move || {
+        for batch in receiver {
+            sink.write(&batch)?;
+        }
+        sink.finish()
+    });
+
+    let mut num_rows = 0;
+    let mut fetch_result = Ok(());
+    while let Some(batch) = reader.next_batch() {
+        match batch {
+            Ok(batch) => {
+                num_rows += batch.num_rows() as u64;
+                if sender.send(batch).is_err() {
+                    // Encoding thread hung up due to an error, which we get from joining it.
+                    break;
+                }
+            }
+            Err(error) => {
+                fetch_result = Err(error);
+                break;
+            }
+        }
+    }
+    // Hanging up lets the encoding thread finish the file.
+    drop(sender);
+    // Panics abort the process, so joining can not fail.
+    let encode_result = encode_thread.join().unwrap();
+    fetch_result?;
+    encode_result?;
+    Ok(num_rows)
+}
@@ -0,0 +1,92 @@
+use std::{
+    mem::forget,
+    sync::{Arc, Mutex},
+};
+
+use arrow_odbc::odbc_api::{
+    handles::{AsStatementRef, StatementRef},
+    parameter::InputParameter,
+    CursorImpl, Prepared, StatementConnection,
+};
+
+type Statement = Prepared<StatementConnection<'static>>;
+
+/// Holds a prepared statement in between executions. Executing it lends the statement to the
+/// cursor of the result set, which owns it until it is dropped. This way readers own their cursor
+/// and statement outright, instead of borrowing a statement they are stored next to. Cloning
+/// yields a handle to the same slot.
+#[derive(Clone)]
+pub struct StatementSlot(Arc<Mutex<Option<Statement>>>);
+
+impl StatementSlot {
+    pub fn new(statement: Statement) -> Self {
+        Self(Arc::new(Mutex::new(Some(statement))))
+    }
+
+    /// Executes the statement. The cursor owns the statement until it is dropped, after which it
+    /// returns to this slot. `None` if the statement does not produce a result set. Fails if the
+    /// cursor of a previous execution still owns the statement.
+    pub fn execute(
+        &self,
+        parameters: &[Box<dyn InputParameter + '_>],
+    ) -> Result<Option<CursorImpl<LentStatement>>, String> {
+        let mut statement = self.0.lock().unwrap().take().ok_or_else(|| {
+            "The cursor of the previous execution must be closed, before the statement can be \
+            executed again."
+                .to_owned()
+        })?;
+        let has_cursor = statement.execute(parameters).map(|cursor| {
+            let has_cursor = cursor.is_some();
+            // This cursor only borrows the statement. It must not close the result set, which is
+            // read through the cursor owning the statement instead.
+            forget(cursor);
+            has_cursor
+        });
+        match has_cursor {
+            Ok(true) => {
+                let lent = LentStatement {
+                    statement: Some(statement),
+                    slot: self.clone(),
+                };
+                // Safety: The statement has just been executed and produced a result set, so it
+                // is in cursor state.
+                Ok(Some(unsafe { CursorImpl::new(lent) }))
+            }
+            Ok(false) => {
+                self.put_back(statement);
+                Ok(None)
+            }
+            Err(error) => {
+                self.put_back(statement);
+                Err(error.to_string())
+            }
+        }
+    }
+
+    fn put_back(&self, statement: Statement) {
+        *self.0.lock().unwrap() = Some(statement);
+    }
+}
+
+/// A statement owned by the cursor of its current result set. Returns to its [`StatementSlot`] once
+/// dropped. The cursor closes the result set before, so the statement is ready to be executed
+/// again.
+pub struct LentStatement {
+    /// Only `None` during drop.
+    statement: Option<Statement>,
+    slot: StatementSlot,
+}
+
+impl AsStatementRef for LentStatement {
+    fn as_stmt_ref(&mut self) -> StatementRef<'_> {
+        self.statement.as_mut().unwrap().as_stmt_ref()
+    }
+}
+
+impl Drop for LentStatement {
+    fn drop(&mut self) {
+        if let Some(statement) = self.statement.take() {
+            self.slot.put_back(statement);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+use std::{
+    sync::atomic::{AtomicU64, Ordering},
+    time::{Duration, Instant},
+};
+
+/// Cumulative counters of a reader, since it has been created. Durations are in nanoseconds.
+#[repr(C)]
+#[derive(Clone, Copy, Default)]
+pub struct ArrowOdbcReaderStats {
+    /// Number of batches handed out.
+    pub batches: u64,
+    /// Number of rows in the batches handed out.
+    pub rows: u64,
+    /// Memory occupied by the arrays of the batches handed out.
+    pub bytes: u64,
+    /// Estimated size of the buffers bound to the cursor. `0` if the reader does not bind buffers,
+    /// or their size is not known.
+    pub buffer_bytes: u64,
+    /// Time spent fetching batches. Most strategies convert the values into Arrow arrays while
+    /// fetching, so this includes the conversion done by `arrow-odbc`. With concurrent fetching
+    /// this is the time spent waiting for the fetch thread.
+    pub fetch_ns: u64,
+    /// Time spent converting batches after they have been fetched, i.e. dictionary encoding.
+    pub conversion_ns: u64,
+    /// Time spent exporting batches over the C Data Interface.
+    pub export_ns: u64,
+    /// Memory held by the buffer pool of the reader, including buffers of batches not yet released
+    /// by the consumer. `0` if the reader does not allocate from a pool.
+    pub pool_bytes: u64,
+    /// Number of Arrow buffers which reused the memory of buffers released by the consumer.
+    pub pool_reuses: u64,
+}
+
+/// Cumulative counters of a writer, since it has been created. Durations are in nanoseconds.
+#[repr(C)]
+#[derive(Clone, Copy, Default)]
+pub struct ArrowOdbcWriterStats {
+    /// Number of batches passed to the writer.
+    pub batches: u64,
+    /// Number of rows in the batches passed to the writer.
+    pub rows: u64,
+    /// Memory occupied by the arrays of the batches passed to the writer.
+    pub bytes: u64,
+    /// Number of chunks sent to the database.
+    pub chunks: u64,
+    /// Time spent importing batches over the C Data Interface.
+    pub import_ns: u64,
+    /// Time the caller has been blocked writing batches and flushing. Pipelined and parallel
+    /// writers only block while handing over batches.
+    pub write_ns: u64,
+    /// Time spent filling the chunks and executing the insert statement, summed over all
+    /// connections of the writer. Divide by `chunks` to get the time per chunk.
+    pub execute_ns: u64,
+    /// Time spent committing transactions, summed over all connections of the writer.
+    pub commit_ns: u64,
+}
+
+/// Counters updated by the writers owning the connections, which may run on other threads than
+/// the one owning the [`ArrowOdbcWriterStats`].
+#[derive(Default)]
+pub struct ExecuteCounters {
+    pub chunks: AtomicU64,
+    pub execute_ns: AtomicU64,
+    pub commit_ns: AtomicU64,
+}
+
+impl ExecuteCounters {
+    /// Copies the counters into `stats`.
+    pub fn read_into(&self, stats: &mut ArrowOdbcWriterStats) {
+        stats.chunks = self.chunks.load(Ordering::Relaxed);
+        stats.execute_ns = self.execute_ns.load(Ordering::Relaxed);
+        stats.commit_ns = self.commit_ns.load(Ordering::Relaxed);
+    }
+}
+
+/// Adds the time `f` takes to `counter`.
+pub fn timed<T>(counter: &mut u64, f: impl FnOnce() -> T) -> T {
+    let start = Instant::now();
+    let result = f();
+    *counter += nanos(start.elapsed());
+    result
+}
+
+/// Like [`timed`], for counters which are shared between threads.
+pub fn timed_atomic<T>(counter: &AtomicU64, f: impl FnOnce() -> T) -> T {
+    let start = Instant::now();
+    let result = f();
+    counter.fetch_add(nanos(start.elapsed()), Ordering::Relaxed);
+    result
+}
+
+fn nanos(duration: Duration) -> u64 {
+    duration.as_nanos().try_into().unwrap_or(u64::MAX)
+}
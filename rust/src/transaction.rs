@@ -0,0 +1,176 @@
+use std::{
+    cmp::min,
+    sync::{atomic::Ordering, Arc},
+};
+
+use arrow_odbc::{
+    arrow::record_batch::RecordBatch,
+    odbc_api::{
+        sys::{CompletionType, HDbc},
+        Connection, StatementConnection,
+    },
+    OdbcWriter, WriterError,
+};
+
+use crate::{
+    handles::end_transaction,
+    stats::{timed_atomic, ExecuteCounters},
+};
+
+/// When the rows inserted by a writer are committed.
+#[derive(Clone, Copy)]
+pub enum CommitPolicy {
+    /// The driver commits every chunk once it is executed.
+    Autocommit,
+    /// Commit once the given number of chunks has been executed, and once more at flush.
+    EveryChunks(usize),
+    /// All rows are inserted in a single transaction, committed at flush.
+    OnFlush,
+}
+
+impl CommitPolicy {
+    /// Interprets the arguments passed over the C interface. `commit_every` is the number of chunks
+    /// per transaction, `0` meaning only once at flush. It is ignored if `autocommit` is `TRUE`.
+    pub fn new(autocommit: bool, commit_every: usize) -> Self {
+        match (autocommit, commit_every) {
+            (true, _) => CommitPolicy::Autocommit,
+            (false, 0) => CommitPolicy::OnFlush,
+            (false, n) => CommitPolicy::EveryChunks(n),
+        }
+    }
+}
+
+/// Wraps an `OdbcWriter` and controls the transactions of its connection. In case of an error
+/// the current transaction is rolled back.
+pub struct CommittingWriter {
+    writer: OdbcWriter<StatementConnection<'static>>,
+    /// Handle of the connection owned by `writer`. Only used while `writer` is alive.
+    hdbc: HDbc,
+    policy: CommitPolicy,
+    chunk_size: usize,
+    /// Total number of rows handed to `writer` so far.
+    num_rows: usize,
+    /// Number of chunks executed at the time of the last commit.
+    num_chunks_committed: usize,
+    /// Rows handed to `writer`, which have not been executed yet.
+    pending_rows: usize,
+    /// Shared with the owner of the writer, which may live on another thread.
+    counters: Arc<ExecuteCounters>,
+}
+
+impl CommittingWriter {
+    /// Applies the commit policy to the connection and creates the writer using it. Time spent
+    /// executing chunks and committing is added to `counters`.
+    pub fn new(
+        connection: Connection<'static>,
+        chunk_size: usize,
+        policy: CommitPolicy,
+        counters: Arc<ExecuteCounters>,
+        make_writer: impl FnOnce(
+            Connection<'static>,
+        ) -> Result<OdbcWriter<StatementConnection<'static>>, String>,
+    ) -> Result<Self, String> {
+        if !matches!(policy, CommitPolicy::Autocommit) {
+            connection
+                .set_autocommit(false)
+                .map_err(|error| error.to_string())?;
+        }
+        // The writer takes ownership of the connection, yet we still need its handle to end
+        // transactions.
+        let hdbc = connection.into_sys();
+        let connection = unsafe { Connection::from_handle(hdbc) };
+        let writer = make_writer(connection)?;
+        Ok(Self {
+            writer,
+            hdbc,
+            policy,
+            chunk_size,
+            num_rows: 0,
+            num_chunks_committed: 0,
+            pending_rows: 0,
+            counters,
+        })
+    }
+
+    pub fn write_batch(&mut self, batch: &RecordBatch) -> Result<(), String> {
+        // The writer executes a chunk each time its buffer is full, which may happen several times
+        // within one batch. Handing it slices ending at chunk boundaries, so we can commit right
+        // after the chunk completing a transaction is executed.
+        let mut offset = 0;
+        while offset < batch.num_rows() {
+            let room = self.chunk_size - self.pending_rows;
+            let len = min(room, batch.num_rows() - offset);
+            self.write_slice(&batch.slice(offset, len))?;
+            offset += len;
+        }
+        Ok(())
+    }
+
+    /// Writes rows filling at most the remainder of the current chunk.
+    fn write_slice(&mut self, batch: &RecordBatch) -> Result<(), String> {
+        let written = timed_atomic(&self.counters.execute_ns, || self.writer.write_batch(batch));
+        if let Err(error) = written {
+            return Err(self.rollback(error));
+        }
+        self.num_rows += batch.num_rows();
+        self.pending_rows += batch.num_rows();
+        let executed = self.pending_rows / self.chunk_size;
+        self.pending_rows %= self.chunk_size;
+        self.counters
+            .chunks
+            .fetch_add(executed as u64, Ordering::Relaxed);
+        if let CommitPolicy::EveryChunks(chunks_per_transaction) = self.policy {
+            let num_chunks = self.num_rows / self.chunk_size;
+            if num_chunks - self.num_chunks_committed >= chunks_per_transaction {
+                self.commit()?;
+                self.num_chunks_committed = num_chunks;
+            }
+        }
+        Ok(())
+    }
+
+    pub fn flush(&mut self) -> Result<(), String> {
+        let flushed = timed_atomic(&self.counters.execute_ns, || self.writer.flush());
+        if let Err(error) = flushed {
+            return Err(self.rollback(error));
+        }
+        if self.pending_rows != 0 {
+            // The last chunk has not been full.
+            self.counters.chunks.fetch_add(1, Ordering::Relaxed);
+            self.pending_rows = 0;
+        }
+        if !matches!(self.policy, CommitPolicy::Autocommit) {
+            self.commit()?;
+        }
+        Ok(())
+    }
+
+    fn commit(&mut self) -> Result<(), String> {
+        let hdbc = self.hdbc;
+        timed_atomic(&self.counters.commit_ns, || unsafe {
+            end_transaction(hdbc, CompletionType::Commit)
+        })
+    }
+
+    /// Rolls back the current transaction and returns the error which caused it.
+    fn rollback(&mut self, error: WriterError) -> String {
+        let mut message = error.to_string();
+        if !matches!(self.policy, CommitPolicy::Autocommit) {
+            let rolled_back = unsafe { end_transaction(self.hdbc, CompletionType::Rollback) };
+            if let Err(rollback_error) = rolled_back {
+                message = format!("{message}\nRollback failed: {rollback_error}");
+            }
+        }
+        message
+    }
+}
+
+impl Drop for CommittingWriter {
+    fn drop(&mut self) {
+        // Rows not committed explicitly are discarded, rather than leaving it to the driver what
+        // happens to an open transaction on disconnect.
+        if !matches!(self.policy, CommitPolicy::Autocommit) {
+            let _ = unsafe { end_transaction(self.hdbc, CompletionType::Rollback) };
+        }
+    }
+}
@@ -0,0 +1,123 @@
+use std::{
+    ptr::{null_mut, NonNull},
+    slice, str,
+};
+
+use arrow_odbc::{
+    arrow::record_batch::RecordBatchReader, BufferAllocationOptions, OdbcReader, OdbcWriter,
+};
+
+use crate::{
+    concurrent::ConcurrentOdbcReader, parameter::ArrowOdbcParameter, try_, ArrowOdbcError,
+    OdbcConnection,
+};
+
+/// Executes a query on the source connection and inserts the result set into a table of the
+/// target connection. Batches are fetched by a dedicated system thread, while the calling thread
+/// inserts the previous batch. Batches never leave Rust, so they do not need to be exported over
+/// the C Data Interface.
+///
+/// Takes ownership of both connections even in case of an error.
+///
+/// # Safety
+///
+/// * `source` and `target` must point to valid OdbcConnections. This function takes ownership of
+///   both of them, even in case of an error. So the connections must not be freed explicitly
+///   afterwards.
+/// * `query_buf` must point to a valid utf-8 string
+/// * `query_len` describes the len of `query_buf` in bytes.
+/// * `parameters` must contain only valid pointers. This function takes ownership of all of them
+///   independent if the function succeeds or not. Yet it does not take ownership of the array
+///   itself.
+/// * `parameters_len` number of elements in parameters.
+/// * `batch_size` maximum number of rows fetched in each batch.
+/// * `max_text_size` optional upper bound for the size of text columns. Use `0` to indicate that no
+///   uppper bound applies.
+/// * `max_binary_size` optional upper bound for the size of binary columns. Use `0` to indicate
+///   that no uppper bound applies.
+/// * `fallibale_allocations`: `TRUE` if allocations should return an error, `FALSE` if it is fine
+///   to abort the process.
+/// * `prefetch_depth`: Maximum number of batches fetched ahead of the inserting thread. `0` is
+///   treated like `1`.
+/// * `table_buf` must point to a valid utf-8 string
+/// * `table_len` describes the len of `table_buf` in bytes.
+/// * `chunk_size` number of rows inserted in each round trip to the target.
+/// * `rows_out` in case of success this will hold the number of rows copied.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_copy_table(
+    source: NonNull<OdbcConnection>,
+    query_buf: *const u8,
+    query_len: usize,
+    parameters: *const *mut ArrowOdbcParameter,
+    parameters_len: usize,
+    batch_size: usize,
+    max_text_size: usize,
+    max_binary_size: usize,
+    fallibale_allocations: bool,
+    prefetch_depth: usize,
+    target: NonNull<OdbcConnection>,
+    table_buf: *const u8,
+    table_len: usize,
+    chunk_size: usize,
+    rows_out: *mut usize,
+) -> *mut ArrowOdbcError {
+    let source = *Box::from_raw(source.as_ptr());
+    let target = *Box::from_raw(target.as_ptr());
+
+    let query = slice::from_raw_parts(query_buf, query_len);
+    let query = str::from_utf8(query).unwrap();
+
+    let table = slice::from_raw_parts(table_buf, table_len);
+    let table = str::from_utf8(table).unwrap();
+
+    let parameters = if parameters.is_null() {
+        Vec::new()
+    } else {
+        slice::from_raw_parts(parameters, parameters_len)
+            .iter()
+            .map(|&p| Box::from_raw(p).unwrap())
+            .collect()
+    };
+
+    let buffer_allocation_options = BufferAllocationOptions {
+        max_text_size: if max_text_size == 0 {
+            None
+        } else {
+            Some(max_text_size)
+        },
+        max_binary_size: if max_binary_size == 0 {
+            None
+        } else {
+            Some(max_binary_size)
+        },
+        fallibale_allocations,
+    };
+
+    let cursor = match try_!(source.0.into_cursor(query, &parameters[..])) {
+        Some(cursor) => cursor,
+        None => {
+            return ArrowOdbcError::new("The source query did not produce a result set.").into_raw()
+        }
+    };
+    let reader = try_!(OdbcReader::with(
+        cursor,
+        batch_size,
+        None,
+        buffer_allocation_options
+    ));
+    let schema = reader.schema();
+    let mut writer = try_!(OdbcWriter::from_connection(
+        target.0, &schema, table, chunk_size
+    ));
+
+    let mut num_rows = 0;
+    for batch in ConcurrentOdbcReader::new(reader, prefetch_depth) {
+        let batch = try_!(batch);
+        num_rows += batch.num_rows();
+        try_!(writer.write_batch(&batch));
+    }
+    try_!(writer.flush());
+
+    *rows_out = num_rows;
+    null_mut() // Ok(())
+}
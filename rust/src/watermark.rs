@@ -0,0 +1,118 @@
+use std::sync::Arc;
+
+use arrow_odbc::arrow::{
+    array::{Array, ArrayRef, PrimitiveArray, StringArray},
+    compute::{concat, max, max_string},
+    datatypes::{
+        DataType, Date32Type, Float32Type, Float64Type, Int16Type, Int32Type, Int64Type, Int8Type,
+        Schema, TimeUnit, TimestampMicrosecondType, TimestampMillisecondType,
+        TimestampNanosecondType, TimestampSecondType, UInt8Type,
+    },
+    error::ArrowError,
+    record_batch::RecordBatch,
+};
+
+/// Tracks the largest value of a column across all batches yielded by a reader, e.g. the
+/// `updated_at` timestamp of an incremental extract. The next extract can then start where this
+/// one left off, without scanning the batches a second time.
+pub struct Watermark {
+    /// Index of the tracked column.
+    column: usize,
+    /// Array with a single element, holding the largest value seen so far. `None` if all values
+    /// seen so far have been `NULL`, or there have not been any rows yet.
+    max: Option<ArrayRef>,
+}
+
+impl Watermark {
+    /// Tracks the column with the given name. It must be of an integer, floating point, date,
+    /// timestamp or text type.
+    pub fn new(schema: &Schema, name: &str) -> Result<Self, String> {
+        let column = schema
+            .index_of(name)
+            .map_err(|_| format!("The result set has no column named '{name}'."))?;
+        let data_type = schema.field(column).data_type();
+        if !is_supported(data_type) {
+            return Err(format!(
+                "Column '{name}' is of type {data_type:?}, which can not be used as a watermark."
+            ));
+        }
+        Ok(Self { column, max: None })
+    }
+
+    /// Accounts for the values of the tracked column in the batch.
+    pub fn update(&mut self, batch: &RecordBatch) -> Result<(), ArrowError> {
+        let batch_max = match max_of(batch.column(self.column).as_ref()) {
+            Some(batch_max) => batch_max,
+            None => return Ok(()),
+        };
+        self.max = match self.max.take() {
+            Some(previous) => max_of(concat(&[previous.as_ref(), batch_max.as_ref()])?.as_ref()),
+            None => Some(batch_max),
+        };
+        Ok(())
+    }
+
+    /// Largest value seen so far, as an array with a single element.
+    pub fn max(&self) -> Option<ArrayRef> {
+        self.max.clone()
+    }
+}
+
+fn is_supported(data_type: &DataType) -> bool {
+    matches!(
+        data_type,
+        DataType::Int8
+            | DataType::Int16
+            | DataType::Int32
+            | DataType::Int64
+            | DataType::UInt8
+            | DataType::Float32
+            | DataType::Float64
+            | DataType::Date32
+            | DataType::Timestamp(_, None)
+            | DataType::Utf8
+    )
+}
+
+/// Largest value of the array, as an array of the same type with a single element. `None` if the
+/// array is empty or all its values are `NULL`.
+fn max_of(array: &dyn Array) -> Option<ArrayRef> {
+    macro_rules! primitive_max {
+        ($arrow_type:ty) => {{
+            let array = array
+                .as_any()
+                .downcast_ref::<PrimitiveArray<$arrow_type>>()
+                .unwrap();
+            let value = max(array)?;
+            Arc::new(PrimitiveArray::<$arrow_type>::from_iter_values([value])) as ArrayRef
+        }};
+    }
+
+    let largest = match array.data_type() {
+        DataType::Int8 => primitive_max!(Int8Type),
+        DataType::Int16 => primitive_max!(Int16Type),
+        DataType::Int32 => primitive_max!(Int32Type),
+        DataType::Int64 => primitive_max!(Int64Type),
+        DataType::UInt8 => primitive_max!(UInt8Type),
+        DataType::Float32 => primitive_max!(Float32Type),
+        DataType::Float64 => primitive_max!(Float64Type),
+        DataType::Date32 => primitive_max!(Date32Type),
+        DataType::Timestamp(TimeUnit::Second, None) => primitive_max!(TimestampSecondType),
+        DataType::Timestamp(TimeUnit::Millisecond, None) => {
+            primitive_max!(TimestampMillisecondType)
+        }
+        DataType::Timestamp(TimeUnit::Microsecond, None) => {
+            primitive_max!(TimestampMicrosecondType)
+        }
+        DataType::Timestamp(TimeUnit::Nanosecond, None) => {
+            primitive_max!(TimestampNanosecondType)
+        }
+        DataType::Utf8 => {
+            let array = array.as_any().downcast_ref::<StringArray>().unwrap();
+            let value = max_string(array)?;
+            Arc::new(StringArray::from(vec![value])) as ArrayRef
+        }
+        other => unreachable!("Watermarks of type {other:?} are rejected up front."),
+    };
+    Some(largest)
+}
@@ -2,24 +2,138 @@ use std::{
     ffi::c_void,
     ptr::{null_mut, NonNull},
     slice, str,
+    sync::Arc,
 };
 
 use arrow_odbc::{
     arrow::{
-        array::StructArray,
+        array::{Array, StructArray},
         datatypes::Schema,
+        error::ArrowError,
         ffi::{ArrowArray, ArrowArrayRef, FFI_ArrowArray, FFI_ArrowSchema},
         record_batch::RecordBatch,
     },
-    odbc_api::StatementConnection,
     OdbcWriter,
 };
 
-use crate::{try_, ArrowOdbcError, OdbcConnection};
+use crate::{
+    bulk::{check_bulk_options, table_writer},
+    pipelined::{ParallelWriter, PipelinedWriter},
+    stats::{timed, ArrowOdbcWriterStats, ExecuteCounters},
+    transaction::{CommitPolicy, CommittingWriter},
+    try_, ArrowOdbcError, OdbcConnection,
+};
 
 /// Opaque type holding all the state associated with an ODBC writer implementation in Rust. This
 /// type also has ownership of the ODBC Connection handle.
-pub struct ArrowOdbcWriter(OdbcWriter<StatementConnection<'static>>);
+pub struct ArrowOdbcWriter {
+    writers: Writers,
+    stats: ArrowOdbcWriterStats,
+    /// Shared with the writers owning the connections.
+    counters: Arc<ExecuteCounters>,
+}
+
+/// Strategies for inserting batches into the database.
+pub enum Writers {
+    /// Batches are inserted then `arrow_odbc_writer_write_batch` is called.
+    Sequential(CommittingWriter),
+    /// Batches are inserted by a dedicated system thread, while the caller prepares the next one.
+    Pipelined(PipelinedWriter),
+    /// Batches are distributed over several connections, each with its own insert thread.
+    Parallel(ParallelWriter),
+}
+
+impl ArrowOdbcWriter {
+    /// `counters` must be the ones the committing writers have been created with.
+    fn new(writers: Writers, counters: Arc<ExecuteCounters>) -> Self {
+        Self {
+            writers,
+            stats: ArrowOdbcWriterStats::default(),
+            counters,
+        }
+    }
+
+    /// Takes the batch out of the C Data Interface structures.
+    unsafe fn import_batch(
+        &mut self,
+        array: *mut FFI_ArrowArray,
+        schema: *mut FFI_ArrowSchema,
+    ) -> Result<RecordBatch, ArrowError> {
+        let batch = timed(&mut self.stats.import_ns, || {
+            let arrow_array = ArrowArray::try_from_raw(array, schema)?;
+            let array_data = arrow_array.to_data()?;
+            let struct_array = StructArray::from(array_data);
+            Ok::<_, ArrowError>(RecordBatch::from(&struct_array))
+        })?;
+        self.count_batch(&batch);
+        Ok(batch)
+    }
+
+    /// Accounts for a batch passed to the writer in the stats.
+    pub fn count_batch(&mut self, batch: &RecordBatch) {
+        self.stats.batches += 1;
+        self.stats.rows += batch.num_rows() as u64;
+        self.stats.bytes += batch
+            .columns()
+            .iter()
+            .map(|column| column.get_array_memory_size() as u64)
+            .sum::<u64>();
+    }
+
+    pub fn write_batch(&mut self, batch: RecordBatch) -> Result<(), String> {
+        let writers = &mut self.writers;
+        timed(&mut self.stats.write_ns, || match writers {
+            Writers::Sequential(writer) => writer.write_batch(&batch),
+            Writers::Pipelined(writer) => writer.write_batch(batch),
+            Writers::Parallel(writer) => writer.write_batch(batch),
+        })
+    }
+
+    fn flush(&mut self) -> Result<(), String> {
+        let writers = &mut self.writers;
+        timed(&mut self.stats.write_ns, || match writers {
+            Writers::Sequential(writer) => writer.flush(),
+            Writers::Pipelined(writer) => writer.flush(),
+            Writers::Parallel(writer) => writer.flush(),
+        })
+    }
+
+    /// Like `write_batch`, but does not block a pipelined writer. `false` if the batch could not
+    /// be handed over yet. Other writers block.
+    fn try_write_batch(&mut self, batch: RecordBatch) -> Result<bool, String> {
+        match &mut self.writers {
+            Writers::Pipelined(writer) => writer.try_write_batch(batch),
+            _ => self.write_batch(batch).map(|()| true),
+        }
+    }
+
+    /// Like `flush`, but does not block a pipelined writer. `false` if rows are still inserted.
+    /// Other writers block.
+    fn try_flush(&mut self) -> Result<bool, String> {
+        match &mut self.writers {
+            Writers::Pipelined(writer) => writer.try_flush(),
+            _ => self.flush().map(|()| true),
+        }
+    }
+
+    /// `true` once the operation started by `try_write_batch` or `try_flush` is complete.
+    fn poll(&mut self) -> Result<bool, String> {
+        match &mut self.writers {
+            Writers::Pipelined(writer) => writer.poll(),
+            _ => Ok(true),
+        }
+    }
+
+    fn stats(&self) -> ArrowOdbcWriterStats {
+        let mut stats = self.stats;
+        self.counters.read_into(&mut stats);
+        stats
+    }
+}
+
+/// The writer may be moved between threads. ODBC handles may be used from any thread, as long as
+/// they are not used concurrently, which exclusive access to the writer guarantees.
+unsafe impl Send for ArrowOdbcWriter {}
 
 /// Frees the resources associated with an ArrowOdbcWriter
 ///
@@ -43,6 +157,19 @@ pub unsafe extern "C" fn arrow_odbc_writer_free(writer: NonNull<ArrowOdbcWriter>
 /// * `table_buf` must point to a valid utf-8 string
 /// * `table_len` describes the len of `table_buf` in bytes.
 /// * `schema` pointer to an arrow schema.
+/// * `pipelined`: `TRUE` to insert batches on a dedicated system thread. Calls to
+///   [`arrow_odbc_writer_write_batch`] return once the batch is handed over, so the caller can
+///   prepare the next batch, while the previous one is still sent to the database. Errors are
+///   reported by the next call to write a batch or to flush.
+/// * `autocommit`: `TRUE` to let the driver commit every chunk once it is executed. `FALSE` to
+///   control transactions according to `commit_every`. In case of an error the current transaction
+///   is rolled back. Rows not committed once the writer is freed are rolled back, too.
+/// * `commit_every`: Number of chunks inserted in one transaction. `0` inserts all rows in a single
+///   transaction, committed by [`arrow_odbc_writer_flush`]. Ignored if `autocommit` is `TRUE`.
+/// * `bulk`: `TRUE` to add the hints of the database management system for large inserts to the
+///   insert statement. E.g. this takes a table lock on Microsoft SQL Server and performs a direct
+///   path insert on Oracle. Rows are still sent as arrays of parameters. Other database management
+///   systems are inserted into like with `FALSE`. Requires `autocommit` to be `TRUE`.
 /// * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
 ///   is transferred to the caller.
 #[no_mangle]
@@ -52,21 +179,159 @@ pub unsafe extern "C" fn arrow_odbc_writer_make(
     table_len: usize,
     chunk_size: usize,
     schema: *const c_void,
+    pipelined: bool,
+    autocommit: bool,
+    commit_every: usize,
+    bulk: bool,
     writer_out: *mut *mut ArrowOdbcWriter,
 ) -> *mut ArrowOdbcError {
     let connection = *Box::from_raw(connection.as_ptr());
     let connection = connection.0;
 
+    if bulk {
+        try_!(check_bulk_options(autocommit, 1));
+    }
+
     let table = slice::from_raw_parts(table_buf, table_len);
     let table = str::from_utf8(table).unwrap();
 
     let schema = schema as *const FFI_ArrowSchema;
     let schema: Schema = try_!((&*schema).try_into());
 
-    let writer = try_!(OdbcWriter::from_connection(
-        connection, &schema, table, chunk_size
+    let policy = CommitPolicy::new(autocommit, commit_every);
+    let counters = Arc::new(ExecuteCounters::default());
+    let writer = try_!(CommittingWriter::new(
+        connection,
+        chunk_size,
+        policy,
+        counters.clone(),
+        |connection| table_writer(connection, &schema, table, chunk_size, bulk)
     ));
-    *writer_out = Box::into_raw(Box::new(ArrowOdbcWriter(writer)));
+    let writers = if pipelined {
+        Writers::Pipelined(PipelinedWriter::new(writer))
+    } else {
+        Writers::Sequential(writer)
+    };
+    *writer_out = Box::into_raw(Box::new(ArrowOdbcWriter::new(writers, counters)));
+
+    null_mut() // Ok(())
+}
+
+/// Creates an Arrow ODBC writer instance, which inserts into the table over several connections
+/// concurrently. Batches are distributed round-robin over the connections. Each connection has
+/// its own insert thread, so batches are inserted in a pipelined fashion. Errors are reported by a
+/// later call to write a batch or to flush.
+///
+/// Takes ownership of all connections even in case of an error.
+///
+/// # Safety
+///
+/// * `connections` must point to an array of `connections_len` valid OdbcConnections. This
+///   function takes ownership of all of them, even in case of an error. Yet it does not take
+///   ownership of the array itself.
+/// * `table_buf` must point to a valid utf-8 string
+/// * `table_len` describes the len of `table_buf` in bytes.
+/// * `schema` pointer to an arrow schema.
+/// * `autocommit`, `commit_every` and `bulk` are applied to each connection, like they are by
+///   [`arrow_odbc_writer_make`]. `bulk` can not be combined with more than one connection.
+/// * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
+///   is transferred to the caller.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_make_parallel(
+    connections: *const *mut OdbcConnection,
+    connections_len: usize,
+    table_buf: *const u8,
+    table_len: usize,
+    chunk_size: usize,
+    schema: *const c_void,
+    autocommit: bool,
+    commit_every: usize,
+    bulk: bool,
+    writer_out: *mut *mut ArrowOdbcWriter,
+) -> *mut ArrowOdbcError {
+    let connections: Vec<_> = slice::from_raw_parts(connections, connections_len)
+        .iter()
+        .map(|&connection| Box::from_raw(connection).0)
+        .collect();
+
+    if bulk {
+        try_!(check_bulk_options(autocommit, connections.len()));
+    }
+
+    let table = slice::from_raw_parts(table_buf, table_len);
+    let table = str::from_utf8(table).unwrap();
+
+    let schema = schema as *const FFI_ArrowSchema;
+    let schema: Schema = try_!((&*schema).try_into());
+
+    let policy = CommitPolicy::new(autocommit, commit_every);
+    let counters = Arc::new(ExecuteCounters::default());
+    let mut writers = Vec::with_capacity(connections.len());
+    for connection in connections {
+        writers.push(try_!(CommittingWriter::new(
+            connection,
+            chunk_size,
+            policy,
+            counters.clone(),
+            |connection| table_writer(connection, &schema, table, chunk_size, bulk)
+        )));
+    }
+    let writers = Writers::Parallel(ParallelWriter::new(writers));
+    *writer_out = Box::into_raw(Box::new(ArrowOdbcWriter::new(writers, counters)));
+
+    null_mut() // Ok(())
+}
+
+/// Creates an Arrow ODBC writer instance, which executes an arbitrary statement once for each row
+/// written to it. The columns of each batch are bound as arrays of parameters to the placeholders
+/// (`?`) of the statement, in order. So the statement is executed for up to `chunk_size` rows in a
+/// single round trip.
+///
+/// Takes ownership of connection even in case of an error.
+///
+/// # Safety
+///
+/// * `connection` must point to a valid OdbcConnection. This function takes ownership of the
+///   connection, even in case of an error. So The connection must not be freed explicitly
+///   afterwards.
+/// * `statement_buf` must point to a valid utf-8 string
+/// * `statement_len` describes the len of `statement_buf` in bytes.
+/// * `schema` pointer to an arrow schema. It must have one field for each placeholder.
+/// * `writer_out` in case of success this will point to an instance of `ArrowOdbcWriter`. Ownership
+///   is transferred to the caller.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_make_with_statement(
+    connection: NonNull<OdbcConnection>,
+    statement_buf: *const u8,
+    statement_len: usize,
+    chunk_size: usize,
+    schema: *const c_void,
+    writer_out: *mut *mut ArrowOdbcWriter,
+) -> *mut ArrowOdbcError {
+    let connection = *Box::from_raw(connection.as_ptr());
+    let connection = connection.0;
+
+    let statement = slice::from_raw_parts(statement_buf, statement_len);
+    let statement = str::from_utf8(statement).unwrap();
+
+    let schema = schema as *const FFI_ArrowSchema;
+    let schema: Schema = try_!((&*schema).try_into());
+
+    let counters = Arc::new(ExecuteCounters::default());
+    let writer = try_!(CommittingWriter::new(
+        connection,
+        chunk_size,
+        CommitPolicy::Autocommit,
+        counters.clone(),
+        |connection| {
+            let prepared = connection
+                .into_prepared(statement)
+                .map_err(|error| error.to_string())?;
+            OdbcWriter::new(chunk_size, &schema, prepared).map_err(|error| error.to_string())
+        }
+    ));
+    let writers = Writers::Sequential(writer);
+    *writer_out = Box::into_raw(Box::new(ArrowOdbcWriter::new(writers, counters)));
 
     null_mut() // Ok(())
 }
@@ -81,21 +346,102 @@ pub unsafe extern "C" fn arrow_odbc_writer_write_batch(
     array_ptr: *mut c_void,
     schema_ptr: *mut c_void,
 ) -> *mut ArrowOdbcError {
+    // Dereference writer
+    let writer = writer.as_mut();
+
     // Dereference batch
     let ffi_array_ptr = array_ptr as *mut FFI_ArrowArray;
     let ffi_schema_ptr = schema_ptr as *mut FFI_ArrowSchema;
-    let arrow_array = try_!(ArrowArray::try_from_raw(ffi_array_ptr, ffi_schema_ptr));
-    let array_data = try_!(arrow_array.to_data());
-    let struct_array = StructArray::from(array_data);
-    let record_batch = RecordBatch::from(&struct_array);
+    let record_batch = try_!(writer.import_batch(ffi_array_ptr, ffi_schema_ptr));
 
-    // Dereference writer
-    let writer = &mut writer.as_mut().0;
+    try_!(writer.write_batch(record_batch));
+    null_mut() // Ok(())
+}
 
-    try_!(writer.write_batch(&record_batch));
+/// Like [`arrow_odbc_writer_write_batch`], but returns immediately, if a pipelined writer is still
+/// busy with earlier batches. In that case `ready_out` is set to `FALSE` and the batch is handed
+/// over by a later call to [`arrow_odbc_writer_poll`]. Use [`arrow_odbc_writer_notify`] to learn
+/// when to call it. Other writers block, like [`arrow_odbc_writer_write_batch`].
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+/// * `batch` must be a valid pointer to an arrow batch
+/// * `ready_out` must be a valid pointer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_try_write_batch(
+    mut writer: NonNull<ArrowOdbcWriter>,
+    array_ptr: *mut c_void,
+    schema_ptr: *mut c_void,
+    ready_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    let writer = writer.as_mut();
+    let ffi_array_ptr = array_ptr as *mut FFI_ArrowArray;
+    let ffi_schema_ptr = schema_ptr as *mut FFI_ArrowSchema;
+    let record_batch = try_!(writer.import_batch(ffi_array_ptr, ffi_schema_ptr));
+    *ready_out = try_!(writer.try_write_batch(record_batch));
     null_mut() // Ok(())
 }
 
+/// Like [`arrow_odbc_writer_flush`], but returns immediately, if a pipelined writer is still
+/// inserting. In that case `ready_out` is set to `FALSE`, and the outcome is reported by a later
+/// call to [`arrow_odbc_writer_poll`].
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+/// * `ready_out` must be a valid pointer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_try_flush(
+    mut writer: NonNull<ArrowOdbcWriter>,
+    ready_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    *ready_out = try_!(writer.as_mut().try_flush());
+    null_mut() // Ok(())
+}
+
+/// Continues the operation started by [`arrow_odbc_writer_try_write_batch`] or
+/// [`arrow_odbc_writer_try_flush`], without blocking. `ready_out` is set to `TRUE` once it is
+/// complete. Errors of the operation are reported by this call.
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+/// * `ready_out` must be a valid pointer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_poll(
+    mut writer: NonNull<ArrowOdbcWriter>,
+    ready_out: *mut bool,
+) -> *mut ArrowOdbcError {
+    *ready_out = try_!(writer.as_mut().poll());
+    null_mut() // Ok(())
+}
+
+/// Makes a pipelined writer write to `socket` each time its insert thread is done with a batch or
+/// a flush, and once it stops. An event loop can wait for the socket to become readable, before
+/// calling [`arrow_odbc_writer_poll`] again. Notifications may be spurious.
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`] with
+///   `pipelined` set to `TRUE`.
+/// * `socket` must be the file descriptor (a `SOCKET` on windows) of a non-blocking stream socket,
+///   e.g. one end of a socket pair. It must stay open until the writer is freed, it is not closed
+///   by the writer.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_notify(
+    writer: NonNull<ArrowOdbcWriter>,
+    socket: u64,
+) -> *mut ArrowOdbcError {
+    match &writer.as_ref().writers {
+        Writers::Pipelined(pipelined) => {
+            pipelined.notification().set_socket(socket);
+            null_mut() // Ok(())
+        }
+        _ => ArrowOdbcError::new("Only pipelined writers can notify.").into_raw(),
+    }
+}
+
 /// # Safety
 ///
 /// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
@@ -104,8 +450,23 @@ pub unsafe extern "C" fn arrow_odbc_writer_flush(
     mut writer: NonNull<ArrowOdbcWriter>,
 ) -> *mut ArrowOdbcError {
     // Dereference writer
-    let writer = &mut writer.as_mut().0;
+    let writer = writer.as_mut();
 
     try_!(writer.flush());
     null_mut()
 }
+
+/// Cumulative counters of the writer, e.g. to tell time spent executing apart from time spent
+/// committing.
+///
+/// # Safety
+///
+/// * `writer` must be valid non-null writer, allocated by [`arrow_odbc_writer_make`].
+/// * `stats_out` must point to a valid `ArrowOdbcWriterStats`, which is overwritten.
+#[no_mangle]
+pub unsafe extern "C" fn arrow_odbc_writer_stats(
+    writer: NonNull<ArrowOdbcWriter>,
+    stats_out: *mut ArrowOdbcWriterStats,
+) {
+    *stats_out = writer.as_ref().stats();
+}
@@ -0,0 +1,296 @@
+use std::{mem::size_of, ptr::null_mut, slice};
+
+use arrow_odbc::{
+    arrow::{
+        array::{make_array, ArrayData, ArrayRef},
+        buffer::Buffer,
+        datatypes::{DataType, Schema, SchemaRef},
+        error::ArrowError,
+        record_batch::{RecordBatch, RecordBatchReader},
+    },
+    odbc_api::{
+        handles::{AsStatementRef, Statement},
+        sys::{
+            CDataType, Date, HStmt, Len, Pointer, SQLBindCol, SQLFetch, SqlReturn,
+            StatementAttribute, Timestamp, ULen,
+        },
+    },
+};
+
+use crate::{
+    handles::{set_statement_attribute, statement_error, unbind_columns},
+    kernels::{dates_to_days, timestamps_to_ticks},
+    pool::{BufferPool, PooledBuffer},
+    ramp_up::RampUp,
+};
+
+/// Fetches result sets consisting only of non nullable fixed width columns. In these cases the
+/// layout of the ODBC column buffers is identical to the values buffer of an Arrow array. So
+/// instead of fetching into one set of buffers and copying the values into Arrow arrays, a new set
+/// of Arrow buffers is bound to the cursor before each fetch and then handed over to the caller
+/// as part of the record batch. Dates and timestamps are the exception, they are converted from
+/// the structs ODBC uses by vectorized kernels. Buffers are acquired from a pool, so the memory of
+/// batches released by the consumer is reused.
+pub struct ZeroCopyReader<C>
+where
+    C: AsStatementRef,
+{
+    cursor: C,
+    schema: SchemaRef,
+    /// Number of rows of the next batch.
+    ramp_up: RampUp,
+    /// Value of `SQL_ATTR_ROW_ARRAY_SIZE`, i.e. the number of rows fetched at once.
+    row_array_size: usize,
+    /// Written to by the driver in every fetch. Boxed, so the address stays valid, even if the
+    /// reader is moved.
+    num_rows_fetched: Box<ULen>,
+    pool: BufferPool,
+    /// `true` if failing to allocate the buffers of a batch should result in an error, rather than
+    /// aborting the process.
+    fallibale_allocations: bool,
+    /// Set once the driver reported the end of the result set, so it is not asked to fetch again.
+    exhausted: bool,
+}
+
+/// `true` if every column of the schema can be fetched without copying the values.
+pub fn supports_zero_copy(schema: &Schema) -> bool {
+    schema
+        .fields()
+        .iter()
+        .all(|field| !field.is_nullable() && c_data_type(field.data_type()).is_some())
+}
+
+impl<C> ZeroCopyReader<C>
+where
+    C: AsStatementRef,
+{
+    /// Prepares the cursor for fetching blocks of `batch_size` rows. [`supports_zero_copy`] must
+    /// be `true` for the schema.
+    pub fn new(
+        mut cursor: C,
+        schema: SchemaRef,
+        batch_size: usize,
+        pool: BufferPool,
+        fallibale_allocations: bool,
+    ) -> Result<Self, String> {
+        let mut num_rows_fetched = Box::new(0);
+        let hstmt = cursor.as_stmt_ref().as_sys();
+        unsafe {
+            // 0 is SQL_BIND_BY_COLUMN
+            set_statement_attribute(hstmt, StatementAttribute::RowBindType, 0 as Pointer)?;
+            set_statement_attribute(
+                hstmt,
+                StatementAttribute::RowArraySize,
+                batch_size as Pointer,
+            )?;
+            set_statement_attribute(
+                hstmt,
+                StatementAttribute::RowsFetchedPtr,
+                num_rows_fetched.as_mut() as *mut ULen as Pointer,
+            )?;
+        }
+        Ok(Self {
+            cursor,
+            schema,
+            ramp_up: RampUp::fixed(batch_size),
+            row_array_size: batch_size,
+            num_rows_fetched,
+            pool,
+            fallibale_allocations,
+            exhausted: false,
+        })
+    }
+
+    /// Starts out with smaller batches, growing up to the batch size. The buffers of each batch
+    /// are acquired for its own size, so small result sets never allocate full batches.
+    pub fn with_ramp_up(mut self, ramp_up: RampUp) -> Self {
+        self.ramp_up = ramp_up;
+        self
+    }
+
+    fn fetch(&mut self, hstmt: HStmt) -> Result<Option<RecordBatch>, ArrowError> {
+        let capacity = self.ramp_up.next_size();
+        if capacity != self.row_array_size {
+            unsafe {
+                set_statement_attribute(
+                    hstmt,
+                    StatementAttribute::RowArraySize,
+                    capacity as Pointer,
+                )
+            }
+            .map_err(external)?;
+            self.row_array_size = capacity;
+        }
+        // Bind a fresh set of buffers. The ones bound for the previous fetch are owned by the
+        // arrays of the previous batch by now.
+        let mut buffers = Vec::with_capacity(self.schema.fields().len());
+        for (index, field) in self.schema.fields().iter().enumerate() {
+            let (c_type, width) = c_data_type(field.data_type()).unwrap();
+            let mut buffer = acquire(&self.pool, capacity * width, self.fallibale_allocations)?;
+            let ret = unsafe {
+                SQLBindCol(
+                    hstmt,
+                    (index + 1).try_into().unwrap(),
+                    c_type,
+                    buffer.as_mut_ptr() as Pointer,
+                    width as Len,
+                    // We only fetch non nullable columns, so we do not need an indicator.
+                    null_mut(),
+                )
+            };
+            if !matches!(ret, SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO) {
+                return Err(external(unsafe { statement_error(hstmt, "SQLBindCol") }));
+            }
+            buffers.push(buffer);
+        }
+
+        let ret = unsafe { SQLFetch(hstmt) };
+        // Make sure the driver never writes into buffers we handed over to the caller.
+        unsafe { unbind_columns(hstmt) };
+        match ret {
+            SqlReturn::NO_DATA => {
+                self.exhausted = true;
+                return Ok(None);
+            }
+            SqlReturn::SUCCESS | SqlReturn::SUCCESS_WITH_INFO => (),
+            _ => return Err(external(unsafe { statement_error(hstmt, "SQLFetch") })),
+        }
+
+        let num_rows = *self.num_rows_fetched;
+        let columns = buffers
+            .into_iter()
+            .zip(self.schema.fields())
+            .map(|(buffer, field)| {
+                // Values have been written by the driver.
+                let buffer = convert(
+                    buffer,
+                    field.data_type(),
+                    num_rows,
+                    &self.pool,
+                    self.fallibale_allocations,
+                )?;
+                let data = ArrayData::builder(field.data_type().clone())
+                    .len(num_rows)
+                    .add_buffer(buffer)
+                    .build()?;
+                Ok(make_array(data))
+            })
+            .collect::<Result<Vec<ArrayRef>, ArrowError>>()?;
+        RecordBatch::try_new(self.schema.clone(), columns).map(Some)
+    }
+}
+
+impl<C> Drop for ZeroCopyReader<C>
+where
+    C: AsStatementRef,
+{
+    fn drop(&mut self) {
+        // The statement may outlive this reader. It must neither point to `num_rows_fetched`, nor
+        // fetch blocks of rows, once we are gone.
+        let hstmt = self.cursor.as_stmt_ref().as_sys();
+        unsafe {
+            let _ = set_statement_attribute(hstmt, StatementAttribute::RowsFetchedPtr, null_mut());
+            let _ = set_statement_attribute(hstmt, StatementAttribute::RowArraySize, 1 as Pointer);
+        }
+    }
+}
+
+impl<C> Iterator for ZeroCopyReader<C>
+where
+    C: AsStatementRef,
+{
+    type Item = Result<RecordBatch, ArrowError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.exhausted {
+            return None;
+        }
+        let hstmt = self.cursor.as_stmt_ref().as_sys();
+        self.fetch(hstmt).transpose()
+    }
+}
+
+impl<C> RecordBatchReader for ZeroCopyReader<C>
+where
+    C: AsStatementRef,
+{
+    fn schema(&self) -> SchemaRef {
+        self.schema.clone()
+    }
+}
+
+/// ODBC C data type and size in bytes of a value, if the Arrow type shares its layout with it or
+/// can be converted by one of our kernels.
+fn c_data_type(data_type: &DataType) -> Option<(CDataType, usize)> {
+    let c_data_type = match data_type {
+        DataType::Int8 => (CDataType::STinyInt, size_of::<i8>()),
+        DataType::Int16 => (CDataType::SShort, size_of::<i16>()),
+        DataType::Int32 => (CDataType::SLong, size_of::<i32>()),
+        DataType::Int64 => (CDataType::SBigInt, size_of::<i64>()),
+        DataType::Float32 => (CDataType::Float, size_of::<f32>()),
+        DataType::Float64 => (CDataType::Double, size_of::<f64>()),
+        // Dates and timestamps are represented as structs by ODBC, so they need to be converted.
+        DataType::Date32 => (CDataType::TypeDate, size_of::<Date>()),
+        DataType::Timestamp(_, None) => (CDataType::TypeTimestamp, size_of::<Timestamp>()),
+        _ => return None,
+    };
+    Some(c_data_type)
+}
+
+/// Converts the values fetched by the driver into the layout of the Arrow array, unless they
+/// share it already. Converted buffers return to the pool, ready to be bound for the next fetch.
+fn convert(
+    fetched: PooledBuffer,
+    data_type: &DataType,
+    num_rows: usize,
+    pool: &BufferPool,
+    fallibale_allocations: bool,
+) -> Result<Buffer, ArrowError> {
+    let buffer = match data_type {
+        DataType::Date32 => {
+            // Safety: The driver wrote `num_rows` dates into the buffer.
+            let dates = unsafe { slice::from_raw_parts(fetched.as_ptr() as *const Date, num_rows) };
+            let mut days = acquire(pool, num_rows * size_of::<i32>(), fallibale_allocations)?;
+            dates_to_days(dates, days.typed_data_mut(num_rows));
+            // Safety: The kernel wrote `num_rows` days.
+            unsafe { days.into_buffer(num_rows * size_of::<i32>()) }
+        }
+        DataType::Timestamp(unit, None) => {
+            // Safety: The driver wrote `num_rows` timestamps into the buffer.
+            let timestamps =
+                unsafe { slice::from_raw_parts(fetched.as_ptr() as *const Timestamp, num_rows) };
+            let mut ticks = acquire(pool, num_rows * size_of::<i64>(), fallibale_allocations)?;
+            timestamps_to_ticks(timestamps, unit, ticks.typed_data_mut(num_rows));
+            // Safety: The kernel wrote `num_rows` ticks.
+            unsafe { ticks.into_buffer(num_rows * size_of::<i64>()) }
+        }
+        _ => {
+            let (_c_type, width) = c_data_type(data_type).unwrap();
+            // Safety: The driver wrote `num_rows` values.
+            unsafe { fetched.into_buffer(num_rows * width) }
+        }
+    };
+    Ok(buffer)
+}
+
+/// Acquires a buffer from the pool. If `fallibale_allocations` is `true` running out of memory is
+/// reported as an error, otherwise the process is aborted.
+fn acquire(
+    pool: &BufferPool,
+    capacity: usize,
+    fallibale_allocations: bool,
+) -> Result<PooledBuffer, ArrowError> {
+    if !fallibale_allocations {
+        return Ok(pool.acquire(capacity));
+    }
+    pool.try_acquire(capacity).ok_or_else(|| {
+        external(format!(
+            "Failed to allocate {capacity} bytes for the values of a column. Try a smaller batch \
+            size."
+        ))
+    })
+}
+
+fn external(message: String) -> ArrowError {
+    ArrowError::ExternalError(message.into())
+}
@@ -1,14 +1,38 @@
+import asyncio
 import os
+import sys
+
+from concurrent.futures import ThreadPoolExecutor
+from datetime import date, datetime, timezone
 
 import pyarrow as pa
 import pyarrow.csv as csv
+import pyarrow.feather as feather
+import pyarrow.ipc as ipc
+import pyarrow.parquet as pq
 
 from subprocess import run, check_output
 
 from pytest import raises
 
-from arrow_odbc import read_arrow_batches_from_odbc, Error
-from arrow_odbc.writer import insert_into_table
+from arrow_odbc import (
+    read_arrow_batches_from_odbc,
+    read_arrow_batches_from_odbc_partitioned,
+    range_partitions,
+    prepare,
+    Error,
+)
+from arrow_odbc.cache import clear_result_cache
+from arrow_odbc.incremental import read_arrow_batches_incremental
+from arrow_odbc.sink import odbc_to_arrow_ipc, odbc_to_parquet
+from arrow_odbc.transfer import copy_table
+from arrow_odbc.writer import (
+    insert_into_table,
+    insert_into_table_async,
+    execute_with_arrow_parameters,
+    parquet_to_odbc,
+    arrow_ipc_to_odbc,
+)
 
 MSSQL = "Driver={ODBC Driver 17 for SQL Server};Server=localhost;UID=SA;PWD=My@Test@Password1;"
 
@@ -418,55 +442,1354 @@ def test_support_varbinary_max():
         next(it)
 
 
-def test_insert_should_raise_on_invalid_connection_string():
+def test_fetch_concurrently():
     """
-    Insert should raise on invalid connection string
+    Fetching batches on a dedicated system thread must yield the same batches as fetching them
+    sequentially.
     """
     # Given
-    invalid_connection_string = "FOO"
-    schema = pa.schema([("a", pa.int64())])
+    table = "FetchConcurrently"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int);"')
+    rows = "a\n1\n2\n3\n4\n5"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
 
-    def iter_record_batches():
-        for i in range(2):
-            yield pa.RecordBatch.from_arrays([pa.array([1, 2, 3])], schema=schema)
+    query = f"SELECT * FROM {table}"
 
-    reader = pa.RecordBatchReader.from_batches(schema, iter_record_batches())
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query, batch_size=2, connection_string=MSSQL, fetch_concurrently=True
+    )
+    actual = [batch.to_pydict() for batch in reader]
 
-    # When / Then
-    with raises(Error, match="Data source name not found"):
-        insert_into_table(
-            connection_string=invalid_connection_string,
-            chunk_size=20,
-            table="MyTable",
-            reader=reader,
+    # Then
+    expected = [{"a": [1, 2]}, {"a": [3, 4]}, {"a": [5]}]
+    assert expected == actual
+
+
+def test_prefetch_depth():
+    """
+    Fetching with a prefetch depth larger than one must yield all the batches in order.
+    """
+    # Given
+    table = "PrefetchDepth"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int);"')
+    rows = "a\n1\n2\n3\n4\n5"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    query = f"SELECT * FROM {table}"
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query,
+        batch_size=1,
+        connection_string=MSSQL,
+        fetch_concurrently=True,
+        prefetch_depth=3,
+    )
+    actual = [batch.to_pydict() for batch in reader]
+
+    # Then
+    expected = [{"a": [1]}, {"a": [2]}, {"a": [3]}, {"a": [4]}, {"a": [5]}]
+    assert expected == actual
+
+
+def test_max_bytes_per_batch():
+    """
+    The number of rows per batch should be reduced, so the buffers fit into the memory limit.
+    """
+    # Given
+    table = "MaxBytesPerBatch"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a VARCHAR(4000));"')
+
+    query = f"SELECT * FROM {table}"
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query,
+        batch_size=100000,
+        connection_string=MSSQL,
+        max_bytes_per_batch=2**20,
+    )
+
+    # Then
+    assert 0 < reader.batch_size < 100000
+
+
+def test_max_bytes_per_batch_too_small_for_a_single_row():
+    """
+    Raise an error, if not even a single row fits within the memory limit.
+    """
+    query = "SELECT CAST('a' AS VARCHAR(4000)) as a"
+
+    with raises(Error, match="A single row requires"):
+        read_arrow_batches_from_odbc(
+            query=query, batch_size=100, connection_string=MSSQL, max_bytes_per_batch=10
         )
 
 
-def test_insert_batches():
+def test_zero_copy():
     """
-    Insert data into database
+    Non nullable fixed width columns fetched without copying must yield the same values.
     """
     # Given
-    table = "InsertBatches"
+    table = "ZeroCopy"
     os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
     os.system(
-        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int IDENTITY(1,1), a BIGINT)"'
+        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a INT NOT NULL, b FLOAT NOT NULL);"'
     )
-    schema = pa.schema([("a", pa.int64())])
+    rows = "a,b\n1,0.5\n2,1.5\n3,2.5"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
 
-    def iter_record_batches():
-        for i in range(2):
-            yield pa.RecordBatch.from_arrays([pa.array([1, 2, 3])], schema=schema)
+    query = f"SELECT a, b FROM {table} ORDER BY a"
 
-    reader = pa.RecordBatchReader.from_batches(schema, iter_record_batches())
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query, batch_size=2, connection_string=MSSQL, zero_copy=True
+    )
+    actual = [batch.to_pydict() for batch in reader]
+
+    # Then
+    expected = [{"a": [1, 2], "b": [0.5, 1.5]}, {"a": [3], "b": [2.5]}]
+    assert expected == actual
+
+
+def test_zero_copy_timestamps():
+    """
+    Non nullable dates and timestamps are converted by our own kernels.
+    """
+    # Given
+    table = "ZeroCopyTimestamps"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(
+        f'odbcsv fetch -c "{MSSQL}" -q '
+        f'"CREATE TABLE {table} (a DATE NOT NULL, b DATETIME2(3) NOT NULL);"'
+    )
+    rows = "a,b\n1969-12-31,1900-02-28 23:59:59.999\n2024-02-29,2038-01-19 03:14:08.001"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
 
     # When
-    insert_into_table(
-        connection_string=MSSQL, chunk_size=20, table=table, reader=reader
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a, b FROM {table} ORDER BY a",
+        batch_size=10,
+        connection_string=MSSQL,
+        zero_copy=True,
     )
+    actual = next(iter(reader)).to_pydict()
 
     # Then
-    actual = check_output(
-        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY id"]
+    assert [date(1969, 12, 31), date(2024, 2, 29)] == actual["a"]
+    assert [
+        datetime(1900, 2, 28, 23, 59, 59, 999000),
+        datetime(2038, 1, 19, 3, 14, 8, 1000),
+    ] == actual["b"]
+
+
+def test_zero_copy_buffer_pool():
+    """
+    Buffers of released batches are reused for later batches.
+    """
+    # Given
+    table = "ZeroCopyBufferPool"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT NOT NULL);"')
+    rows = "a\n1\n2\n3\n4\n5\n6"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a FROM {table} ORDER BY a",
+        batch_size=2,
+        connection_string=MSSQL,
+        zero_copy=True,
+        buffer_pool_size=1024,
     )
-    assert "a\n1\n2\n3\n1\n2\n3\n" == actual.decode("utf8")
+    actual = [batch.to_pydict()["a"] for batch in reader]
+
+    # Then
+    assert [[1, 2], [3, 4], [5, 6]] == actual
+    stats = reader.stats
+    assert stats["pool_reuses"] > 0
+    assert stats["pool_bytes"] > 0
+
+
+def test_more_results():
+    """
+    Fetch several result sets with different schemas from one batch of statements.
+    """
+    # Given
+    query = "SELECT 1 AS a UNION ALL SELECT 2; SELECT 'x' AS b"
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query, batch_size=10, connection_string=MSSQL, more_results=True
+    )
+    first = [batch.to_pydict() for batch in reader]
+    has_second = reader.next_result_set()
+    second = [batch.to_pydict() for batch in reader]
+    has_third = reader.next_result_set()
+
+    # Then
+    assert [{"a": [1, 2]}] == first
+    assert has_second
+    assert reader.schema.names == ["b"]
+    assert [{"b": ["x"]}] == second
+    assert not has_third
+
+
+def test_more_results_can_not_be_combined_with_fetch_concurrently():
+    """
+    Fetching several result sets is incompatible with a dedicated fetch thread.
+    """
+    with raises(ValueError, match="more_results can not be combined with fetch_concurrently."):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1 AS a",
+            batch_size=10,
+            connection_string=MSSQL,
+            more_results=True,
+            fetch_concurrently=True,
+        )
+
+
+def test_more_results_can_not_be_combined_with_max_text_size():
+    """
+    Values of several result sets are fetched without binding buffers, so there is nothing
+    ``max_text_size`` could limit.
+    """
+    with raises(ValueError, match="more_results can not be combined with max_text_size."):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1 AS a",
+            batch_size=10,
+            connection_string=MSSQL,
+            more_results=True,
+            max_text_size=1024,
+        )
+
+
+def test_statement_attributes():
+    """
+    Statement and connection attributes are applied before the query is executed.
+    """
+    # Given
+    table = "StatementAttributes"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int);"')
+    rows = "a\n1\n2\n3"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a FROM {table} ORDER BY a",
+        batch_size=10,
+        connection_string=MSSQL,
+        statement_attributes={"max_rows": 2},
+        connection_attributes={"connection_timeout": 10},
+    )
+    actual = [batch.to_pydict() for batch in reader]
+
+    # Then
+    assert [{"a": [1, 2]}] == actual
+
+
+def test_statement_attributes_can_not_be_combined_with_initial_batch_size():
+    """
+    Batches growing up to the batch size are not fetched from statements with attributes, so the
+    combination is rejected rather than silently ignoring ``initial_batch_size``.
+    """
+    with raises(
+        ValueError, match="statement_attributes can not be combined with initial_batch_size."
+    ):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1 AS a",
+            batch_size=10,
+            connection_string=MSSQL,
+            statement_attributes={"max_rows": 2},
+            initial_batch_size=1,
+        )
+
+
+def test_unknown_statement_attribute():
+    """
+    Unknown attribute names are reported, before connecting to the data source.
+    """
+    with raises(ValueError, match="Unknown attribute: prefetch"):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1 AS a",
+            batch_size=10,
+            connection_string=MSSQL,
+            statement_attributes={"prefetch": 100},
+        )
+
+
+def test_initial_batch_size():
+    """
+    Batches ramp up from the initial batch size to the batch size, doubling each time.
+    """
+    # Given
+    table = "InitialBatchSize"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int, b VARCHAR(10));"')
+    rows = "a,b\n" + "\n".join(f"{i},v{i}" for i in range(1, 11))
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a, b FROM {table} ORDER BY a",
+        batch_size=4,
+        connection_string=MSSQL,
+        initial_batch_size=1,
+    )
+    batches = list(reader)
+
+    # Then
+    assert [1, 2, 4, 3] == [batch.num_rows for batch in batches]
+    assert list(range(1, 11)) == [a for batch in batches for a in batch.to_pydict()["a"]]
+    assert reader.schema == batches[-1].schema
+
+
+def test_initial_batch_size_can_not_be_combined_with_initial_text_size():
+    """
+    Buffers sized from the first batch require it to have the full batch size.
+    """
+    with raises(
+        ValueError, match="initial_batch_size can not be combined with initial_text_size."
+    ):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1 AS a",
+            batch_size=10,
+            connection_string=MSSQL,
+            initial_text_size=8,
+            initial_batch_size=1,
+        )
+
+
+def test_read_incremental():
+    """
+    Only rows with a watermark larger than the last one are read, and the new watermark is
+    reported by the reader.
+    """
+    # Given
+    table = "ReadIncremental"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int, version int);"')
+    rows = "id,version\n1,10\n2,20\n3,30\n4,40"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_incremental(
+        table=table,
+        watermark_column="version",
+        last_watermark=20,
+        batch_size=1,
+        connection_string=MSSQL,
+    )
+    ids = sorted(id for batch in reader for id in batch.to_pydict()["id"])
+
+    # Then
+    assert [3, 4] == ids
+    assert 40 == reader.watermark
+
+
+def test_read_incremental_without_new_rows():
+    """
+    Without any new rows the last watermark is kept.
+    """
+    # Given
+    table = "ReadIncrementalWithoutNewRows"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int, version int);"')
+    rows = "id,version\n1,10"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_incremental(
+        table=table,
+        watermark_column="version",
+        last_watermark=10,
+        batch_size=10,
+        connection_string=MSSQL,
+    )
+    batches = list(reader)
+
+    # Then
+    assert 0 == sum(batch.num_rows for batch in batches)
+    assert 10 == reader.watermark
+
+
+def test_read_incremental_timestamp_nanoseconds():
+    """
+    Timestamp watermarks keep their nanoseconds, so rows differing by less than a microsecond are
+    not read again.
+    """
+    # Given
+    table = "ReadIncrementalTimestampNanoseconds"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(
+        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int, updated DATETIME2(7));"'
+    )
+    rows = "id,updated\n1,2022-01-01 00:00:00.0000001\n2,2022-01-01 00:00:00.0000002"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    def read(last_watermark):
+        reader = read_arrow_batches_incremental(
+            table=table,
+            watermark_column="updated",
+            last_watermark=last_watermark,
+            batch_size=10,
+            connection_string=MSSQL,
+        )
+        ids = sorted(id for batch in reader for id in batch.to_pydict()["id"])
+        return (ids, reader.watermark)
+
+    # When
+    (first_ids, first_watermark) = read(None)
+    rows = "id,updated\n3,2022-01-01 00:00:00.0000003"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    (second_ids, second_watermark) = read(first_watermark)
+
+    # Then
+    assert [1, 2] == first_ids
+    assert 200 == first_watermark.value % 1000
+    assert [3] == second_ids
+    assert 300 == second_watermark.value % 1000
+
+
+def test_read_incremental_partitioned():
+    """
+    The delta is read over several connections, tracking the watermark across all partitions.
+    """
+    # Given
+    table = "ReadIncrementalPartitioned"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int, version int);"')
+    rows = "id,version\n1,10\n2,20\n3,30\n4,40\n5,50\n6,60"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_incremental(
+        table=table,
+        watermark_column="version",
+        last_watermark=20,
+        batch_size=10,
+        connection_string=MSSQL,
+        partition_column="id",
+        partition_range=(1, 7),
+        num_partitions=3,
+        parallelism=2,
+    )
+    ids = sorted(id for batch in reader for id in batch.to_pydict()["id"])
+
+    # Then
+    assert [3, 4, 5, 6] == ids
+    assert 60 == reader.watermark
+
+
+def test_cache_result():
+    """
+    A query executed again with the same parameters within the time to live is answered from the
+    cache, without querying the data source. Other parameters query the data source.
+    """
+    # Given
+    table = "CacheResult"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int);"')
+    run(["odbcsv", "insert", "-c", MSSQL, table], input="a\n1\n2", encoding="ascii")
+    clear_result_cache()
+    query = f"SELECT a FROM {table} WHERE a > ? ORDER BY a"
+
+    def read(parameter):
+        reader = read_arrow_batches_from_odbc(
+            query=query,
+            batch_size=10,
+            connection_string=MSSQL,
+            parameters=[parameter],
+            cache_ttl=60,
+        )
+        return [a for batch in reader for a in batch.to_pydict()["a"]]
+
+    read(0)
+    run(["odbcsv", "insert", "-c", MSSQL, table], input="a\n3", encoding="ascii")
+
+    # When
+    cached = read(0)
+    queried = read(1)
+
+    # Then
+    assert [1, 2] == cached
+    assert [2, 3] == queried
+
+
+def test_cache_ttl_can_not_be_combined_with_more_results():
+    """
+    Multiple result sets are not cached.
+    """
+    with raises(ValueError, match="cache_ttl can not be combined with more_results"):
+        read_arrow_batches_from_odbc(
+            query="SELECT 1",
+            batch_size=10,
+            connection_string=MSSQL,
+            more_results=True,
+            cache_ttl=60,
+        )
+
+
+def test_partitioned_read():
+    """
+    Read partitions of a table concurrently over multiple connections.
+    """
+    # Given
+    table = "PartitionedRead"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a int);"')
+    rows = "a\n1\n2\n3\n4\n5\n6"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    query = f"SELECT a FROM {table} WHERE a >= ? AND a < ? ORDER BY a"
+
+    # When
+    reader = read_arrow_batches_from_odbc_partitioned(
+        query=query,
+        batch_size=10,
+        connection_string=MSSQL,
+        partitions=range_partitions(1, 7, 3),
+        parallelism=2,
+    )
+    actual = [batch.to_pydict() for batch in reader]
+
+    # Then
+    expected = [{"a": [1, 2]}, {"a": [3, 4]}, {"a": [5, 6]}]
+    assert expected == actual
+
+
+def test_connection_pooling():
+    """
+    Queries should succeed with connection pooling enabled. Pooling must be enabled before the
+    first connection is opened, so we need a fresh interpreter for this.
+    """
+    script = f"""
+from arrow_odbc import enable_odbc_connection_pooling, read_arrow_batches_from_odbc
+enable_odbc_connection_pooling()
+for _ in range(3):
+    reader = read_arrow_batches_from_odbc(
+        query="SELECT 42 as a", batch_size=1, connection_string="{MSSQL}"
+    )
+    assert next(iter(reader)).to_pydict() == {{"a": [42]}}
+    del reader
+"""
+    run([sys.executable, "-c", script], check=True)
+
+
+def test_enable_connection_pooling_after_connecting_raises():
+    """
+    Enabling connection pooling after a connection has been opened has no effect. So we want to
+    let the user know.
+    """
+    from arrow_odbc import enable_odbc_connection_pooling
+
+    read_arrow_batches_from_odbc(query="SELECT 42 as a", batch_size=1, connection_string=MSSQL)
+
+    with raises(Error, match="before the first connection"):
+        enable_odbc_connection_pooling()
+
+
+def test_prepared_query():
+    """
+    Execute a prepared query repeatedly with different parameters.
+    """
+    # Given
+    table = "PreparedQuery"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(
+        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a CHAR(1), b INTEGER);"'
+    )
+    rows = "a,b\nA,1\nB,2\nC,3\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    prepared = prepare(
+        query=f"SELECT b FROM {table} WHERE a=?", batch_size=10, connection_string=MSSQL
+    )
+
+    # When
+    actual = []
+    for key in ["C", "A", "B"]:
+        reader = prepared.execute(parameters=[key])
+        actual.append(next(iter(reader)).to_pydict())
+
+    # Then
+    assert [{"b": [3]}, {"b": [1]}, {"b": [2]}] == actual
+
+
+def test_prepared_query_invalidates_previous_reader():
+    """
+    Executing a prepared query again, closes the result set of the previous reader. So it must not
+    yield batches anymore.
+    """
+    # Given
+    prepared = prepare(query="SELECT ? as a", batch_size=1, connection_string=MSSQL)
+    first = prepared.execute(parameters=["1"])
+
+    # When
+    second = prepared.execute(parameters=["2"])
+
+    # Then
+    with raises(Error, match="executed again"):
+        next(iter(first))
+    assert {"a": ["2"]} == next(iter(second)).to_pydict()
+
+
+def test_typed_parameters():
+    """
+    Integers, floats, timestamps and binary values are bound as parameters of the matching type.
+    """
+    # Given
+    query = (
+        "SELECT CAST(? AS BIGINT) + 1 as a, CAST(? AS FLOAT) * 2 as b, "
+        "DATEADD(day, 1, CAST(? AS DATETIME2)) as c, DATALENGTH(?) as d"
+    )
+    parameters = [41, 1.5, datetime(2022, 8, 1, 12, 30, 15), b"\x01\x02\x03"]
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=query, batch_size=1, connection_string=MSSQL, parameters=parameters
+    )
+    actual = next(iter(reader)).to_pydict()
+
+    # Then
+    assert [42] == actual["a"]
+    assert [3.0] == actual["b"]
+    assert [datetime(2022, 8, 2, 12, 30, 15)] == actual["c"]
+    assert [3] == actual["d"]
+
+
+def test_query_with_non_ascii_parameter():
+    """
+    The length of text parameters must be given in bytes, not characters.
+    """
+    reader = read_arrow_batches_from_odbc(
+        query="SELECT ? as a", batch_size=1, connection_string=MSSQL, parameters=["Ü"]
+    )
+    assert {"a": ["Ü"]} == next(iter(reader)).to_pydict()
+
+
+def test_unsupported_parameter_type():
+    with raises(TypeError, match="Unsupported parameter type"):
+        read_arrow_batches_from_odbc(
+            query="SELECT ?", batch_size=1, connection_string=MSSQL, parameters=[[1, 2]]
+        )
+
+
+def test_integer_parameter_out_of_range():
+    with raises(ValueError, match="exceeds the range of BIGINT"):
+        read_arrow_batches_from_odbc(
+            query="SELECT ?", batch_size=1, connection_string=MSSQL, parameters=[2**63]
+        )
+
+
+def test_timezone_aware_parameter():
+    with raises(ValueError, match="Timezone aware"):
+        read_arrow_batches_from_odbc(
+            query="SELECT ?",
+            batch_size=1,
+            connection_string=MSSQL,
+            parameters=[datetime(2021, 1, 1, tzinfo=timezone.utc)],
+        )
+
+
+def test_readers_in_threads():
+    """
+    Independent readers can be consumed by different threads at the same time.
+    """
+    # Given
+    def read(value):
+        reader = read_arrow_batches_from_odbc(
+            query="SELECT ? as a", batch_size=1, connection_string=MSSQL, parameters=[value]
+        )
+        return [batch.to_pydict() for batch in reader]
+
+    # When
+    with ThreadPoolExecutor(max_workers=4) as executor:
+        actual = list(executor.map(read, range(8)))
+
+    # Then
+    assert [[{"a": [i]}] for i in range(8)] == actual
+
+
+def test_initial_text_size():
+    """
+    Text buffers grow, until the values of the first batch fit.
+    """
+    # Given
+    table = "InitialTextSize"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a VARCHAR(MAX));"')
+    long_value = "x" * 100
+    rows = f"a\nshort\n{long_value}\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a FROM {table} ORDER BY a DESC",
+        batch_size=10,
+        connection_string=MSSQL,
+        initial_text_size=8,
+    )
+
+    # Then
+    assert {"a": ["short", long_value]} == next(iter(reader)).to_pydict()
+
+
+def test_lob_threshold():
+    """
+    Large columns are retrieved in full, without being truncated.
+    """
+    # Given
+    table = "LobThreshold"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a INTEGER, b VARCHAR(MAX));"')
+    long_value = "x" * 10000
+    rows = f"a,b\n1,{long_value}\n2,\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a, b FROM {table} ORDER BY a",
+        batch_size=10,
+        connection_string=MSSQL,
+        max_text_size=100,
+        lob_threshold=1000,
+    )
+
+    # Then
+    assert pa.large_string() == reader.schema.field("b").type
+    assert {"a": [1, 2], "b": [long_value, None]} == next(iter(reader)).to_pydict()
+
+
+def test_lob_threshold_rejects_decimals():
+    """
+    Decimals can not be retrieved alongside large columns. Rather than silently returning them as
+    text, an error points to passing a schema.
+    """
+    query = "SELECT CAST(1.5 AS DECIMAL(5,2)) AS a, CAST('x' AS VARCHAR(MAX)) AS b"
+    with raises(Error, match="Column 'a' is of type"):
+        read_arrow_batches_from_odbc(
+            query=query, batch_size=10, connection_string=MSSQL, lob_threshold=1000
+        )
+
+
+def test_dictionary_columns():
+    """
+    Text columns are dictionary encoded, with keys stable across batches.
+    """
+    # Given
+    table = "DictionaryColumns"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id INTEGER, a VARCHAR(10));"')
+    rows = "id,a\n1,DE\n2,FR\n3,DE\n4,\n5,US\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT id, a FROM {table} ORDER BY id",
+        batch_size=2,
+        connection_string=MSSQL,
+        dictionary_columns=["a"],
+    )
+    batches = list(reader)
+
+    # Then
+    assert pa.dictionary(pa.int32(), pa.string()) == reader.schema.field("a").type
+    columns = [batch.column(1) for batch in batches]
+    assert [0, 1, 0, None, 2] == [key for c in columns for key in c.indices.to_pylist()]
+    assert ["DE", "FR", "US"] == columns[-1].dictionary.to_pylist()
+
+
+def test_dictionary_column_must_be_text():
+    with raises(Error, match="Only text columns"):
+        read_arrow_batches_from_odbc(
+            query="SELECT 42 AS a",
+            batch_size=1,
+            connection_string=MSSQL,
+            dictionary_columns=["a"],
+        )
+
+
+def test_dictionary_column_with_too_many_distinct_values():
+    query = (
+        "SELECT TOP 65537 CAST(ROW_NUMBER() OVER (ORDER BY (SELECT NULL)) AS VARCHAR(10)) AS a "
+        "FROM sys.all_objects AS x CROSS JOIN sys.all_objects AS y"
+    )
+    reader = read_arrow_batches_from_odbc(
+        query=query, batch_size=100000, connection_string=MSSQL, dictionary_columns=["a"]
+    )
+    with raises(Error, match="exceeds 65536 distinct values"):
+        next(iter(reader))
+
+
+def test_schema_override():
+    """
+    Fetch a decimal as 64 bit integer and a timestamp with millisecond precision.
+    """
+    # Given
+    schema = pa.schema([("a", pa.int64()), ("b", pa.timestamp("ms"))])
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=(
+            "SELECT CAST(42 AS DECIMAL(38,0)) AS a, "
+            "CAST('2022-08-02 12:30:15.123' AS DATETIME2) AS b"
+        ),
+        batch_size=1,
+        connection_string=MSSQL,
+        schema=schema,
+    )
+
+    # Then
+    assert schema == reader.schema
+    batch = next(iter(reader))
+    assert [42] == batch.column(0).to_pylist()
+    assert [datetime(2022, 8, 2, 12, 30, 15, 123000)] == batch.column(1).to_pylist()
+
+
+def test_schema_override_must_match_columns():
+    with raises(Error, match="2 fields"):
+        read_arrow_batches_from_odbc(
+            query="SELECT 42 AS a",
+            batch_size=1,
+            connection_string=MSSQL,
+            schema=pa.schema([("a", pa.int64()), ("b", pa.int64())]),
+        )
+
+
+def test_reader_stats():
+    """
+    Counters of the reader are reported after each batch.
+    """
+    # Given
+    table = "ReaderStats"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a INTEGER);"')
+    rows = "a\n1\n2\n3\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    reported = []
+
+    # When
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a FROM {table}",
+        batch_size=2,
+        connection_string=MSSQL,
+        stats_callback=reported.append,
+    )
+    list(reader)
+
+    # Then
+    assert [2, 3] == [stats["rows"] for stats in reported]
+    stats = reader.stats
+    assert 2 == stats["batches"]
+    assert stats["buffer_bytes"] > 0
+    assert stats["fetch_ns"] > 0
+
+
+def test_async_iteration():
+    """
+    Iterate over the batches of a reader fetching concurrently with ``async for``.
+    """
+    # Given
+    table = "AsyncIteration"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a INTEGER);"')
+    rows = "a\n1\n2\n3\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    reader = read_arrow_batches_from_odbc(
+        query=f"SELECT a FROM {table} ORDER BY a",
+        batch_size=2,
+        connection_string=MSSQL,
+        fetch_concurrently=True,
+    )
+
+    # When
+    async def collect():
+        return [batch async for batch in reader]
+
+    batches = asyncio.run(collect())
+
+    # Then
+    assert [[1, 2], [3]] == [batch.column(0).to_pylist() for batch in batches]
+
+
+def test_async_iteration_requires_fetch_concurrently():
+    reader = read_arrow_batches_from_odbc(
+        query="SELECT 42 AS a", batch_size=1, connection_string=MSSQL
+    )
+
+    async def collect():
+        return [batch async for batch in reader]
+
+    with raises(Error, match="fetching concurrently"):
+        asyncio.run(collect())
+
+
+def test_odbc_to_parquet(tmp_path):
+    """
+    Write the result of a query into a Parquet file, without the batches passing through Python.
+    """
+    # Given
+    table = "OdbcToParquet"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT, b VARCHAR(10))"')
+    rows = "a,b\n1,one\n2,two\n3,three\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    path = tmp_path / "out.parquet"
+
+    # When
+    num_rows = odbc_to_parquet(
+        query=f"SELECT a, b FROM {table} ORDER BY a",
+        path=path,
+        batch_size=1,
+        connection_string=MSSQL,
+        row_group_size=2,
+        compression="zstd",
+    )
+
+    # Then
+    assert 3 == num_rows
+    parquet_file = pq.ParquetFile(path)
+    assert 2 == parquet_file.num_row_groups
+    actual = parquet_file.read()
+    assert [1, 2, 3] == actual.column("a").to_pylist()
+    assert ["one", "two", "three"] == actual.column("b").to_pylist()
+
+
+def test_odbc_to_parquet_unknown_compression(tmp_path):
+    """
+    Unknown compression codecs are reported as errors.
+    """
+    # Given
+    query = "SELECT 42 AS a"
+    path = tmp_path / "out.parquet"
+
+    # Then
+    with raises(Error, match="Unknown parquet compression: lzma"):
+        # When
+        odbc_to_parquet(
+            query=query,
+            path=path,
+            batch_size=1,
+            connection_string=MSSQL,
+            compression="lzma",
+        )
+
+
+def test_odbc_to_arrow_ipc(tmp_path):
+    """
+    Write the result of a query into an Arrow IPC file.
+    """
+    # Given
+    query = "SELECT 42 AS a, CAST('hello' AS VARCHAR(10)) AS b"
+    path = tmp_path / "out.arrow"
+
+    # When
+    num_rows = odbc_to_arrow_ipc(query=query, path=path, batch_size=10, connection_string=MSSQL)
+
+    # Then
+    assert 1 == num_rows
+    actual = feather.read_table(path)
+    assert [42] == actual.column("a").to_pylist()
+    assert ["hello"] == actual.column("b").to_pylist()
+
+
+def test_insert_should_raise_on_invalid_connection_string():
+    """
+    Insert should raise on invalid connection string
+    """
+    # Given
+    invalid_connection_string = "FOO"
+    schema = pa.schema([("a", pa.int64())])
+
+    def iter_record_batches():
+        for i in range(2):
+            yield pa.RecordBatch.from_arrays([pa.array([1, 2, 3])], schema=schema)
+
+    reader = pa.RecordBatchReader.from_batches(schema, iter_record_batches())
+
+    # When / Then
+    with raises(Error, match="Data source name not found"):
+        insert_into_table(
+            connection_string=invalid_connection_string,
+            chunk_size=20,
+            table="MyTable",
+            reader=reader,
+        )
+
+
+def test_insert_batches():
+    """
+    Insert data into database
+    """
+    # Given
+    table = "InsertBatches"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(
+        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int IDENTITY(1,1), a BIGINT)"'
+    )
+    schema = pa.schema([("a", pa.int64())])
+
+    def iter_record_batches():
+        for i in range(2):
+            yield pa.RecordBatch.from_arrays([pa.array([1, 2, 3])], schema=schema)
+
+    reader = pa.RecordBatchReader.from_batches(schema, iter_record_batches())
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL, chunk_size=20, table=table, reader=reader
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY id"]
+    )
+    assert "a\n1\n2\n3\n1\n2\n3\n" == actual.decode("utf8")
+
+
+def test_execute_with_arrow_parameters():
+    """
+    Delete rows identified by an arrow array, in one round trip.
+    """
+    # Given
+    table = "ExecuteWithArrowParameters"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    rows = "a\n1\n2\n3\n4\n"
+    run(["odbcsv", "insert", "-c", MSSQL, table], input=rows, encoding="ascii")
+    schema = pa.schema([("id", pa.int64())])
+    batch = pa.RecordBatch.from_arrays([pa.array([1, 3])], schema=schema)
+    reader = pa.RecordBatchReader.from_batches(schema, [batch])
+
+    # When
+    execute_with_arrow_parameters(
+        statement=f"DELETE FROM {table} WHERE a = ?",
+        reader=reader,
+        chunk_size=100,
+        connection_string=MSSQL,
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n2\n4\n" == actual.decode("utf8")
+
+
+def test_copy_table():
+    """
+    Copy the result of a query into another table, without the batches passing through Python.
+    """
+    # Given
+    source = "CopyTableSource"
+    target = "CopyTableTarget"
+    for table in [source, target]:
+        os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+        os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT, b VARCHAR(10))"')
+    rows = "a,b\n1,one\n2,two\n3,three\n"
+    run(["odbcsv", "insert", "-c", MSSQL, source], input=rows, encoding="ascii")
+
+    # When
+    num_rows = copy_table(
+        query=f"SELECT a, b FROM {source} WHERE a > ?",
+        source_connection_string=MSSQL,
+        table=target,
+        target_connection_string=MSSQL,
+        batch_size=1,
+        parameters=[1],
+    )
+
+    # Then
+    assert 2 == num_rows
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a, b FROM {target} ORDER BY a"]
+    )
+    assert "a,b\n2,two\n3,three\n" == actual.decode("utf8")
+
+
+def test_insert_pipelined():
+    """
+    Insert batches on a dedicated system thread.
+    """
+    # Given
+    table = "InsertPipelined"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(
+        f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (id int IDENTITY(1,1), a BIGINT)"'
+    )
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([i, i + 1])], schema=schema) for i in [1, 3, 5]]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL, chunk_size=3, table=table, reader=reader, pipelined=True
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY id"]
+    )
+    assert "a\n1\n2\n3\n4\n5\n6\n" == actual.decode("utf8")
+
+
+def test_insert_pipelined_reports_errors():
+    """
+    Errors of the insert thread are raised by a later call.
+    """
+    # Given
+    table = "InsertPipelinedReportsErrors"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a TINYINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    # 1000 does not fit into a TINYINT
+    batch = pa.RecordBatch.from_arrays([pa.array([1000])], schema=schema)
+    reader = pa.RecordBatchReader.from_batches(schema, [batch])
+
+    # Then
+    with raises(Error):
+        insert_into_table(
+            connection_string=MSSQL, chunk_size=1, table=table, reader=reader, pipelined=True
+        )
+
+
+def test_insert_parallel():
+    """
+    Insert batches over several connections concurrently.
+    """
+    # Given
+    table = "InsertParallel"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([i, i + 1])], schema=schema) for i in [1, 3, 5]]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL, chunk_size=2, table=table, reader=reader, parallelism=2
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n1\n2\n3\n4\n5\n6\n" == actual.decode("utf8")
+
+
+def test_insert_single_transaction_rolls_back_on_error():
+    """
+    Inserting all rows in a single transaction must not leave any rows behind, if one chunk fails.
+    """
+    # Given
+    table = "InsertSingleTransaction"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a TINYINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    # 1000 does not fit into a TINYINT
+    batches = [
+        pa.RecordBatch.from_arrays([pa.array(values)], schema=schema) for values in [[1, 2], [1000]]
+    ]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    with raises(Error):
+        insert_into_table(
+            connection_string=MSSQL, chunk_size=2, table=table, reader=reader, commit_every=0
+        )
+
+    # Then
+    actual = check_output(["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table}"])
+    assert "a\n" == actual.decode("utf8")
+
+
+def test_insert_commit_every():
+    """
+    Commit every second chunk.
+    """
+    # Given
+    table = "InsertCommitEvery"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([i])], schema=schema) for i in range(1, 6)]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL, chunk_size=1, table=table, reader=reader, commit_every=2
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n1\n2\n3\n4\n5\n" == actual.decode("utf8")
+
+
+def test_insert_bulk():
+    """
+    Insert with the hints of the database management system for large inserts.
+    """
+    # Given
+    table = "InsertBulk"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([1, 2, 3])], schema=schema)]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL,
+        chunk_size=2,
+        table=table,
+        reader=reader,
+        method="bulk",
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n1\n2\n3\n" == actual.decode("utf8")
+
+
+def test_insert_bulk_can_not_be_combined_with_commit_every():
+    """
+    Direct path inserts on Oracle must be committed after each chunk, so bulk inserts rely on
+    autocommit.
+    """
+    schema = pa.schema([("a", pa.int64())])
+    reader = pa.RecordBatchReader.from_batches(schema, [])
+
+    with raises(ValueError, match='method="bulk" can not be combined with commit_every.'):
+        insert_into_table(
+            connection_string=MSSQL,
+            chunk_size=2,
+            table="Any",
+            reader=reader,
+            commit_every=0,
+            method="bulk",
+        )
+
+
+def test_insert_unknown_method():
+    """
+    Unknown insert methods are rejected before connecting to the database.
+    """
+    schema = pa.schema([("a", pa.int64())])
+    reader = pa.RecordBatchReader.from_batches(schema, [])
+
+    with raises(ValueError, match="method"):
+        insert_into_table(
+            connection_string=MSSQL, chunk_size=2, table="Any", reader=reader, method="bcp"
+        )
+
+
+def test_insert_stats_callback():
+    """
+    Counters of the writer are reported after each batch and once all rows are inserted.
+    """
+    # Given
+    table = "InsertStatsCallback"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([i])], schema=schema) for i in range(1, 4)]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+    reported = []
+
+    # When
+    insert_into_table(
+        connection_string=MSSQL,
+        chunk_size=2,
+        table=table,
+        reader=reader,
+        stats_callback=reported.append,
+    )
+
+    # Then
+    assert [1, 2, 3, 3] == [stats["rows"] for stats in reported]
+    # One full chunk and the remaining row sent by the flush.
+    assert 2 == reported[-1]["chunks"]
+    assert reported[-1]["execute_ns"] > 0
+
+
+def test_insert_async():
+    """
+    Insert batches from within an event loop.
+    """
+    # Given
+    table = "InsertAsync"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    schema = pa.schema([("a", pa.int64())])
+    batches = [pa.RecordBatch.from_arrays([pa.array([i])], schema=schema) for i in range(1, 6)]
+    reader = pa.RecordBatchReader.from_batches(schema, batches)
+
+    # When
+    asyncio.run(
+        insert_into_table_async(connection_string=MSSQL, chunk_size=2, table=table, reader=reader)
+    )
+
+    # Then
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n1\n2\n3\n4\n5\n" == actual.decode("utf8")
+
+
+def test_parquet_to_odbc(tmp_path):
+    """
+    Insert the rows of a Parquet file with several row groups, decoded on multiple threads.
+    """
+    # Given
+    table = "ParquetToOdbc"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT, b VARCHAR(10))"')
+    path = tmp_path / "in.parquet"
+    arrow_table = pa.table({"a": [1, 2, 3, 4, 5], "b": ["one", "two", "three", "four", "five"]})
+    pq.write_table(arrow_table, path, row_group_size=2)
+
+    # When
+    num_rows = parquet_to_odbc(
+        path=path, chunk_size=2, table=table, connection_string=MSSQL, decode_threads=2
+    )
+
+    # Then
+    assert 5 == num_rows
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a, b FROM {table} ORDER BY a"]
+    )
+    assert "a,b\n1,one\n2,two\n3,three\n4,four\n5,five\n" == actual.decode("utf8")
+
+
+def test_arrow_ipc_to_odbc(tmp_path):
+    """
+    Insert the rows of an Arrow IPC file.
+    """
+    # Given
+    table = "ArrowIpcToOdbc"
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "DROP TABLE IF EXISTS {table};"')
+    os.system(f'odbcsv fetch -c "{MSSQL}" -q "CREATE TABLE {table} (a BIGINT)"')
+    path = tmp_path / "in.arrow"
+    schema = pa.schema([("a", pa.int64())])
+    with ipc.new_file(str(path), schema) as file:
+        for i in range(1, 4):
+            file.write_batch(pa.RecordBatch.from_arrays([pa.array([i])], schema=schema))
+
+    # When
+    num_rows = arrow_ipc_to_odbc(path=path, chunk_size=2, table=table, connection_string=MSSQL)
+
+    # Then
+    assert 3 == num_rows
+    actual = check_output(
+        ["odbcsv", "fetch", "-c", MSSQL, "-q", f"SELECT a FROM {table} ORDER BY a"]
+    )
+    assert "a\n1\n2\n3\n" == actual.decode("utf8")